@@ -10,12 +10,12 @@
 ABrawler::ABrawler()
 {
 
-    Hp = 40;
-    Movement = 6;
+    Hp = DefaultHp;
+    Movement = DefaultMovement;
     //TypeofAttack = FString::"Melee";
-    RangeAttack = 1;
-    MinDamage = 1;
-    MaxDamage = 6;
+    RangeAttack = DefaultRangeAttack;
+    MinDamage = DefaultMinDamage;
+    MaxDamage = DefaultMaxDamage;
 
     UnitTypeDisplayName = TEXT("Brawler");
 }
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EndgameTablebaseCommandlet.h"
+#include "SaT_EndgameTablebase.h"
+#include "HAL/PlatformTime.h"
+
+UEndgameTablebaseCommandlet::UEndgameTablebaseCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UEndgameTablebaseCommandlet::Main(const FString& Params)
+{
+	int32 BoardSize = 25;
+	FParse::Value(*Params, TEXT("size="), BoardSize);
+	BoardSize = FMath::Max(2, BoardSize);
+
+	FString OutPath = FSaTEndgameTablebase::GetDefaultPath();
+	FParse::Value(*Params, TEXT("out="), OutPath);
+
+	const FSaTEndgameRules Rules = FSaTEndgameRules::FromUnitDefaults(BoardSize);
+	UE_LOG(LogTemp, Display, TEXT("Endgame tablebase: board %d, %d positions"), BoardSize, Rules.GetNumEntries());
+
+	const double StartSeconds = FPlatformTime::Seconds();
+	TArray<FSaTEndgameTablebase::FEntry> Entries;
+	FSaTEndgameTablebase::Generate(Rules, Entries);
+	UE_LOG(LogTemp, Display, TEXT("Generated in %.1f ms"), (FPlatformTime::Seconds() - StartSeconds) * 1000.0);
+
+	if (!FSaTEndgameTablebase::SaveToFile(OutPath, Rules, Entries))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not write the endgame tablebase to %s"), *OutPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Endgame tablebase written to %s"), *OutPath);
+	return 0;
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EvalTunerCommandlet.h"
+#include "SaT_SelfPlay.h"
+#include "SaT_DifficultySettings.h"
+#include "GridBitboard.h"
+#include "HAL/PlatformTime.h"
+
+UEvalTunerCommandlet::UEvalTunerCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UEvalTunerCommandlet::Main(const FString& Params)
+{
+	FSaTSelfPlaySettings Settings;
+	FParse::Value(*Params, TEXT("seed="), Settings.Seed);
+	FParse::Value(*Params, TEXT("iterations="), Settings.Iterations);
+	FParse::Value(*Params, TEXT("pairs="), Settings.MatchPairs);
+	FParse::Value(*Params, TEXT("size="), Settings.BoardSize);
+	FParse::Value(*Params, TEXT("budget="), Settings.PlannerBudgetMs);
+	Settings.Iterations = FMath::Max(1, Settings.Iterations);
+	Settings.MatchPairs = FMath::Max(1, Settings.MatchPairs);
+	Settings.BoardSize = FMath::Clamp(Settings.BoardSize, 4, FGridBitboard::Stride);
+	Settings.bRequireLineOfSight = !FParse::Param(*Params, TEXT("nolos"));
+
+	USaT_DifficultySettings* DifficultySettings = GetMutableDefault<USaT_DifficultySettings>();
+	const FSaTEvalWeights Initial = DifficultySettings->GetEvalWeights();
+	UE_LOG(LogTemp, Display, TEXT("Eval tuner: seed %d, %d iterations of %d match pairs on %dx%d boards"),
+		Settings.Seed, Settings.Iterations, Settings.MatchPairs, Settings.BoardSize, Settings.BoardSize);
+
+	const double StartSeconds = FPlatformTime::Seconds();
+	const FSaTTuningResult Result = FSaTSelfPlay::Tune(Settings, Initial);
+	UE_LOG(LogTemp, Display, TEXT("Tuned in %.1f s over %d matches: Hp %.3f, Kill %.3f, Exposure %.3f, Approach %.3f, LineControl %.3f"),
+		FPlatformTime::Seconds() - StartSeconds, Result.MatchesPlayed, Result.Weights.Hp, Result.Weights.Kill,
+		Result.Weights.Exposure, Result.Weights.Approach, Result.Weights.LineControl);
+	UE_LOG(LogTemp, Display, TEXT("Score against the configured weights: %+.3f +- %.3f"), Result.ScoreVsInitial, Result.ScoreStdError);
+
+	// Weights that do not beat the configured ones by more than the noise of the matches are not worth the config change
+	if (FParse::Param(*Params, TEXT("dryrun")) || Result.ScoreVsInitial <= 2.0f * Result.ScoreStdError)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Config left unchanged"));
+		return 0;
+	}
+
+	DifficultySettings->SetEvalWeights(Result.Weights);
+	if (!DifficultySettings->TryUpdateDefaultConfigFile())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not write the tuned weights to the default config"));
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Tuned weights written to %s"), *DifficultySettings->GetDefaultConfigFilename());
+	return 0;
+}
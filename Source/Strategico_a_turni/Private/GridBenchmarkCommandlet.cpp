@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridBenchmarkCommandlet.h"
+#include "GridPathfindingBenchmark.h"
+#include "Misc/FileHelper.h"
+
+UGridBenchmarkCommandlet::UGridBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UGridBenchmarkCommandlet::Main(const FString& Params)
+{
+	FGridBenchmarkSettings Settings;
+	FParse::Value(*Params, TEXT("seed="), Settings.Seed);
+	FParse::Value(*Params, TEXT("queries="), Settings.QueriesPerCase);
+	Settings.QueriesPerCase = FMath::Max(1, Settings.QueriesPerCase);
+	FParse::Value(*Params, TEXT("terrain="), Settings.TerrainShare);
+	Settings.TerrainShare = FMath::Clamp(Settings.TerrainShare, 0.0f, 1.0f);
+
+	// Comma separated lists replace the default sizes and densities
+	FString ListValue;
+	TArray<FString> Items;
+	if (FParse::Value(*Params, TEXT("sizes="), ListValue, false))
+	{
+		ListValue.ParseIntoArray(Items, TEXT(","));
+		Settings.Sizes.Reset();
+		for (const FString& Item : Items)
+		{
+			Settings.Sizes.Add(FCString::Atoi(*Item));
+		}
+	}
+	if (FParse::Value(*Params, TEXT("densities="), ListValue, false))
+	{
+		ListValue.ParseIntoArray(Items, TEXT(","));
+		Settings.Densities.Reset();
+		for (const FString& Item : Items)
+		{
+			Settings.Densities.Add(FMath::Clamp(FCString::Atof(*Item), 0.0f, 1.0f));
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Grid benchmark: seed %d, %d queries per case, terrain on %.0f%% of the free cells"),
+		Settings.Seed, Settings.QueriesPerCase, Settings.TerrainShare * 100.0f);
+
+	TArray<FGridBenchmarkResult> Results;
+	FGridPathfindingBenchmark::Run(Settings, Results);
+	FGridPathfindingBenchmark::LogResults(Results);
+
+	FString CSVPath;
+	if (FParse::Value(*Params, TEXT("csv="), CSVPath))
+	{
+		if (!FFileHelper::SaveStringToFile(FGridPathfindingBenchmark::ToCSV(Results), *CSVPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Could not write benchmark results to %s"), *CSVPath);
+			return 1;
+		}
+		UE_LOG(LogTemp, Display, TEXT("Benchmark results written to %s"), *CSVPath);
+	}
+
+	// A regression gate for automated runs: any query kind slower than the threshold at the 99th percentile fails
+	double MaxP99Micros = 0.0;
+	if (FParse::Value(*Params, TEXT("maxp99="), MaxP99Micros) && MaxP99Micros > 0.0)
+	{
+		int32 NumOverThreshold = 0;
+		for (const FGridBenchmarkResult& Result : Results)
+		{
+			if (Result.P99Micros > MaxP99Micros)
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s on %dx%d at density %.2f: p99 %.1f us over the %.1f us threshold"),
+					*Result.Query, Result.Size, Result.Size, Result.Density, Result.P99Micros, MaxP99Micros);
+				NumOverThreshold++;
+			}
+		}
+		if (NumOverThreshold > 0)
+		{
+			return 2;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,285 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridBitboard.h"
+
+//----------------------------------------------
+// Word-parallel Operations
+//----------------------------------------------
+
+bool FGridBitboard::IsEmpty() const
+{
+	uint64 Combined = 0;
+	for (int32 WordIndex = 0; WordIndex < NumWords; WordIndex++)
+	{
+		Combined |= Words[WordIndex];
+	}
+	return Combined == 0;
+}
+
+int32 FGridBitboard::PopCount() const
+{
+	int32 Count = 0;
+	for (int32 WordIndex = 0; WordIndex < NumWords; WordIndex++)
+	{
+		Count += FPlatformMath::CountBits(Words[WordIndex]);
+	}
+	return Count;
+}
+
+FGridBitboard& FGridBitboard::operator&=(const FGridBitboard& Other)
+{
+	for (int32 WordIndex = 0; WordIndex < NumWords; WordIndex++)
+	{
+		Words[WordIndex] &= Other.Words[WordIndex];
+	}
+	return *this;
+}
+
+FGridBitboard& FGridBitboard::operator|=(const FGridBitboard& Other)
+{
+	for (int32 WordIndex = 0; WordIndex < NumWords; WordIndex++)
+	{
+		Words[WordIndex] |= Other.Words[WordIndex];
+	}
+	return *this;
+}
+
+FGridBitboard& FGridBitboard::AndNot(const FGridBitboard& Other)
+{
+	for (int32 WordIndex = 0; WordIndex < NumWords; WordIndex++)
+	{
+		Words[WordIndex] &= ~Other.Words[WordIndex];
+	}
+	return *this;
+}
+
+FGridBitboard operator~(const FGridBitboard& Board)
+{
+	FGridBitboard Result = FGridBitboard::GetAllCellsMask();
+	Result.AndNot(Board);
+	return Result;
+}
+
+bool FGridBitboard::operator==(const FGridBitboard& Other) const
+{
+	return FMemory::Memcmp(Words, Other.Words, sizeof(Words)) == 0;
+}
+
+FGridBitboard FGridBitboard::Shifted(int32 DeltaX, int32 DeltaY) const
+{
+	FGridBitboard Result;
+
+	// Anything moved a whole board away is gone
+	if (FMath::Abs(DeltaX) >= Stride || FMath::Abs(DeltaY) >= Stride)
+	{
+		return Result;
+	}
+
+	// A translation on a row-major board is a plain shift of the bit string
+	const int32 Shift = DeltaY * Stride + DeltaX;
+	if (Shift >= 0)
+	{
+		const int32 WordShift = Shift >> 6;
+		const int32 BitShift = Shift & 63;
+		for (int32 WordIndex = NumWords - 1; WordIndex >= WordShift; WordIndex--)
+		{
+			const int32 Source = WordIndex - WordShift;
+			uint64 Value = Words[Source] << BitShift;
+			if (BitShift != 0 && Source > 0)
+			{
+				Value |= Words[Source - 1] >> (64 - BitShift);
+			}
+			Result.Words[WordIndex] = Value;
+		}
+	}
+	else
+	{
+		const int32 WordShift = (-Shift) >> 6;
+		const int32 BitShift = (-Shift) & 63;
+		for (int32 WordIndex = 0; WordIndex < NumWords - WordShift; WordIndex++)
+		{
+			const int32 Source = WordIndex + WordShift;
+			uint64 Value = Words[Source] >> BitShift;
+			if (BitShift != 0 && Source + 1 < NumWords)
+			{
+				Value |= Words[Source + 1] << (64 - BitShift);
+			}
+			Result.Words[WordIndex] = Value;
+		}
+	}
+
+	// Drop cells that wrapped around a row edge
+	if (DeltaX > 0)
+	{
+		const FGridBitboard& Wrapped = GetColumnsBelowMask(DeltaX);
+		for (int32 WordIndex = 0; WordIndex < NumWords; WordIndex++)
+		{
+			Result.Words[WordIndex] &= ~Wrapped.Words[WordIndex];
+		}
+	}
+	else if (DeltaX < 0)
+	{
+		Result &= GetColumnsBelowMask(Stride + DeltaX);
+	}
+
+	// Drop cells pushed past the last row
+	Result &= GetAllCellsMask();
+
+	return Result;
+}
+
+FGridBitboard FGridBitboard::Dilated() const
+{
+	FGridBitboard Result = *this;
+	Result |= Shifted(1, 0);
+	Result |= Shifted(-1, 0);
+	Result |= Shifted(0, 1);
+	Result |= Shifted(0, -1);
+	return Result;
+}
+
+//----------------------------------------------
+// Reachability
+//----------------------------------------------
+
+FGridBitboard FGridBitboard::FloodFill(const FGridBitboard& Seed, const FGridBitboard& Passable)
+{
+	FGridBitboard Reached = Seed;
+	while (true)
+	{
+		// Grow one layer and stop once the region no longer changes
+		const FGridBitboard Next = (Reached.Dilated() & Passable) | Reached;
+		if (Next == Reached)
+		{
+			return Reached;
+		}
+		Reached = Next;
+	}
+}
+
+FGridBitboard FGridBitboard::ReachableWithin(const FGridBitboard& Seed, int32 Steps, const FGridBitboard& Passable)
+{
+	FGridBitboard Reached = Seed;
+	for (int32 Step = 0; Step < Steps; Step++)
+	{
+		const FGridBitboard Next = (Reached.Dilated() & Passable) | Reached;
+		if (Next == Reached)
+		{
+			break;
+		}
+		Reached = Next;
+	}
+	return Reached;
+}
+
+FGridBitboard FGridBitboard::ExpandedBy(int32 Range) const
+{
+	FGridBitboard Result = *this;
+	for (int32 Step = 0; Step < Range && Step < 2 * Stride; Step++)
+	{
+		Result = Result.Dilated();
+	}
+	return Result;
+}
+
+//----------------------------------------------
+// Attack Range Masks
+//----------------------------------------------
+
+FGridBitboard FGridBitboard::MakeRangeMask(int32 OriginX, int32 OriginY, int32 Range)
+{
+	if (Range < 0)
+	{
+		return FGridBitboard();
+	}
+
+	// Common case: shift the precomputed diamond onto the origin
+	if (Range <= MaxTemplateRange)
+	{
+		return GetRangeTemplate(Range).Shifted(OriginX - MaxTemplateRange, OriginY - MaxTemplateRange);
+	}
+
+	// Ranges wider than half the board don't fit a template, build them row by row
+	FGridBitboard Mask;
+	for (int32 Y = FMath::Max(0, OriginY - Range); Y <= FMath::Min(Stride - 1, OriginY + Range); Y++)
+	{
+		const int32 HalfWidth = Range - FMath::Abs(Y - OriginY);
+		for (int32 X = FMath::Max(0, OriginX - HalfWidth); X <= FMath::Min(Stride - 1, OriginX + HalfWidth); X++)
+		{
+			Mask.SetIndex(ToIndex(X, Y));
+		}
+	}
+	return Mask;
+}
+
+bool FGridBitboard::IsOffsetInRange(int32 DeltaX, int32 DeltaY, int32 Range)
+{
+	if (Range < 0)
+	{
+		return false;
+	}
+
+	// Look the offset up in the template so every range test shares the same shape
+	if (Range <= MaxTemplateRange)
+	{
+		return GetRangeTemplate(Range).Test(MaxTemplateRange + DeltaX, MaxTemplateRange + DeltaY);
+	}
+
+	return FMath::Abs(DeltaX) + FMath::Abs(DeltaY) <= Range;
+}
+
+const FGridBitboard& FGridBitboard::GetRangeTemplate(int32 Range)
+{
+	// One diamond per range, all centred on the middle cell of the board
+	static const TArray<FGridBitboard> Templates = []()
+	{
+		TArray<FGridBitboard> Result;
+		Result.SetNum(MaxTemplateRange + 1);
+
+		for (int32 TemplateRange = 0; TemplateRange <= MaxTemplateRange; TemplateRange++)
+		{
+			for (int32 Y = 0; Y < Stride; Y++)
+			{
+				for (int32 X = 0; X < Stride; X++)
+				{
+					if (FMath::Abs(X - MaxTemplateRange) + FMath::Abs(Y - MaxTemplateRange) <= TemplateRange)
+					{
+						Result[TemplateRange].SetIndex(ToIndex(X, Y));
+					}
+				}
+			}
+		}
+		return Result;
+	}();
+
+	return Templates[Range];
+}
+
+const FGridBitboard& FGridBitboard::GetColumnsBelowMask(int32 Column)
+{
+	static const TArray<FGridBitboard> Masks = []()
+	{
+		TArray<FGridBitboard> Result;
+		Result.SetNum(Stride + 1);
+
+		for (int32 Limit = 0; Limit <= Stride; Limit++)
+		{
+			for (int32 Y = 0; Y < Stride; Y++)
+			{
+				for (int32 X = 0; X < Limit; X++)
+				{
+					Result[Limit].SetIndex(ToIndex(X, Y));
+				}
+			}
+		}
+		return Result;
+	}();
+
+	return Masks[FMath::Clamp(Column, 0, Stride)];
+}
+
+const FGridBitboard& FGridBitboard::GetAllCellsMask()
+{
+	return GetColumnsBelowMask(Stride);
+}
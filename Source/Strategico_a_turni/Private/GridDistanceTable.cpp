@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridDistanceTable.h"
+#include "GridPathfinding.h"
+#include "Async/ParallelFor.h"
+
+//----------------------------------------------
+// Maintenance
+//----------------------------------------------
+
+void FGridDistanceTable::Reset()
+{
+	Size = 0;
+	NumCells = 0;
+	MaxStepCost = 0;
+	Table.Empty();
+}
+
+bool FGridDistanceTable::Build(const FGridSearchGrid& StaticGrid)
+{
+	Reset();
+
+	const int32 GridCells = StaticGrid.Size * StaticGrid.Size;
+	if (GridCells <= 0 || GridCells > MaxCells)
+	{
+		return false;
+	}
+
+	Table.SetNumUninitialized(GridCells * GridCells);
+
+	// One distance field per worker, so the sweeps do not allocate once warm
+	TArray<FGridDistanceField> Fields;
+	ParallelForWithTaskContext(Fields, GridCells, [&StaticGrid, GridCells, this](FGridDistanceField& Field, int32 Source)
+		{
+			uint8* Row = Table.GetData() + Source * GridCells;
+			if (!StaticGrid.IsPassable(Source))
+			{
+				// Obstacles are never the start of a move; only the diagonal is meaningful
+				FMemory::Memset(Row, UnreachableEntry, GridCells);
+				Row[Source] = 0;
+				return;
+			}
+
+			FGridPathfinding::ComputeDistanceField(StaticGrid, Source % StaticGrid.Size, Source / StaticGrid.Size, Field);
+			for (int32 Target = 0; Target < GridCells; Target++)
+			{
+				const int32 Distance = Field.Distance[Target];
+				Row[Target] = Distance == FGridDistanceField::Unreachable ? UnreachableEntry : uint8(FMath::Min<int32>(Distance, MaxEntry));
+			}
+		});
+
+	Size = StaticGrid.Size;
+	NumCells = GridCells;
+	MaxStepCost = StaticGrid.GetMaxStepCost();
+	return true;
+}
+
+//----------------------------------------------
+// Queries
+//----------------------------------------------
+
+int32 FGridDistanceTable::GetDistance(int32 FromX, int32 FromY, int32 ToX, int32 ToY) const
+{
+	if (!IsBuilt() || FromX < 0 || FromX >= Size || FromY < 0 || FromY >= Size || ToX < 0 || ToX >= Size || ToY < 0 || ToY >= Size)
+	{
+		return MAX_int32;
+	}
+
+	const uint8 Entry = GetEntry(FromY * Size + FromX, ToY * Size + ToX);
+	return Entry == UnreachableEntry ? MAX_int32 : Entry;
+}
@@ -0,0 +1,754 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridHierarchicalPathfinder.h"
+
+//----------------------------------------------
+// Setup and Invalidation
+//----------------------------------------------
+
+void FGridHierarchicalPathfinder::Build(const FGridSearchGrid* InGrid, int32 InClusterSize)
+{
+	Reset();
+
+	if (!InGrid || InGrid->Size <= 0)
+	{
+		return;
+	}
+
+	Grid = InGrid;
+	ClusterSize = FMath::Max(2, InClusterSize);
+	ClustersPerSide = FMath::DivideAndRoundUp(Grid->Size, ClusterSize);
+
+	const int32 NumClusters = ClustersPerSide * ClustersPerSide;
+	BorderNodes.SetNum(NumClusters * 2);
+	bClusterDirty.Init(false, NumClusters);
+
+	// A full build is a rebuild of every cluster
+	for (int32 Cluster = 0; Cluster < NumClusters; Cluster++)
+	{
+		bClusterDirty[Cluster] = true;
+		DirtyClusters.Add(Cluster);
+	}
+	RebuildDirtyClusters(nullptr);
+}
+
+void FGridHierarchicalPathfinder::Reset()
+{
+	Grid = nullptr;
+	ClusterSize = 0;
+	ClustersPerSide = 0;
+	Nodes.Empty();
+	FreeNodes.Empty();
+	BorderNodes.Empty();
+	DirtyClusters.Empty();
+	bClusterDirty.Empty();
+}
+
+void FGridHierarchicalPathfinder::NotifyCellChanged(int32 X, int32 Y)
+{
+	if (!Grid || !Grid->IsValidCell(X, Y))
+	{
+		return;
+	}
+
+	// The cluster's own borders are rebuilt with it, so neighbours never need marking
+	const int32 Cluster = GetClusterOfCell(Grid->ToIndex(X, Y));
+	if (!bClusterDirty[Cluster])
+	{
+		bClusterDirty[Cluster] = true;
+		DirtyClusters.Add(Cluster);
+	}
+}
+
+SIZE_T FGridHierarchicalPathfinder::GetAllocatedSize() const
+{
+	SIZE_T Total = Nodes.GetAllocatedSize() + FreeNodes.GetAllocatedSize() + BorderNodes.GetAllocatedSize() +
+		DirtyClusters.GetAllocatedSize() + bClusterDirty.GetAllocatedSize() +
+		LocalCost.GetAllocatedSize() + LocalParent.GetAllocatedSize() + LocalOpen.GetAllocatedSize() +
+		AbstractCost.GetAllocatedSize() + AbstractParent.GetAllocatedSize() + GoalLinkCost.GetAllocatedSize() +
+		StartLinks.GetAllocatedSize() + AbstractOpen.GetAllocatedSize();
+
+	for (const FNode& Node : Nodes)
+	{
+		Total += Node.Edges.GetAllocatedSize();
+	}
+	for (const TArray<int32>& Border : BorderNodes)
+	{
+		Total += Border.GetAllocatedSize();
+	}
+	return Total;
+}
+
+//----------------------------------------------
+// Cluster Geometry
+//----------------------------------------------
+
+int32 FGridHierarchicalPathfinder::GetClusterOfCell(int32 Cell) const
+{
+	const int32 X = Cell % Grid->Size;
+	const int32 Y = Cell / Grid->Size;
+	return (Y / ClusterSize) * ClustersPerSide + (X / ClusterSize);
+}
+
+void FGridHierarchicalPathfinder::GetClusterBounds(int32 Cluster, int32& OutMinX, int32& OutMinY, int32& OutMaxX, int32& OutMaxY) const
+{
+	OutMinX = (Cluster % ClustersPerSide) * ClusterSize;
+	OutMinY = (Cluster / ClustersPerSide) * ClusterSize;
+	OutMaxX = FMath::Min(OutMinX + ClusterSize, Grid->Size) - 1;
+	OutMaxY = FMath::Min(OutMinY + ClusterSize, Grid->Size) - 1;
+}
+
+bool FGridHierarchicalPathfinder::IsValidBorder(int32 Border) const
+{
+	const int32 Cluster = Border / 2;
+	const bool bEast = (Border % 2) == 0;
+	return bEast ? (Cluster % ClustersPerSide) + 1 < ClustersPerSide : (Cluster / ClustersPerSide) + 1 < ClustersPerSide;
+}
+
+//----------------------------------------------
+// Graph Maintenance
+//----------------------------------------------
+
+void FGridHierarchicalPathfinder::RebuildDirtyClusters(FGridSearchStats* Stats)
+{
+	if (DirtyClusters.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 NumClusters = ClustersPerSide * ClustersPerSide;
+
+	// Every border of a dirty cluster is rescanned; a cluster on the other side only has to be
+	// reconnected when the entrances on the shared border actually moved
+	TArray<int32> Borders;
+	TArray<bool> bConnectPending;
+	bConnectPending.Init(false, NumClusters);
+	TArray<int32> ClustersToConnect;
+
+	auto QueueCluster = [&](int32 Cluster)
+		{
+			if (!bConnectPending[Cluster])
+			{
+				bConnectPending[Cluster] = true;
+				ClustersToConnect.Add(Cluster);
+			}
+		};
+
+	auto QueueBorder = [&](int32 Border)
+		{
+			if (IsValidBorder(Border) && !Borders.Contains(Border))
+			{
+				Borders.Add(Border);
+			}
+		};
+
+	for (int32 Cluster : DirtyClusters)
+	{
+		QueueCluster(Cluster);
+		QueueBorder(Cluster * 2);
+		QueueBorder(Cluster * 2 + 1);
+		if (Cluster % ClustersPerSide > 0)
+		{
+			QueueBorder((Cluster - 1) * 2);
+		}
+		if (Cluster / ClustersPerSide > 0)
+		{
+			QueueBorder((Cluster - ClustersPerSide) * 2 + 1);
+		}
+		bClusterDirty[Cluster] = false;
+	}
+	DirtyClusters.Reset();
+
+	for (int32 Border : Borders)
+	{
+		if (BuildBorder(Border))
+		{
+			const int32 Owner = Border / 2;
+			QueueCluster(Owner);
+			QueueCluster((Border % 2) == 0 ? Owner + 1 : Owner + ClustersPerSide);
+		}
+	}
+
+	for (int32 Cluster : ClustersToConnect)
+	{
+		BuildIntraEdges(Cluster, Stats);
+	}
+}
+
+void FGridHierarchicalPathfinder::RemoveBorderNodes(int32 Border)
+{
+	for (int32 NodeId : BorderNodes[Border])
+	{
+		FNode& Node = Nodes[NodeId];
+		Node.bActive = false;
+		Node.Edges.Reset();
+		FreeNodes.Add(NodeId);
+	}
+	BorderNodes[Border].Reset();
+}
+
+bool FGridHierarchicalPathfinder::BuildBorder(int32 Border)
+{
+	const int32 Owner = Border / 2;
+	const bool bEast = (Border % 2) == 0;
+
+	int32 MinX, MinY, MaxX, MaxY;
+	GetClusterBounds(Owner, MinX, MinY, MaxX, MaxY);
+
+	// Walk the shared edge; A is the owner's side, B the neighbour's
+	const int32 Length = bEast ? (MaxY - MinY + 1) : (MaxX - MinX + 1);
+	auto CellsAt = [&](int32 Offset, int32& OutA, int32& OutB)
+		{
+			if (bEast)
+			{
+				OutA = Grid->ToIndex(MaxX, MinY + Offset);
+				OutB = Grid->ToIndex(MaxX + 1, MinY + Offset);
+			}
+			else
+			{
+				OutA = Grid->ToIndex(MinX + Offset, MaxY);
+				OutB = Grid->ToIndex(MinX + Offset, MaxY + 1);
+			}
+		};
+
+	// Transition cells in walking order, owner side then neighbour side
+	TArray<int32, TInlineAllocator<32>> Transitions;
+	auto AddCandidate = [&](int32 Offset)
+		{
+			int32 CellA, CellB;
+			CellsAt(Offset, CellA, CellB);
+			Transitions.Add(CellA);
+			Transitions.Add(CellB);
+		};
+
+	int32 SegmentStart = INDEX_NONE;
+	for (int32 Offset = 0; Offset <= Length; Offset++)
+	{
+		bool bOpen = false;
+		if (Offset < Length)
+		{
+			int32 CellA, CellB;
+			CellsAt(Offset, CellA, CellB);
+			bOpen = Grid->IsPassable(CellA) && Grid->IsPassable(CellB);
+		}
+
+		if (bOpen && SegmentStart == INDEX_NONE)
+		{
+			SegmentStart = Offset;
+		}
+		else if (!bOpen && SegmentStart != INDEX_NONE)
+		{
+			// Close the segment: one entrance in the middle, or one at each end if it is long
+			const int32 SegmentEnd = Offset - 1;
+			if (SegmentEnd - SegmentStart + 1 >= LongEntranceLength)
+			{
+				AddCandidate(SegmentStart);
+				AddCandidate(SegmentEnd);
+			}
+			else
+			{
+				AddCandidate((SegmentStart + SegmentEnd) / 2);
+			}
+			SegmentStart = INDEX_NONE;
+		}
+	}
+
+	// Same entrances as before: keep the nodes (and the neighbours' edges to them), refresh the crossing costs
+	TArray<int32>& Existing = BorderNodes[Border];
+	bool bUnchanged = Existing.Num() == Transitions.Num();
+	for (int32 i = 0; bUnchanged && i < Existing.Num(); i++)
+	{
+		bUnchanged = Nodes[Existing[i]].Cell == Transitions[i];
+	}
+
+	if (bUnchanged)
+	{
+		for (int32 i = 0; i < Existing.Num(); i += 2)
+		{
+			for (FEdge& Edge : Nodes[Existing[i]].Edges)
+			{
+				if (!Edge.bIntra)
+				{
+					Edge.Cost = Grid->StepCost[Transitions[i + 1]];
+				}
+			}
+			for (FEdge& Edge : Nodes[Existing[i + 1]].Edges)
+			{
+				if (!Edge.bIntra)
+				{
+					Edge.Cost = Grid->StepCost[Transitions[i]];
+				}
+			}
+		}
+		return false;
+	}
+
+	RemoveBorderNodes(Border);
+	for (int32 i = 0; i < Transitions.Num(); i += 2)
+	{
+		AddTransition(Border, Transitions[i], Transitions[i + 1]);
+	}
+	return true;
+}
+
+void FGridHierarchicalPathfinder::AddTransition(int32 Border, int32 CellA, int32 CellB)
+{
+	const int32 NodeA = AllocateNode(CellA, GetClusterOfCell(CellA));
+	const int32 NodeB = AllocateNode(CellB, GetClusterOfCell(CellB));
+
+	// Crossing costs the step onto the other side
+	Nodes[NodeA].Edges.Add(FEdge{ NodeB, Grid->StepCost[CellB], false });
+	Nodes[NodeB].Edges.Add(FEdge{ NodeA, Grid->StepCost[CellA], false });
+
+	BorderNodes[Border].Add(NodeA);
+	BorderNodes[Border].Add(NodeB);
+}
+
+int32 FGridHierarchicalPathfinder::AllocateNode(int32 Cell, int32 Cluster)
+{
+	const int32 NodeId = FreeNodes.Num() > 0 ? FreeNodes.Pop(EAllowShrinking::No) : Nodes.AddDefaulted();
+
+	FNode& Node = Nodes[NodeId];
+	Node.Cell = Cell;
+	Node.Cluster = Cluster;
+	Node.bActive = true;
+	Node.Edges.Reset();
+	return NodeId;
+}
+
+void FGridHierarchicalPathfinder::GatherClusterNodes(int32 Cluster, TArray<int32>& OutNodes) const
+{
+	OutNodes.Reset();
+
+	// Entrances of a cluster live on its own east/south borders and on the borders owned by its west/north neighbours
+	int32 Borders[4] = { Cluster * 2, Cluster * 2 + 1, INDEX_NONE, INDEX_NONE };
+	if (Cluster % ClustersPerSide > 0)
+	{
+		Borders[2] = (Cluster - 1) * 2;
+	}
+	if (Cluster / ClustersPerSide > 0)
+	{
+		Borders[3] = (Cluster - ClustersPerSide) * 2 + 1;
+	}
+
+	for (int32 Border : Borders)
+	{
+		if (Border == INDEX_NONE)
+		{
+			continue;
+		}
+
+		for (int32 NodeId : BorderNodes[Border])
+		{
+			if (Nodes[NodeId].Cluster == Cluster)
+			{
+				OutNodes.Add(NodeId);
+			}
+		}
+	}
+}
+
+void FGridHierarchicalPathfinder::BuildIntraEdges(int32 Cluster, FGridSearchStats* Stats)
+{
+	TArray<int32> ClusterNodes;
+	GatherClusterNodes(Cluster, ClusterNodes);
+
+	for (int32 NodeId : ClusterNodes)
+	{
+		Nodes[NodeId].Edges.RemoveAll([](const FEdge& Edge) { return Edge.bIntra; });
+	}
+
+	int32 MinX, MinY, MaxX, MaxY;
+	GetClusterBounds(Cluster, MinX, MinY, MaxX, MaxY);
+	const int32 Width = MaxX - MinX + 1;
+	LocalTargetCount.Init(0, Width * (MaxY - MinY + 1));
+
+	auto ToLocal = [this, MinX, MinY, Width](int32 Cell) { return (Cell / Grid->Size - MinY) * Width + (Cell % Grid->Size - MinX); };
+	for (int32 NodeId : ClusterNodes)
+	{
+		LocalTargetCount[ToLocal(Nodes[NodeId].Cell)]++;
+	}
+
+	// Each sweep only has to settle the entrances after it: since every step costs the entered cell,
+	// the way back is Cost(b -> a) = Cost(a -> b) - Step(b) + Step(a)
+	for (int32 i = 0; i < ClusterNodes.Num() - 1; i++)
+	{
+		const int32 NodeId = ClusterNodes[i];
+		const int32 Cell = Nodes[NodeId].Cell;
+		LocalTargetCount[ToLocal(Cell)]--;
+
+		RunLocalSearch(Cell, Cluster, INDEX_NONE, Stats, ClusterNodes.Num() - 1 - i);
+
+		for (int32 j = i + 1; j < ClusterNodes.Num(); j++)
+		{
+			const int32 OtherId = ClusterNodes[j];
+			const int32 OtherCell = Nodes[OtherId].Cell;
+			const int32 Cost = GetLocalCost(OtherCell);
+			if (Cost != FGridDistanceField::Unreachable)
+			{
+				Nodes[NodeId].Edges.Add(FEdge{ OtherId, Cost, true });
+				Nodes[OtherId].Edges.Add(FEdge{ NodeId, Cost - Grid->StepCost[OtherCell] + Grid->StepCost[Cell], true });
+			}
+		}
+	}
+}
+
+//----------------------------------------------
+// Local Search
+//----------------------------------------------
+
+void FGridHierarchicalPathfinder::RunLocalSearch(int32 StartCell, int32 Cluster, int32 GoalCell, FGridSearchStats* Stats, int32 NumTargets)
+{
+	int32 MaxX, MaxY;
+	GetClusterBounds(Cluster, LocalMinX, LocalMinY, MaxX, MaxY);
+	LocalWidth = MaxX - LocalMinX + 1;
+	LocalHeight = MaxY - LocalMinY + 1;
+
+	const int32 NumLocal = LocalWidth * LocalHeight;
+	if (Stats && LocalCost.Max() < NumLocal)
+	{
+		Stats->ScratchAllocations++;
+	}
+	LocalCost.Init(FGridDistanceField::Unreachable, NumLocal);
+	LocalParent.Init(INDEX_NONE, NumLocal);
+	LocalOpen.Reset();
+
+	auto ToLocal = [this](int32 X, int32 Y) { return (Y - LocalMinY) * LocalWidth + (X - LocalMinX); };
+
+	const int32 GoalX = GoalCell != INDEX_NONE ? GoalCell % Grid->Size : 0;
+	const int32 GoalY = GoalCell != INDEX_NONE ? GoalCell / Grid->Size : 0;
+	auto Heuristic = [&](int32 X, int32 Y)
+		{
+			return GoalCell != INDEX_NONE ? FMath::Abs(X - GoalX) + FMath::Abs(Y - GoalY) : 0;
+		};
+
+	const int32 StartX = StartCell % Grid->Size;
+	const int32 StartY = StartCell / Grid->Size;
+	LocalCost[ToLocal(StartX, StartY)] = 0;
+	LocalOpen.HeapPush(FGridOpenEntry{ Heuristic(StartX, StartY), 0, StartCell });
+
+	int32 dx[] = { 1, -1, 0, 0 };
+	int32 dy[] = { 0, 0, 1, -1 };
+
+	while (LocalOpen.Num() > 0)
+	{
+		FGridOpenEntry Current;
+		LocalOpen.HeapPop(Current, EAllowShrinking::No);
+
+		const int32 CurrentX = Current.Index % Grid->Size;
+		const int32 CurrentY = Current.Index / Grid->Size;
+		if (Current.Cost != LocalCost[ToLocal(CurrentX, CurrentY)])
+		{
+			continue;
+		}
+
+		if (Stats)
+		{
+			Stats->NodesExpanded++;
+		}
+
+		if (Current.Index == GoalCell)
+		{
+			return;
+		}
+
+		// Stop once every entrance marked in LocalTargetCount is settled
+		if (NumTargets > 0)
+		{
+			NumTargets -= LocalTargetCount[ToLocal(CurrentX, CurrentY)];
+			if (NumTargets <= 0)
+			{
+				return;
+			}
+		}
+
+		for (int32 i = 0; i < 4; i++)
+		{
+			const int32 NewX = CurrentX + dx[i];
+			const int32 NewY = CurrentY + dy[i];
+			if (NewX < LocalMinX || NewX > MaxX || NewY < LocalMinY || NewY > MaxY)
+			{
+				continue;
+			}
+
+			const int32 Neighbour = Grid->ToIndex(NewX, NewY);
+			if (!Grid->IsPassable(Neighbour))
+			{
+				continue;
+			}
+
+			const int32 NewCost = Current.Cost + Grid->StepCost[Neighbour];
+			const int32 LocalIndex = ToLocal(NewX, NewY);
+			if (NewCost < LocalCost[LocalIndex])
+			{
+				LocalCost[LocalIndex] = NewCost;
+				LocalParent[LocalIndex] = Current.Index;
+				LocalOpen.HeapPush(FGridOpenEntry{ NewCost + Heuristic(NewX, NewY), NewCost, Neighbour });
+			}
+		}
+	}
+}
+
+int32 FGridHierarchicalPathfinder::GetLocalCost(int32 Cell) const
+{
+	const int32 X = Cell % Grid->Size - LocalMinX;
+	const int32 Y = Cell / Grid->Size - LocalMinY;
+	if (X < 0 || X >= LocalWidth || Y < 0 || Y >= LocalHeight)
+	{
+		return FGridDistanceField::Unreachable;
+	}
+	return LocalCost[Y * LocalWidth + X];
+}
+
+void FGridHierarchicalPathfinder::AppendLocalPath(int32 GoalCell, TArray<FVector2D>& OutPath) const
+{
+	// Collect the cells back to the search start (excluded), then append them in walking order
+	TArray<int32, TInlineAllocator<64>> Cells;
+	for (int32 Cell = GoalCell; Cell != INDEX_NONE;)
+	{
+		const int32 LocalIndex = (Cell / Grid->Size - LocalMinY) * LocalWidth + (Cell % Grid->Size - LocalMinX);
+		const int32 Parent = LocalParent[LocalIndex];
+		if (Parent == INDEX_NONE)
+		{
+			break;
+		}
+		Cells.Add(Cell);
+		Cell = Parent;
+	}
+
+	for (int32 i = Cells.Num() - 1; i >= 0; i--)
+	{
+		OutPath.Add(FVector2D(Cells[i] % Grid->Size, Cells[i] / Grid->Size));
+	}
+}
+
+//----------------------------------------------
+// Queries
+//----------------------------------------------
+
+bool FGridHierarchicalPathfinder::FindPath(int32 StartX, int32 StartY, int32 GoalX, int32 GoalY, TArray<FVector2D>& OutPath, FGridSearchStats* Stats)
+{
+	OutPath.Reset();
+
+	if (!Grid || !Grid->IsValidCell(StartX, StartY) || !Grid->IsValidCell(GoalX, GoalY))
+	{
+		return false;
+	}
+
+	const int32 StartCell = Grid->ToIndex(StartX, StartY);
+	const int32 GoalCell = Grid->ToIndex(GoalX, GoalY);
+	if (StartCell == GoalCell)
+	{
+		OutPath.Add(FVector2D(StartX, StartY));
+		return true;
+	}
+	if (!Grid->IsPassable(GoalCell))
+	{
+		return false;
+	}
+
+	RebuildDirtyClusters(Stats);
+
+	const int32 StartCluster = GetClusterOfCell(StartCell);
+	const int32 GoalCluster = GetClusterOfCell(GoalCell);
+
+	// Same cluster: a local search usually settles it without touching the abstract graph
+	if (StartCluster == GoalCluster)
+	{
+		RunLocalSearch(StartCell, StartCluster, GoalCell, Stats);
+		if (GetLocalCost(GoalCell) != FGridDistanceField::Unreachable)
+		{
+			OutPath.Add(FVector2D(StartX, StartY));
+			AppendLocalPath(GoalCell, OutPath);
+			return true;
+		}
+	}
+
+	TArray<int32> ClusterNodes;
+
+	// Link the start to the entrances of its cluster
+	StartLinks.Reset();
+	RunLocalSearch(StartCell, StartCluster, INDEX_NONE, Stats);
+	GatherClusterNodes(StartCluster, ClusterNodes);
+	for (int32 NodeId : ClusterNodes)
+	{
+		const int32 Cost = GetLocalCost(Nodes[NodeId].Cell);
+		if (Cost != FGridDistanceField::Unreachable)
+		{
+			StartLinks.Add(FEdge{ NodeId, Cost, true });
+		}
+	}
+
+	// A blocked start (the moving unit's own cell) has no entrance of its own, so stepping off it
+	// across a cluster border is linked here through the neighbour on the other side
+	if (!Grid->IsPassable(StartCell))
+	{
+		int32 dx[] = { 1, -1, 0, 0 };
+		int32 dy[] = { 0, 0, 1, -1 };
+
+		for (int32 i = 0; i < 4; i++)
+		{
+			const int32 NewX = StartX + dx[i];
+			const int32 NewY = StartY + dy[i];
+			if (!Grid->IsValidCell(NewX, NewY))
+			{
+				continue;
+			}
+
+			const int32 Neighbour = Grid->ToIndex(NewX, NewY);
+			const int32 NeighbourCluster = GetClusterOfCell(Neighbour);
+			if (NeighbourCluster == StartCluster || !Grid->IsPassable(Neighbour))
+			{
+				continue;
+			}
+
+			RunLocalSearch(Neighbour, NeighbourCluster, INDEX_NONE, Stats);
+			GatherClusterNodes(NeighbourCluster, ClusterNodes);
+			for (int32 NodeId : ClusterNodes)
+			{
+				const int32 Cost = GetLocalCost(Nodes[NodeId].Cell);
+				if (Cost != FGridDistanceField::Unreachable)
+				{
+					StartLinks.Add(FEdge{ NodeId, Cost + Grid->StepCost[Neighbour], true });
+				}
+			}
+		}
+	}
+
+	// Link the entrances of the goal cluster to the goal; a sweep from the goal gives the reverse costs,
+	// and since each step costs the entered cell, Cost(n -> goal) = Cost(goal -> n) - Step(n) + Step(goal)
+	const int32 StartNode = Nodes.Num();
+	const int32 GoalNode = Nodes.Num() + 1;
+	GoalLinkCost.Init(FGridDistanceField::Unreachable, Nodes.Num());
+	RunLocalSearch(GoalCell, GoalCluster, INDEX_NONE, Stats);
+	GatherClusterNodes(GoalCluster, ClusterNodes);
+	for (int32 NodeId : ClusterNodes)
+	{
+		const int32 Cost = GetLocalCost(Nodes[NodeId].Cell);
+		if (Cost != FGridDistanceField::Unreachable)
+		{
+			GoalLinkCost[NodeId] = Cost - Grid->StepCost[Nodes[NodeId].Cell] + Grid->StepCost[GoalCell];
+		}
+	}
+
+	// A* over the entrance graph
+	AbstractCost.Init(FGridDistanceField::Unreachable, Nodes.Num() + 2);
+	AbstractParent.Init(INDEX_NONE, Nodes.Num() + 2);
+	AbstractOpen.Reset();
+
+	auto CellOf = [&](int32 NodeId) { return NodeId == StartNode ? StartCell : (NodeId == GoalNode ? GoalCell : Nodes[NodeId].Cell); };
+	auto Heuristic = [&](int32 NodeId)
+		{
+			const int32 Cell = CellOf(NodeId);
+			return FMath::Abs(Cell % Grid->Size - GoalX) + FMath::Abs(Cell / Grid->Size - GoalY);
+		};
+	auto Relax = [&](int32 From, int32 To, int32 Cost)
+		{
+			const int32 NewCost = AbstractCost[From] + Cost;
+			if (NewCost < AbstractCost[To])
+			{
+				AbstractCost[To] = NewCost;
+				AbstractParent[To] = From;
+				AbstractOpen.HeapPush(FGridOpenEntry{ NewCost + Heuristic(To), NewCost, To });
+			}
+		};
+
+	AbstractCost[StartNode] = 0;
+	AbstractOpen.HeapPush(FGridOpenEntry{ Heuristic(StartNode), 0, StartNode });
+
+	bool bFound = false;
+	while (AbstractOpen.Num() > 0)
+	{
+		FGridOpenEntry Current;
+		AbstractOpen.HeapPop(Current, EAllowShrinking::No);
+		if (Current.Cost != AbstractCost[Current.Index])
+		{
+			continue;
+		}
+
+		if (Stats)
+		{
+			Stats->NodesExpanded++;
+		}
+
+		if (Current.Index == GoalNode)
+		{
+			bFound = true;
+			break;
+		}
+
+		if (Current.Index == StartNode)
+		{
+			for (const FEdge& Link : StartLinks)
+			{
+				Relax(StartNode, Link.To, Link.Cost);
+			}
+			continue;
+		}
+
+		for (const FEdge& Edge : Nodes[Current.Index].Edges)
+		{
+			Relax(Current.Index, Edge.To, Edge.Cost);
+		}
+		if (GoalLinkCost[Current.Index] != FGridDistanceField::Unreachable)
+		{
+			Relax(Current.Index, GoalNode, GoalLinkCost[Current.Index]);
+		}
+	}
+
+	if (!bFound)
+	{
+		return false;
+	}
+
+	// Abstract route, start first
+	TArray<int32, TInlineAllocator<64>> Route;
+	for (int32 NodeId = GoalNode; NodeId != INDEX_NONE; NodeId = AbstractParent[NodeId])
+	{
+		Route.Add(NodeId);
+	}
+
+	// Refine every hop: adjacent cells are a border crossing, anything else is a walk inside one cluster
+	OutPath.Add(FVector2D(StartX, StartY));
+	for (int32 i = Route.Num() - 1; i > 0; i--)
+	{
+		const int32 FromCell = CellOf(Route[i]);
+		const int32 ToCell = CellOf(Route[i - 1]);
+		if (FromCell == ToCell)
+		{
+			continue;
+		}
+
+		const int32 Gap = FMath::Abs(FromCell % Grid->Size - ToCell % Grid->Size) + FMath::Abs(FromCell / Grid->Size - ToCell / Grid->Size);
+		if (Gap == 1 && GetClusterOfCell(FromCell) != GetClusterOfCell(ToCell))
+		{
+			OutPath.Add(FVector2D(ToCell % Grid->Size, ToCell / Grid->Size));
+			continue;
+		}
+
+		// A start link into a neighbouring cluster first steps off the start onto its neighbour there
+		int32 SearchFrom = FromCell;
+		if (Route[i] == StartNode && GetClusterOfCell(ToCell) != StartCluster)
+		{
+			const int32 ToCluster = GetClusterOfCell(ToCell);
+			int32 dx[] = { 1, -1, 0, 0 };
+			int32 dy[] = { 0, 0, 1, -1 };
+
+			for (int32 j = 0; j < 4; j++)
+			{
+				if (Grid->IsValidCell(StartX + dx[j], StartY + dy[j]) && GetClusterOfCell(Grid->ToIndex(StartX + dx[j], StartY + dy[j])) == ToCluster)
+				{
+					SearchFrom = Grid->ToIndex(StartX + dx[j], StartY + dy[j]);
+					break;
+				}
+			}
+			OutPath.Add(FVector2D(SearchFrom % Grid->Size, SearchFrom / Grid->Size));
+		}
+
+		RunLocalSearch(SearchFrom, GetClusterOfCell(SearchFrom), ToCell, Stats);
+		AppendLocalPath(ToCell, OutPath);
+	}
+
+	return true;
+}
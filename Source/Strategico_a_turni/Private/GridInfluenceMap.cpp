@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridInfluenceMap.h"
+#include "Unit.h"
+
+//----------------------------------------------
+// Maintenance
+//----------------------------------------------
+
+void FGridInfluenceMap::Reset()
+{
+	Stamps.Empty();
+	FMemory::Memzero(PlayerField, sizeof(PlayerField));
+	FMemory::Memzero(AIField, sizeof(AIField));
+}
+
+void FGridInfluenceMap::StampUnit(const AUnit* Unit, const FGridBitboard& Passable)
+{
+	if (!Unit)
+	{
+		return;
+	}
+
+	// Take the old contribution out before replacing it
+	RemoveUnit(Unit);
+
+	FUnitStamp Stamp;
+	Stamp.GridX = Unit->GridX;
+	Stamp.GridY = Unit->GridY;
+	Stamp.Movement = Unit->Movement;
+	Stamp.Range = Unit->RangeAttack;
+	Stamp.DamageSum = Unit->MinDamage + Unit->MaxDamage;
+	Stamp.bIsPlayerUnit = Unit->bIsPlayerUnit;
+	BuildStamp(Stamp, Passable);
+
+	ApplyStamp(Stamp, 1);
+	Stamps.Add(Unit, Stamp);
+}
+
+void FGridInfluenceMap::RemoveUnit(const AUnit* Unit)
+{
+	FUnitStamp Stamp;
+	if (Stamps.RemoveAndCopyValue(Unit, Stamp))
+	{
+		ApplyStamp(Stamp, -1);
+	}
+}
+
+void FGridInfluenceMap::RefreshAround(int32 GridX, int32 GridY, const FGridBitboard& Passable)
+{
+	if (!FGridBitboard::IsValidCell(GridX, GridY))
+	{
+		return;
+	}
+
+	for (TPair<const AUnit*, FUnitStamp>& Entry : Stamps)
+	{
+		FUnitStamp& Stamp = Entry.Value;
+
+		// A cell can only change a unit's reach if it lies on or next to it
+		if (!Stamp.Reach.Dilated().Test(GridX, GridY))
+		{
+			continue;
+		}
+
+		ApplyStamp(Stamp, -1);
+		BuildStamp(Stamp, Passable);
+		ApplyStamp(Stamp, 1);
+	}
+}
+
+void FGridInfluenceMap::RefreshAll(const FGridBitboard& Passable)
+{
+	for (TPair<const AUnit*, FUnitStamp>& Entry : Stamps)
+	{
+		ApplyStamp(Entry.Value, -1);
+		BuildStamp(Entry.Value, Passable);
+		ApplyStamp(Entry.Value, 1);
+	}
+}
+
+void FGridInfluenceMap::BuildStamp(FUnitStamp& Stamp, const FGridBitboard& Passable)
+{
+	FGridBitboard Start;
+	Start.Set(Stamp.GridX, Stamp.GridY);
+
+	// Attacks ignore obstacles, so the zone is the reachable area grown by the attack range
+	Stamp.Reach = FGridBitboard::ReachableWithin(Start, Stamp.Movement, Passable);
+	Stamp.Zone = Stamp.Reach.ExpandedBy(Stamp.Range);
+}
+
+void FGridInfluenceMap::ApplyStamp(const FUnitStamp& Stamp, int32 Sign)
+{
+	int32* Field = Stamp.bIsPlayerUnit ? PlayerField : AIField;
+	const int32 Delta = Sign * Stamp.DamageSum;
+
+	Stamp.Zone.ForEachSetCell([Field, Delta](int32 X, int32 Y)
+		{
+			Field[FGridBitboard::ToIndex(X, Y)] += Delta;
+		});
+}
+
+//----------------------------------------------
+// Queries
+//----------------------------------------------
+
+float FGridInfluenceMap::GetThreat(int32 GridX, int32 GridY, bool bFromPlayerUnits) const
+{
+	if (!FGridBitboard::IsValidCell(GridX, GridY))
+	{
+		return 0.0f;
+	}
+
+	const int32* Field = bFromPlayerUnits ? PlayerField : AIField;
+	return Field[FGridBitboard::ToIndex(GridX, GridY)] * 0.5f;
+}
+
+FGridBitboard FGridInfluenceMap::GetThreatZone(bool bFromPlayerUnits) const
+{
+	FGridBitboard Zone;
+	for (const TPair<const AUnit*, FUnitStamp>& Entry : Stamps)
+	{
+		if (Entry.Value.bIsPlayerUnit == bFromPlayerUnits)
+		{
+			Zone |= Entry.Value.Zone;
+		}
+	}
+	return Zone;
+}
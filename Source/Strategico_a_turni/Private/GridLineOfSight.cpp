@@ -0,0 +1,232 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridLineOfSight.h"
+
+//----------------------------------------------
+// Rays
+//----------------------------------------------
+
+void FGridLineOfSight::BuildRay(int32 DeltaX, int32 DeltaY, TArray<FRayStep>& OutSteps)
+{
+	const int32 NumX = FMath::Abs(DeltaX);
+	const int32 NumY = FMath::Abs(DeltaY);
+	const int32 SignX = DeltaX > 0 ? 1 : -1;
+	const int32 SignY = DeltaY > 0 ? 1 : -1;
+
+	int32 X = 0;
+	int32 Y = 0;
+	int32 StepsX = 0;
+	int32 StepsY = 0;
+	while (StepsX < NumX || StepsY < NumY)
+	{
+		// Compare where the ray leaves the current cell: through a vertical edge, a horizontal one, or exactly a corner
+		const int32 Decision = (1 + 2 * StepsX) * NumY - (1 + 2 * StepsY) * NumX;
+		if (Decision == 0)
+		{
+			OutSteps.Add({ FIntPoint(X + SignX, Y), FIntPoint(X, Y + SignY) });
+			X += SignX;
+			Y += SignY;
+			StepsX++;
+			StepsY++;
+		}
+		else if (Decision < 0)
+		{
+			X += SignX;
+			StepsX++;
+		}
+		else
+		{
+			Y += SignY;
+			StepsY++;
+		}
+
+		// The target cell never blocks its own ray
+		if (StepsX < NumX || StepsY < NumY)
+		{
+			OutSteps.Add({ FIntPoint(X, Y), FIntPoint(X, Y) });
+		}
+	}
+}
+
+const FGridLineOfSight::FRayTable& FGridLineOfSight::GetRayTable()
+{
+	static const FRayTable Table = []()
+	{
+		FRayTable Result;
+		Result.FirstStep.Init(0, FRayTable::Side * FRayTable::Side);
+		Result.NumSteps.Init(0, FRayTable::Side * FRayTable::Side);
+		Result.Crossing.SetNum(FRayTable::Side * FRayTable::Side);
+
+		for (int32 DeltaY = -MaxRange; DeltaY <= MaxRange; DeltaY++)
+		{
+			const int32 RowRange = MaxRange - FMath::Abs(DeltaY);
+			for (int32 DeltaX = -RowRange; DeltaX <= RowRange; DeltaX++)
+			{
+				const int32 Slot = FRayTable::ToSlot(DeltaX, DeltaY);
+				Result.FirstStep[Slot] = Result.Steps.Num();
+				BuildRay(DeltaX, DeltaY, Result.Steps);
+				Result.NumSteps[Slot] = Result.Steps.Num() - Result.FirstStep[Slot];
+
+				for (int32 StepIndex = Result.FirstStep[Slot]; StepIndex < Result.Steps.Num(); StepIndex++)
+				{
+					const FRayStep& Step = Result.Steps[StepIndex];
+					Result.Crossing[FRayTable::ToSlot(Step.A.X, Step.A.Y)].AddUnique(FIntPoint(DeltaX, DeltaY));
+					Result.Crossing[FRayTable::ToSlot(Step.B.X, Step.B.Y)].AddUnique(FIntPoint(DeltaX, DeltaY));
+				}
+			}
+		}
+		return Result;
+	}();
+
+	return Table;
+}
+
+bool FGridLineOfSight::IsRayClear(const FRayTable& Table, int32 FromX, int32 FromY, int32 DeltaX, int32 DeltaY, const FGridBitboard& Obstacles)
+{
+	const int32 Slot = FRayTable::ToSlot(DeltaX, DeltaY);
+	const FRayStep* Step = Table.Steps.GetData() + Table.FirstStep[Slot];
+	for (int32 i = 0; i < Table.NumSteps[Slot]; i++, Step++)
+	{
+		if (Obstacles.Test(FromX + Step->A.X, FromY + Step->A.Y) && Obstacles.Test(FromX + Step->B.X, FromY + Step->B.Y))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FGridLineOfSight::TraceRay(int32 FromX, int32 FromY, int32 ToX, int32 ToY, const FGridBitboard& Obstacles)
+{
+	const int32 DeltaX = ToX - FromX;
+	const int32 DeltaY = ToY - FromY;
+	if (FMath::Abs(DeltaX) + FMath::Abs(DeltaY) <= MaxRange)
+	{
+		return IsRayClear(GetRayTable(), FromX, FromY, DeltaX, DeltaY, Obstacles);
+	}
+
+	TArray<FRayStep> Steps;
+	BuildRay(DeltaX, DeltaY, Steps);
+	for (const FRayStep& Step : Steps)
+	{
+		if (Obstacles.Test(FromX + Step.A.X, FromY + Step.A.Y) && Obstacles.Test(FromX + Step.B.X, FromY + Step.B.Y))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------
+// Maintenance
+//----------------------------------------------
+
+void FGridLineOfSight::Reset()
+{
+	Visible.Empty();
+	Cells.Reset();
+	ObstacleCells.Reset();
+}
+
+void FGridLineOfSight::Build(const FGridBitboard& Obstacles, const FGridBitboard& BoardCells)
+{
+	const FRayTable& Table = GetRayTable();
+
+	Cells = BoardCells;
+	ObstacleCells = Obstacles;
+	Visible.SetNum(FGridBitboard::NumCells);
+
+	for (int32 Index = 0; Index < FGridBitboard::NumCells; Index++)
+	{
+		FGridBitboard& Row = Visible[Index];
+		Row.Reset();
+
+		const int32 X = Index % FGridBitboard::Stride;
+		const int32 Y = Index / FGridBitboard::Stride;
+		if (!Cells.TestIndex(Index))
+		{
+			continue;
+		}
+
+		for (int32 DeltaY = -MaxRange; DeltaY <= MaxRange; DeltaY++)
+		{
+			const int32 RowRange = MaxRange - FMath::Abs(DeltaY);
+			for (int32 DeltaX = -RowRange; DeltaX <= RowRange; DeltaX++)
+			{
+				if (Cells.Test(X + DeltaX, Y + DeltaY) && IsRayClear(Table, X, Y, DeltaX, DeltaY, Obstacles))
+				{
+					Row.Set(X + DeltaX, Y + DeltaY);
+				}
+			}
+		}
+	}
+}
+
+void FGridLineOfSight::NotifyObstacleChanged(int32 GridX, int32 GridY, const FGridBitboard& Obstacles)
+{
+	if (!IsBuilt() || !Cells.Test(GridX, GridY))
+	{
+		return;
+	}
+
+	const FRayTable& Table = GetRayTable();
+	ObstacleCells = Obstacles;
+
+	// A viewer can only have a ray through the cell if the cell is within MaxRange of it
+	for (int32 OffsetY = -MaxRange; OffsetY <= MaxRange; OffsetY++)
+	{
+		const int32 RowRange = MaxRange - FMath::Abs(OffsetY);
+		for (int32 OffsetX = -RowRange; OffsetX <= RowRange; OffsetX++)
+		{
+			const int32 ViewerX = GridX - OffsetX;
+			const int32 ViewerY = GridY - OffsetY;
+			if (!Cells.Test(ViewerX, ViewerY))
+			{
+				continue;
+			}
+
+			FGridBitboard& Row = Visible[FGridBitboard::ToIndex(ViewerX, ViewerY)];
+			for (const FIntPoint& Target : Table.Crossing[FRayTable::ToSlot(OffsetX, OffsetY)])
+			{
+				const int32 TargetX = ViewerX + Target.X;
+				const int32 TargetY = ViewerY + Target.Y;
+				if (!Cells.Test(TargetX, TargetY))
+				{
+					continue;
+				}
+
+				if (IsRayClear(Table, ViewerX, ViewerY, Target.X, Target.Y, Obstacles))
+				{
+					Row.Set(TargetX, TargetY);
+				}
+				else
+				{
+					Row.Clear(TargetX, TargetY);
+				}
+			}
+		}
+	}
+}
+
+//----------------------------------------------
+// Queries
+//----------------------------------------------
+
+const FGridBitboard& FGridLineOfSight::GetVisibleCells(int32 GridX, int32 GridY) const
+{
+	static const FGridBitboard Empty;
+	if (!IsBuilt() || !FGridBitboard::IsValidCell(GridX, GridY))
+	{
+		return Empty;
+	}
+	return Visible[FGridBitboard::ToIndex(GridX, GridY)];
+}
+
+bool FGridLineOfSight::IsVisible(int32 FromX, int32 FromY, int32 ToX, int32 ToY) const
+{
+	if (IsBuilt() && FMath::Abs(ToX - FromX) + FMath::Abs(ToY - FromY) <= MaxRange && Cells.Test(FromX, FromY))
+	{
+		return Visible[FGridBitboard::ToIndex(FromX, FromY)].Test(ToX, ToY);
+	}
+	return TraceRay(FromX, FromY, ToX, ToY, ObstacleCells);
+}
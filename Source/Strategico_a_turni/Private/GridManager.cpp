@@ -3,6 +3,11 @@
 
 #include "GridManager.h"
 #include "Unit.h"
+#include "EngineUtils.h"
+#include "SaT_Stats.h"
+#include "SaT_TurnTelemetry.h"
+#include "SaT_Memory.h"
+#include "HAL/PlatformTime.h"
 
 //----------------------------------------------
 // Constructor and Lifecycle Methods
@@ -16,9 +21,11 @@ AGridManager::AGridManager()
 	PrimaryActorTick.bCanEverTick = false;
 
 	// Default grid properties
-	Size = 25; 	// size of the field (25x25)
+	Size = FGridBitboard::Stride; 	// size of the field (25x25)
 	TileSize = 100.0f; 	// tile dimension
 	CellPadding = 0.01f; // tile padding percentage 
+	TerrainPercentage = 0.0f; // every cell plain unless a game mode asks for terrain
+	bRequireLineOfSight = false; // attacks ignore obstacles unless the rule is turned on
 
 	// Load materials
 	static ConstructorHelpers::FObjectFinder<UMaterial> DefaultMatAsset(TEXT("/Game/Materials/M_BaseMaterial"));
@@ -49,6 +56,8 @@ AGridManager::AGridManager()
 void AGridManager::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
+	// Levels saved while Size was editable may hold another size; the board is always the bitboard width
+	Size = FGridBitboard::Stride;
 	// Calculate the normalized tile positioning multiplier
 	NextCellPositionMultiplier = FMath::RoundToDouble(((TileSize + TileSize * CellPadding) / TileSize) * 100) / 100;
 }
@@ -85,19 +94,35 @@ void AGridManager::BeginPlay()
 
 void AGridManager::GenerateField()
 {
+	SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_BoardGeneration);
+	LLM_SCOPE_BYTAG(SaT_Grid);
 
-	// Clear all existing tiles first
+	// Keep the tiles of the previous field for reuse instead of destroying and respawning them
+	TArray<ATile*> ReusableTiles;
+	ReusableTiles.Reserve(TileArray.Num());
 	for (ATile* Tile : TileArray)
 	{
-		if (Tile)
+		if (IsValid(Tile))
 		{
-			Tile->Destroy();
+			ReusableTiles.Add(Tile);
 		}
 	}
-	TileArray.Empty();
-	TileMap.Empty();
+
+	TileArray.Reset();
+	TileMap.Empty(Size * Size);
 	HighlightedTiles.Empty();
 	PathTiles.Empty();
+	PlayerUnitBoards.Reset();
+	AIUnitBoards.Reset();
+	GridCellsBoard.Reset();
+	ObstacleBoard.Reset();
+	HighlightBoard.Reset();
+	InfluenceMap.Reset();
+	LineOfSight.Reset();
+	DistanceTable.Reset();
+	bNavigationGridDirty = true;
+	TerrainMap.Init(ETerrainType::PLAIN, Size * Size);
+	NumWeightedCells = 0;
 
 	// First, generate the basic grid without obstacles
 	for (int32 IndexX = 0; IndexX < Size; IndexX++)
@@ -105,7 +130,12 @@ void AGridManager::GenerateField()
 		for (int32 IndexY = 0; IndexY < Size; IndexY++)
 		{
 			FVector Location = AGridManager::GetRelativeLocationByXYPosition(IndexX, IndexY);
-			ATile* Obj = GetWorld()->SpawnActor<ATile>(TileClass, Location, FRotator::ZeroRotator);
+			ATile* Obj = AcquireTile(ReusableTiles, Location);
+			if (!Obj)
+			{
+				continue;
+			}
+
 			const float TileScale = TileSize / 100.0f;
 			const float Zscaling = 0.01f;
 			Obj->SetActorScale3D(FVector(TileScale, TileScale, Zscaling));
@@ -117,11 +147,139 @@ void AGridManager::GenerateField()
 
 			TileArray.Add(Obj);
 			TileMap.Add(FVector2D(IndexX, IndexY), Obj);
+			GridCellsBoard.Set(IndexX, IndexY);
 		}
 	}
 
-	// After generating the basic grid, add obstacles
+	// Tiles the new field did not reuse are not needed anymore
+	for (ATile* Tile : ReusableTiles)
+	{
+		DestroyTile(Tile);
+	}
+
+	// After generating the basic grid, add obstacles and then terrain on the cells left free
 	GenerateObstacles();
+	GenerateTerrain();
+
+	// Later obstacle changes patch the tables instead of rebuilding them
+	LineOfSight.Build(ObstacleBoard, GridCellsBoard);
+	RebuildDistanceTable();
+}
+
+//----------------------------------------------
+// Tile Lifecycle
+//----------------------------------------------
+
+ATile* AGridManager::AcquireTile(TArray<ATile*>& ReusableTiles, const FVector& Location)
+{
+	LLM_SCOPE_BYTAG(SaT_Tiles);
+
+	if (ReusableTiles.Num() > 0)
+	{
+		ATile* Tile = ReusableTiles.Pop(EAllowShrinking::No);
+		Tile->ResetTile();
+		Tile->SetActorLocation(Location);
+		if (DefaultTileMaterial)
+		{
+			Tile->StaticMeshComponent->SetMaterial(0, DefaultTileMaterial);
+			INC_DWORD_STAT(STAT_SaT_MaterialsSet);
+			SAT_TELEMETRY_ADD(TilesRematerialized, 1);
+		}
+		TilesReused++;
+		return Tile;
+	}
+
+	ATile* Tile = GetWorld()->SpawnActor<ATile>(TileClass, Location, FRotator::ZeroRotator);
+	if (Tile)
+	{
+		TilesSpawned++;
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to spawn tile at %s"), *Location.ToString());
+	}
+	return Tile;
+}
+
+void AGridManager::DestroyTile(ATile* Tile)
+{
+	if (IsValid(Tile))
+	{
+		Tile->Destroy();
+		TilesDestroyed++;
+	}
+}
+
+FGridTileReport AGridManager::GetTileReport() const
+{
+	FGridTileReport Report;
+	Report.ActiveTiles = TileArray.Num();
+	Report.TotalSpawned = TilesSpawned;
+	Report.TotalReused = TilesReused;
+	Report.TotalDestroyed = TilesDestroyed;
+	Report.ContainerBytes = TileArray.GetAllocatedSize() + TileMap.GetAllocatedSize() +
+		HighlightedTiles.GetAllocatedSize() + PathTiles.GetAllocatedSize();
+
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return Report;
+	}
+
+	const TSet<ATile*> Tracked(TileArray);
+
+	TInlineComponentArray<UActorComponent*> Components;
+	for (TActorIterator<ATile> It(World); It; ++It)
+	{
+		ATile* Tile = *It;
+		if (!IsValid(Tile))
+		{
+			continue;
+		}
+
+		Report.LiveTileActors++;
+		if (!Tracked.Contains(Tile))
+		{
+			Report.OrphanedTiles++;
+		}
+
+		// Object footprint plus whatever the objects report on top of it
+		Report.TileActorBytes += Tile->GetClass()->GetStructureSize() + Tile->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		Tile->GetComponents(Components);
+		for (const UActorComponent* Component : Components)
+		{
+			Report.TileActorBytes += Component->GetClass()->GetStructureSize() + Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		}
+	}
+
+	return Report;
+}
+
+SIZE_T AGridManager::GetGridStateAllocatedSize() const
+{
+	return PlayerUnitBoards.ByRange.GetAllocatedSize() + AIUnitBoards.ByRange.GetAllocatedSize() + InfluenceMap.GetAllocatedSize() +
+		TerrainMap.GetAllocatedSize() + LineOfSight.GetAllocatedSize();
+}
+
+SIZE_T AGridManager::GetPathfindingAllocatedSize() const
+{
+	return NavigationGrid.StepCost.GetAllocatedSize() + PathScratch.GetAllocatedSize() +
+		MovementGrid.StepCost.GetAllocatedSize() + MovementField.GetAllocatedSize() + DistanceTable.GetAllocatedSize();
+}
+
+void AGridManager::LogTileReport() const
+{
+	const FGridTileReport Report = GetTileReport();
+
+	UE_LOG(LogTemp, Log, TEXT("Tiles: %d active, %d live actors, %d orphaned | spawned %d, reused %d, destroyed %d | ~%.1f KB actors, %.1f KB containers"),
+		Report.ActiveTiles, Report.LiveTileActors, Report.OrphanedTiles,
+		Report.TotalSpawned, Report.TotalReused, Report.TotalDestroyed,
+		Report.TileActorBytes / 1024.0, Report.ContainerBytes / 1024.0);
+
+	if (Report.OrphanedTiles > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%d tile actors are not tracked by the grid and will never be reused"), Report.OrphanedTiles);
+	}
 }
 
 //----------------------------------------------
@@ -130,7 +288,14 @@ void AGridManager::GenerateField()
 
 FVector2D AGridManager::GetPosition(const FHitResult& Hit)
 {
-	return Cast<ATile>(Hit.GetActor())->GetGridPosition();
+	// Tiles have no collision anymore, so the hit is usually something standing on the board
+	if (ATile* Tile = Cast<ATile>(Hit.GetActor()))
+	{
+		return Tile->GetGridPosition();
+	}
+
+	const FVector2D Cell = GetXYPositionByRelativeLocation(Hit.Location);
+	return FVector2D(FMath::RoundToInt32(Cell.X), FMath::RoundToInt32(Cell.Y));
 }
 
 TArray<ATile*>& AGridManager::GetTileArray()
@@ -151,6 +316,27 @@ FVector2D AGridManager::GetXYPositionByRelativeLocation(const FVector& Location)
 	return FVector2D(XPos, YPos);
 }
 
+bool AGridManager::GetCellUnderRay(const FVector& RayOrigin, const FVector& RayDirection, int32& OutGridX, int32& OutGridY) const
+{
+	// Tiles are centered on their grid location, all at the height of cell (0, 0)
+	const double BoardZ = GetRelativeLocationByXYPosition(0, 0).Z;
+	if (FMath::IsNearlyZero(RayDirection.Z))
+	{
+		return false;
+	}
+
+	const double T = (BoardZ - RayOrigin.Z) / RayDirection.Z;
+	if (T < 0.0)
+	{
+		return false;
+	}
+
+	const FVector2D Cell = GetXYPositionByRelativeLocation(RayOrigin + T * RayDirection);
+	OutGridX = FMath::RoundToInt32(Cell.X);
+	OutGridY = FMath::RoundToInt32(Cell.Y);
+	return IsValidPosition(FVector2D(OutGridX, OutGridY));
+}
+
 inline bool AGridManager::IsValidPosition(const FVector2D Position) const
 {
 	return 0 <= Position.X && Position.X < Size && 0 <= Position.Y && Position.Y < Size;
@@ -260,6 +446,8 @@ bool AGridManager::IsCellOccupied(int32 GridX, int32 GridY)
 // Occupies a cell with one unit
 void AGridManager::OccupyCell(int32 GridX, int32 GridY, AUnit* Unit)
 {
+	LLM_SCOPE_BYTAG(SaT_Grid);
+
 	// Verify if the coordinates are valid
 	if (!IsValidPosition(FVector2D(GridX, GridY)))
 	{
@@ -276,11 +464,21 @@ void AGridManager::OccupyCell(int32 GridX, int32 GridY, AUnit* Unit)
 			// If Unit is nullptr, we're freeing the cell
 			if (Unit == nullptr)
 			{
+				AUnit* PreviousUnit = Tile->OccupyingUnit;
+
 				// Mark the tile as unoccupied
 				Tile->bIsOccupied = false;
 
 				// Clear the reference to the occupying unit
 				Tile->OccupyingUnit = nullptr;
+
+				ClearUnitBoardCell(GridX, GridY);
+
+				// The leaving unit stops threatening; neighbours may now walk through the cell
+				InfluenceMap.RemoveUnit(PreviousUnit);
+				InfluenceMap.RefreshAround(GridX, GridY, GetPassableBoard());
+
+				UpdateNavigationCell(GridX, GridY);
 			}
 			else
 			{
@@ -298,11 +496,29 @@ void AGridManager::OccupyCell(int32 GridX, int32 GridY, AUnit* Unit)
 				FVector WorldLocation = GetWorldLocationFromGrid(GridX, GridY);
 				Unit->SetActorLocation(WorldLocation);
 
+				// Record the unit in its team's occupancy bitboards
+				ClearUnitBoardCell(GridX, GridY);
+				FTeamUnitBoards& TeamBoards = Unit->bIsPlayerUnit ? PlayerUnitBoards : AIUnitBoards;
+				TeamBoards.All.Set(GridX, GridY);
+				TeamBoards.ByRange.FindOrAdd(Unit->RangeAttack).Set(GridX, GridY);
+
+				// Re-stamp units blocked by the new arrival, then stamp the unit itself
+				const FGridBitboard Passable = GetPassableBoard();
+				InfluenceMap.RefreshAround(GridX, GridY, Passable);
+				InfluenceMap.StampUnit(Unit, Passable);
+
+				UpdateNavigationCell(GridX, GridY);
 			}
 		}
 	}
 }
 
+AUnit* AGridManager::GetUnitAt(int32 GridX, int32 GridY) const
+{
+	ATile* Tile = TileMap.FindRef(FVector2D(GridX, GridY));
+	return Tile ? Tile->OccupyingUnit : nullptr;
+}
+
 FVector AGridManager::GetWorldLocationFromGrid(int32 GridX, int32 GridY)
 {
 	// Check if the grid coordinates are valid
@@ -324,12 +540,397 @@ FVector AGridManager::GetWorldLocationFromGrid(int32 GridX, int32 GridY)
 	return WorldLocation;
 }
 
+//----------------------------------------------
+// Bitboard Range Queries
+//----------------------------------------------
+
+FGridBitboard AGridManager::GetCellsInRange(int32 GridX, int32 GridY, int32 Range) const
+{
+	// Cells without a tile are not part of the grid
+	return FGridBitboard::MakeRangeMask(GridX, GridY, Range) & GridCellsBoard;
+}
+
+const FGridBitboard& AGridManager::GetUnitBoard(bool bPlayerUnits) const
+{
+	return bPlayerUnits ? PlayerUnitBoards.All : AIUnitBoards.All;
+}
+
+FGridBitboard AGridManager::GetThreatsToCell(int32 GridX, int32 GridY, bool bPlayerUnits) const
+{
+	// Range is symmetric: a unit with range R threatens the cell iff it stands inside the diamond of radius R around it
+	const FTeamUnitBoards& TeamBoards = bPlayerUnits ? PlayerUnitBoards : AIUnitBoards;
+
+	FGridBitboard Threats;
+	for (const TPair<int32, FGridBitboard>& RangeBoard : TeamBoards.ByRange)
+	{
+		Threats |= FGridBitboard::MakeRangeMask(GridX, GridY, RangeBoard.Key) & RangeBoard.Value;
+	}
+
+	// Sight is symmetric too, so the attackers are the ones the cell can see
+	if (bRequireLineOfSight && !Threats.IsEmpty())
+	{
+		Threats.ForEachSetCell([&](int32 X, int32 Y)
+			{
+				if (!HasLineOfSight(GridX, GridY, X, Y))
+				{
+					Threats.Clear(X, Y);
+				}
+			});
+	}
+	return Threats;
+}
+
+FGridBitboard AGridManager::GetOccupancyBoard() const
+{
+	return ObstacleBoard | PlayerUnitBoards.All | AIUnitBoards.All;
+}
+
+FGridBitboard AGridManager::GetPassableBoard() const
+{
+	FGridBitboard Passable = GridCellsBoard;
+	Passable.AndNot(GetOccupancyBoard());
+	return Passable;
+}
+
+FGridBitboard AGridManager::GetReachableCells(int32 GridX, int32 GridY, int32 Steps) const
+{
+	SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_Pathfinding);
+	SAT_TELEMETRY_ADD(PathfindingCalls, 1);
+
+	// Step counts no longer match movement costs, so sweep the costs and keep the cells within budget
+	if (HasWeightedTerrain())
+	{
+		FGridBitboard Reachable;
+		ComputeMovementField(GridX, GridY, Steps);
+		for (int32 Index = 0; Index < MovementField.Distance.Num(); Index++)
+		{
+			const int32 Cost = MovementField.Distance[Index];
+			if (Cost > 0 && Cost <= Steps)
+			{
+				Reachable.Set(Index % Size, Index / Size);
+			}
+		}
+		return Reachable;
+	}
+
+	FGridBitboard Start;
+	Start.Set(GridX, GridY);
+
+	// One word-parallel BFS layer per step, then drop the start cell itself
+	FGridBitboard Reachable = FGridBitboard::ReachableWithin(Start, Steps, GetPassableBoard());
+	Reachable.AndNot(Start);
+	return Reachable;
+}
+
+FGridBitboard AGridManager::GetThreatMap(bool bPlayerUnits) const
+{
+	const FTeamUnitBoards& TeamBoards = bPlayerUnits ? PlayerUnitBoards : AIUnitBoards;
+
+	// With line of sight each unit only threatens what it can see
+	FGridBitboard Threats;
+	if (bRequireLineOfSight)
+	{
+		for (const TPair<int32, FGridBitboard>& RangeBoard : TeamBoards.ByRange)
+		{
+			RangeBoard.Value.ForEachSetCell([&](int32 X, int32 Y)
+				{
+					Threats |= GetAttackableCells(X, Y, RangeBoard.Key);
+				});
+		}
+		return Threats;
+	}
+
+	// Grow every group of units sharing a range by that range, attacks ignore obstacles
+	for (const TPair<int32, FGridBitboard>& RangeBoard : TeamBoards.ByRange)
+	{
+		if (!RangeBoard.Value.IsEmpty())
+		{
+			Threats |= RangeBoard.Value.ExpandedBy(RangeBoard.Key);
+		}
+	}
+	return Threats & GridCellsBoard;
+}
+
+bool AGridManager::HasLineOfSight(int32 FromX, int32 FromY, int32 ToX, int32 ToY) const
+{
+	return LineOfSight.IsVisible(FromX, FromY, ToX, ToY);
+}
+
+bool AGridManager::CanAttackCell(int32 FromX, int32 FromY, int32 ToX, int32 ToY, int32 Range) const
+{
+	if (!FGridBitboard::IsOffsetInRange(ToX - FromX, ToY - FromY, Range))
+	{
+		return false;
+	}
+	return !bRequireLineOfSight || HasLineOfSight(FromX, FromY, ToX, ToY);
+}
+
+FGridBitboard AGridManager::GetAttackableCells(int32 GridX, int32 GridY, int32 Range) const
+{
+	FGridBitboard Cells = GetCellsInRange(GridX, GridY, Range);
+	if (!bRequireLineOfSight)
+	{
+		return Cells;
+	}
+
+	// The table covers the whole range in one AND; longer ranges check the far cells one ray at a time
+	if (Range <= FGridLineOfSight::MaxRange && LineOfSight.IsBuilt())
+	{
+		return Cells & LineOfSight.GetVisibleCells(GridX, GridY);
+	}
+
+	Cells.ForEachSetCell([&](int32 X, int32 Y)
+		{
+			if (!HasLineOfSight(GridX, GridY, X, Y))
+			{
+				Cells.Clear(X, Y);
+			}
+		});
+	return Cells;
+}
+
+void AGridManager::SetCellObstacle(int32 GridX, int32 GridY, bool bObstacle)
+{
+	ATile* Tile = TileMap.FindRef(FVector2D(GridX, GridY));
+	if (!Tile)
+	{
+		return;
+	}
+
+	Tile->bIsObstacle = bObstacle;
+
+	// Obstacles also count as occupied; a freed cell stays occupied only if a unit stands on it
+	Tile->bIsOccupied = bObstacle || Tile->OccupyingUnit != nullptr;
+
+	if (bObstacle)
+	{
+		ObstacleBoard.Set(GridX, GridY);
+		if (ObstacleMaterial)
+		{
+			Tile->StaticMeshComponent->SetMaterial(0, ObstacleMaterial);
+			INC_DWORD_STAT(STAT_SaT_MaterialsSet);
+			SAT_TELEMETRY_ADD(TilesRematerialized, 1);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("ObstacleMaterial is NULL! Cannot visualize obstacle at (%d,%d)"), GridX, GridY);
+		}
+	}
+	else
+	{
+		ObstacleBoard.Clear(GridX, GridY);
+		if (UMaterialInterface* BaseMaterial = GetBaseTileMaterial(GridX, GridY))
+		{
+			Tile->StaticMeshComponent->SetMaterial(0, BaseMaterial);
+			INC_DWORD_STAT(STAT_SaT_MaterialsSet);
+			SAT_TELEMETRY_ADD(TilesRematerialized, 1);
+		}
+	}
+
+	if (!bDeferObstacleRefresh)
+	{
+		InfluenceMap.RefreshAround(GridX, GridY, GetPassableBoard());
+		LineOfSight.NotifyObstacleChanged(GridX, GridY, ObstacleBoard);
+	}
+
+	// Only a field already generated has a table to refresh, swept once on the next read
+	if (DistanceTable.IsBuilt())
+	{
+		bDistanceTableDirty = true;
+	}
+
+	UpdateNavigationCell(GridX, GridY);
+}
+
+bool AGridManager::FindPathWithin(int32 StartX, int32 StartY, int32 EndX, int32 EndY, int32 MaxSteps, TArray<FVector2D>& OutPath) const
+{
+	SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_Pathfinding);
+	LLM_SCOPE_BYTAG(SaT_Pathfinding);
+	SAT_TELEMETRY_ADD(PathfindingCalls, 1);
+
+	OutPath.Reset();
+
+	if (!GridCellsBoard.Test(StartX, StartY) || !GridCellsBoard.Test(EndX, EndY))
+	{
+		return false;
+	}
+
+	if (HasWeightedTerrain())
+	{
+		ComputeMovementField(StartX, StartY, MaxSteps);
+		return MovementField.GetPathTo(EndX, EndY, OutPath);
+	}
+
+	const FGridBitboard Passable = GetPassableBoard();
+
+	// Layers[i] holds every cell reachable in at most i moves
+	TArray<FGridBitboard> Layers;
+	FGridBitboard Start;
+	Start.Set(StartX, StartY);
+	Layers.Add(Start);
+
+	while (!Layers.Last().Test(EndX, EndY))
+	{
+		if (Layers.Num() > MaxSteps)
+		{
+			return false;
+		}
+
+		const FGridBitboard Next = (Layers.Last().Dilated() & Passable) | Layers.Last();
+		if (Next == Layers.Last())
+		{
+			return false;
+		}
+		Layers.Add(Next);
+	}
+
+	// Walk back from the end, always stepping onto a neighbour first reached one layer earlier
+	int32 dx[] = { 1, -1, 0, 0 };
+	int32 dy[] = { 0, 0, 1, -1 };
+
+	int32 X = EndX;
+	int32 Y = EndY;
+	OutPath.SetNum(Layers.Num());
+	OutPath[Layers.Num() - 1] = FVector2D(X, Y);
+
+	for (int32 Layer = Layers.Num() - 2; Layer >= 0; Layer--)
+	{
+		for (int32 i = 0; i < 4; i++)
+		{
+			if (Layers[Layer].Test(X + dx[i], Y + dy[i]))
+			{
+				X += dx[i];
+				Y += dy[i];
+				break;
+			}
+		}
+		OutPath[Layer] = FVector2D(X, Y);
+	}
+
+	return true;
+}
+
+void AGridManager::BuildSearchGrid(FGridSearchGrid& OutGrid, bool bUnitsBlock) const
+{
+	// Cells without a tile stay impassable
+	OutGrid.Init(Size, 0);
+
+	for (ATile* Tile : TileArray)
+	{
+		if (!Tile || !OutGrid.IsValidCell(Tile->GridX, Tile->GridY))
+		{
+			continue;
+		}
+
+		const bool bBlocked = Tile->bIsObstacle || (bUnitsBlock && Tile->bIsOccupied);
+		OutGrid.StepCost[OutGrid.ToIndex(Tile->GridX, Tile->GridY)] = bBlocked ? 0 : GetTerrainCost(GetCellTerrain(Tile->GridX, Tile->GridY));
+	}
+}
+
+void AGridManager::ComputeMovementField(int32 GridX, int32 GridY, int32 MaxCost) const
+{
+	LLM_SCOPE_BYTAG(SaT_Pathfinding);
+
+	FGridSearchStats Stats;
+	BuildSearchGrid(MovementGrid, true);
+	FGridPathfinding::ComputeDistanceField(MovementGrid, GridX, GridY, MovementField, MaxCost, &Stats);
+	INC_DWORD_STAT_BY(STAT_SaT_NodesExpanded, Stats.NodesExpanded);
+	SAT_TELEMETRY_ADD(NodesExpanded, Stats.NodesExpanded);
+}
+
+bool AGridManager::FindPath(int32 StartX, int32 StartY, int32 EndX, int32 EndY, TArray<FVector2D>& OutPath, FGridSearchStats* Stats)
+{
+	SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_Pathfinding);
+	LLM_SCOPE_BYTAG(SaT_Pathfinding);
+
+	if (bNavigationGridDirty)
+	{
+		BuildSearchGrid(NavigationGrid, true);
+		bNavigationGridDirty = false;
+	}
+
+	// Count the work even when the caller did not ask for stats, so the stat group sees it
+	FGridSearchStats LocalStats;
+	FGridSearchStats& QueryStats = Stats ? *Stats : LocalStats;
+	const int32 NodesBefore = QueryStats.NodesExpanded;
+
+	// The static distances are an exact heuristic whenever no unit is in the way
+	const bool bFound = FGridPathfinding::FindPath(NavigationGrid, StartX, StartY, EndX, EndY, OutPath, PathScratch, &QueryStats, &GetDistanceTable());
+
+	INC_DWORD_STAT_BY(STAT_SaT_NodesExpanded, QueryStats.NodesExpanded - NodesBefore);
+	SAT_TELEMETRY_ADD(PathfindingCalls, 1);
+	SAT_TELEMETRY_ADD(NodesExpanded, QueryStats.NodesExpanded - NodesBefore);
+	return bFound;
+}
+
+void AGridManager::RebuildDistanceTable()
+{
+	SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_Pathfinding);
+	LLM_SCOPE_BYTAG(SaT_Pathfinding);
+
+	// Units move every turn, so they stay out of the table and are left to the searches
+	FGridSearchGrid StaticGrid;
+	BuildSearchGrid(StaticGrid, false);
+
+	bDistanceTableDirty = false;
+	const double StartSeconds = FPlatformTime::Seconds();
+	if (DistanceTable.Build(StaticGrid))
+	{
+		UE_LOG(LogTemp, Log, TEXT("Built the %dx%d distance table in %.2f ms"), Size, Size, (FPlatformTime::Seconds() - StartSeconds) * 1000.0);
+	}
+}
+
+const FGridDistanceTable& AGridManager::GetDistanceTable()
+{
+	if (bDistanceTableDirty)
+	{
+		RebuildDistanceTable();
+	}
+	return DistanceTable;
+}
+
+void AGridManager::RefreshObstacleTables()
+{
+	InfluenceMap.RefreshAll(GetPassableBoard());
+	if (LineOfSight.IsBuilt())
+	{
+		LineOfSight.Build(ObstacleBoard, GridCellsBoard);
+	}
+}
+
+void AGridManager::UpdateNavigationCell(int32 GridX, int32 GridY)
+{
+	// Nothing to patch until the first FindPath builds the grid
+	if (bNavigationGridDirty || !NavigationGrid.IsValidCell(GridX, GridY))
+	{
+		return;
+	}
+
+	ATile* Tile = TileMap.FindRef(FVector2D(GridX, GridY));
+	const bool bBlocked = !Tile || Tile->bIsObstacle || Tile->bIsOccupied;
+	NavigationGrid.StepCost[NavigationGrid.ToIndex(GridX, GridY)] = bBlocked ? 0 : GetTerrainCost(GetCellTerrain(GridX, GridY));
+}
+
+void AGridManager::ClearUnitBoardCell(int32 GridX, int32 GridY)
+{
+	for (FTeamUnitBoards* TeamBoards : { &PlayerUnitBoards, &AIUnitBoards })
+	{
+		TeamBoards->All.Clear(GridX, GridY);
+		for (TPair<int32, FGridBitboard>& RangeBoard : TeamBoards->ByRange)
+		{
+			RangeBoard.Value.Clear(GridX, GridY);
+		}
+	}
+}
+
 //----------------------------------------------
 // Visualization and Highlighting Methods
 //----------------------------------------------
 
 void AGridManager::HighlightCell(int32 GridX, int32 GridY, bool bHighlight)
 {
+	SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_HighlightCommit);
+
 	// Verify if the position is valid
 	if (!IsValidPosition(FVector2D(GridX, GridY)))
 	{
@@ -348,24 +949,38 @@ void AGridManager::HighlightCell(int32 GridX, int32 GridY, bool bHighlight)
 		// Apply highlighting material to the tile
 		if (bHighlight)
 		{
+			// Already highlighted, nothing to commit
+			if (HighlightBoard.Test(GridX, GridY))
+			{
+				return;
+			}
+
 			// Set highlight material
 			if (HighlightMaterial)
 			{
 				Tile->StaticMeshComponent->SetMaterial(0, HighlightMaterial);
+				INC_DWORD_STAT(STAT_SaT_MaterialsSet);
+				SAT_TELEMETRY_ADD(TilesRematerialized, 1);
 				HighlightedTiles.Add(Tile); // Add to tracked list
+				HighlightBoard.Set(GridX, GridY);
 			}
 		}
 		else
 		{
 			// Restore original material
-			Tile->StaticMeshComponent->SetMaterial(0, DefaultTileMaterial);
+			Tile->StaticMeshComponent->SetMaterial(0, GetBaseTileMaterial(GridX, GridY));
+			INC_DWORD_STAT(STAT_SaT_MaterialsSet);
+			SAT_TELEMETRY_ADD(TilesRematerialized, 1);
 			HighlightedTiles.Remove(Tile); // Remove from tracked list
+			HighlightBoard.Clear(GridX, GridY);
 		}
 	}
 }
 
 bool AGridManager::HighlightPath(TArray<FVector2D> PathPoints, bool bClearPrevious)
 {
+	SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_HighlightCommit);
+
 
 	// Verify path material exists
 	if (!PathMaterial)
@@ -499,6 +1114,8 @@ bool AGridManager::HighlightPath(TArray<FVector2D> PathPoints, bool bClearPrevio
 		{
 			// Force material application
 			Tile->StaticMeshComponent->SetMaterial(0, PathMaterial);
+			INC_DWORD_STAT(STAT_SaT_MaterialsSet);
+			SAT_TELEMETRY_ADD(TilesRematerialized, 1);
 			Tile->StaticMeshComponent->MarkRenderStateDirty();
 
 			PathTiles.Add(Tile);
@@ -528,26 +1145,37 @@ void AGridManager::DebugMaterials()
 
 void AGridManager::ClearAllHighlights()
 {
+	SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_HighlightCommit);
+
 	// Reset all highlighted tiles to their original material
 	for (ATile* Tile : HighlightedTiles)
 	{
-		if (Tile && DefaultTileMaterial)
+		UMaterialInterface* BaseMaterial = Tile ? GetBaseTileMaterial(Tile->GridX, Tile->GridY) : nullptr;
+		if (BaseMaterial)
 		{
-			Tile->StaticMeshComponent->SetMaterial(0, DefaultTileMaterial);
+			Tile->StaticMeshComponent->SetMaterial(0, BaseMaterial);
+			INC_DWORD_STAT(STAT_SaT_MaterialsSet);
+			SAT_TELEMETRY_ADD(TilesRematerialized, 1);
 		}
 	}
 
 	HighlightedTiles.Empty();
+	HighlightBoard.Reset();
 }
 
 void AGridManager::ClearPathHighlights()
 {
-	// Reset all path-highlighted tiles to their original material
+	SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_HighlightCommit);
+
+	// Reset all path-highlighted tiles to their original material, keeping the range highlight under a path preview
 	for (ATile* Tile : PathTiles)
 	{
 		if (Tile && Tile->StaticMeshComponent && DefaultTileMaterial)
 		{
-			Tile->StaticMeshComponent->SetMaterial(0, DefaultTileMaterial);
+			const bool bHighlighted = HighlightMaterial && HighlightBoard.Test(Tile->GridX, Tile->GridY);
+			Tile->StaticMeshComponent->SetMaterial(0, bHighlighted ? HighlightMaterial : GetBaseTileMaterial(Tile->GridX, Tile->GridY));
+			INC_DWORD_STAT(STAT_SaT_MaterialsSet);
+			SAT_TELEMETRY_ADD(TilesRematerialized, 1);
 		}
 		else
 		{
@@ -559,6 +1187,104 @@ void AGridManager::ClearPathHighlights()
 	PathTiles.Empty();
 }
 
+//----------------------------------------------
+// Terrain
+//----------------------------------------------
+
+uint8 AGridManager::GetTerrainCost(ETerrainType Terrain)
+{
+	switch (Terrain)
+	{
+	case ETerrainType::FOREST:
+		return 2;
+	case ETerrainType::HILL:
+		return 3;
+	default:
+		return 1;
+	}
+}
+
+ETerrainType AGridManager::GetCellTerrain(int32 GridX, int32 GridY) const
+{
+	const int32 Index = GridY * Size + GridX;
+	if (GridX < 0 || GridX >= Size || GridY < 0 || GridY >= Size || !TerrainMap.IsValidIndex(Index))
+	{
+		return ETerrainType::PLAIN;
+	}
+	return TerrainMap[Index];
+}
+
+void AGridManager::SetCellTerrain(int32 GridX, int32 GridY, ETerrainType Terrain)
+{
+	const int32 Index = GridY * Size + GridX;
+	if (GridX < 0 || GridX >= Size || GridY < 0 || GridY >= Size || !TerrainMap.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	const ETerrainType OldTerrain = TerrainMap[Index];
+	if (OldTerrain == Terrain)
+	{
+		return;
+	}
+
+	NumWeightedCells += (GetTerrainCost(Terrain) > 1 ? 1 : 0) - (GetTerrainCost(OldTerrain) > 1 ? 1 : 0);
+	TerrainMap[Index] = Terrain;
+
+	if (DistanceTable.IsBuilt() && GetTerrainCost(Terrain) != GetTerrainCost(OldTerrain))
+	{
+		bDistanceTableDirty = true;
+	}
+
+	// Obstacles and highlights keep their own material until they are cleared
+	ATile* Tile = TileMap.FindRef(FVector2D(GridX, GridY));
+	UMaterialInterface* BaseMaterial = GetBaseTileMaterial(GridX, GridY);
+	if (Tile && BaseMaterial && !Tile->bIsObstacle && !HighlightBoard.Test(GridX, GridY))
+	{
+		Tile->StaticMeshComponent->SetMaterial(0, BaseMaterial);
+		INC_DWORD_STAT(STAT_SaT_MaterialsSet);
+		SAT_TELEMETRY_ADD(TilesRematerialized, 1);
+	}
+
+	UpdateNavigationCell(GridX, GridY);
+}
+
+int32 AGridManager::GetMovementCost(int32 GridX, int32 GridY) const
+{
+	return GetTerrainCost(GetCellTerrain(GridX, GridY));
+}
+
+void AGridManager::GenerateTerrain()
+{
+	if (TerrainPercentage <= 0.0f)
+	{
+		return;
+	}
+
+	// Road, forest or hill on a share of the free cells; obstacles keep the plain terrain underneath
+	for (int32 Y = 0; Y < Size; Y++)
+	{
+		for (int32 X = 0; X < Size; X++)
+		{
+			ATile* Tile = TileMap.FindRef(FVector2D(X, Y));
+			if (!Tile || Tile->bIsObstacle || FMath::FRand() >= TerrainPercentage)
+			{
+				continue;
+			}
+
+			SetCellTerrain(X, Y, static_cast<ETerrainType>(FMath::RandRange(int32(ETerrainType::ROAD), int32(ETerrainType::HILL))));
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Generated terrain: %d of %d cells cost more than 1 to enter"), NumWeightedCells, Size * Size);
+}
+
+UMaterialInterface* AGridManager::GetBaseTileMaterial(int32 GridX, int32 GridY) const
+{
+	UMaterialInterface* TerrainMaterial = TerrainMaterials.FindRef(GetCellTerrain(GridX, GridY));
+	return TerrainMaterial ? TerrainMaterial : DefaultTileMaterial;
+}
+
 void AGridManager::GenerateObstacles()
 {
 	// Calculate how many obstacles to generate based on percentage
@@ -589,22 +1315,8 @@ void AGridManager::GenerateObstacles()
 		if (!Tile)
 			continue;
 
-		// Set as obstacle
-		Tile->bIsObstacle = true;
-
-		if (ObstacleMaterial)
-		{
-			Tile->StaticMeshComponent->SetMaterial(0, ObstacleMaterial);
-			UE_LOG(LogTemp, Warning, TEXT("Applied obstacle material to (%d,%d)"), RandomX, RandomY);
-		}
-		else
-		{
-			UE_LOG(LogTemp, Error, TEXT("ObstacleMaterial is NULL! Cannot visualize obstacle at (%d,%d)"),
-				RandomX, RandomY);
-		}
-
-		// Also mark as occupied so units can't move here
-		Tile->bIsOccupied = true;
+		// Set as obstacle (also marks it occupied so units can't move here)
+		SetCellObstacle(RandomX, RandomY, true);
 
 		PlacedObstacles++;
 	}
@@ -622,6 +1334,8 @@ void AGridManager::GenerateObstacles()
 				{
 					// Double-check material is applied
 					Tile->StaticMeshComponent->SetMaterial(0, ObstacleMaterial);
+					INC_DWORD_STAT(STAT_SaT_MaterialsSet);
+					SAT_TELEMETRY_ADD(TilesRematerialized, 1);
 				}
 			}
 		}
@@ -720,12 +1434,7 @@ bool AGridManager::RemoveObstacleToCreatePath(int32 UnreachableX, int32 Unreacha
 		ATile* Tile = TileMap[FVector2D(X, BestY)];
 		if (Tile && Tile->bIsObstacle)
 		{
-			Tile->bIsObstacle = false;
-			Tile->bIsOccupied = false;
-			if (DefaultTileMaterial)
-			{
-				Tile->StaticMeshComponent->SetMaterial(0, DefaultTileMaterial);
-			}
+			SetCellObstacle(X, BestY, false);
 			return true; 
 		}
 	}
@@ -736,12 +1445,7 @@ bool AGridManager::RemoveObstacleToCreatePath(int32 UnreachableX, int32 Unreacha
 		ATile* Tile = TileMap[FVector2D(UnreachableX, Y)];
 		if (Tile && Tile->bIsObstacle)
 		{
-			Tile->bIsObstacle = false;
-			Tile->bIsOccupied = false;
-			if (DefaultTileMaterial)
-			{
-				Tile->StaticMeshComponent->SetMaterial(0, DefaultTileMaterial);
-			}
+			SetCellObstacle(UnreachableX, Y, false);
 			return true; 
 		}
 	}
@@ -788,25 +1492,23 @@ bool AGridManager::EnsureGridConnectivity()
 	// If connectivity was improved, update the grid
 	if (bConnectivityImproved)
 	{
-		// Update obstacle status in tiles
+		// Update obstacle status in tiles; the influence map and sight tables are refreshed once for the batch
+		bDeferObstacleRefresh = true;
 		for (int32 x = 0; x < Size; x++)
 		{
 			for (int32 y = 0; y < Size; y++)
 			{
+				// Only the obstacles removed above change; SetCellObstacle updates flags,
+				// material and obstacle layer together so they no longer read as occupied
 				int32 Index = y * Size + x;
-				TileMap[FVector2D(x, y)]->bIsObstacle = ObstacleMap[Index];
-
-				// Update material if needed
-				if (ObstacleMap[Index] && ObstacleMaterial)
-				{
-					TileMap[FVector2D(x, y)]->StaticMeshComponent->SetMaterial(0, ObstacleMaterial);
-				}
-				else if (!ObstacleMap[Index] && DefaultTileMaterial)
+				if (TileMap[FVector2D(x, y)]->bIsObstacle != ObstacleMap[Index])
 				{
-					TileMap[FVector2D(x, y)]->StaticMeshComponent->SetMaterial(0, DefaultTileMaterial);
+					SetCellObstacle(x, y, ObstacleMap[Index]);
 				}
 			}
 		}
+		bDeferObstacleRefresh = false;
+		RefreshObstacleTables();
 		return true;
 	}
 
@@ -838,51 +1540,39 @@ int32 AGridManager::IdentifyRegions(const TArray<bool>& ObstacleMap, TArray<int3
 	return CurrentRegion - 1;
 }
 
-void AGridManager::FloodFillRegion(const TArray<bool>& ObstacleMap,
+int32 AGridManager::FloodFillRegion(const TArray<bool>& ObstacleMap,
 	TArray<int32>& RegionMap,
 	TArray<bool>& Visited,
 	int32 StartX, int32 StartY,
 	int32 RegionId)
 {
-	// Directions: up, right, down, left
-	int32 dx[] = { 0, 1, 0, -1 };
-	int32 dy[] = { -1, 0, 1, 0 };
-
-	// Queue for flood fill
-	TQueue<FVector2D> Queue;
-	Queue.Enqueue(FVector2D(StartX, StartY));
-
-	while (!Queue.IsEmpty())
+	// Word-parallel fill: grow the seed through free, unvisited cells one layer per pass
+	FGridBitboard Passable;
+	for (int32 Index = 0; Index < Size * Size; Index++)
 	{
-		FVector2D Current;
-		Queue.Dequeue(Current);
-
-		int32 x = FMath::FloorToInt(Current.X);
-		int32 y = FMath::FloorToInt(Current.Y);
-		int32 Index = y * Size + x;
+		if (!ObstacleMap[Index] && !Visited[Index])
+		{
+			Passable.Set(Index % Size, Index / Size);
+		}
+	}
 
-		// Skip if out of bounds, visited, or an obstacle
-		if (x < 0 || x >= Size || y < 0 || y >= Size ||
-			Visited[Index] || ObstacleMap[Index])
-			continue;
+	if (!Passable.Test(StartX, StartY))
+	{
+		return 0;
+	}
 
-		// Mark as visited and assign region
-		Visited[Index] = true;
-		RegionMap[Index] = RegionId;
+	FGridBitboard Seed;
+	Seed.Set(StartX, StartY);
+	const FGridBitboard Region = FGridBitboard::FloodFill(Seed, Passable);
 
-		// Explore adjacent cells
-		for (int32 i = 0; i < 4; i++)
+	Region.ForEachSetCell([&](int32 X, int32 Y)
 		{
-			int32 NewX = x + dx[i];
-			int32 NewY = y + dy[i];
+			const int32 Index = Y * Size + X;
+			Visited[Index] = true;
+			RegionMap[Index] = RegionId;
+		});
 
-			// Ensure new coordinates are in bounds
-			if (NewX >= 0 && NewX < Size && NewY >= 0 && NewY < Size)
-			{
-				Queue.Enqueue(FVector2D(NewX, NewY));
-			}
-		}
-	}
+	return Region.PopCount();
 }
 
 int32 AGridManager::FindLargestRegion(const TArray<int32>& RegionMap, int32 RegionCount)
@@ -0,0 +1,402 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridPathfinding.h"
+#include "GridDistanceTable.h"
+#include "Algo/Reverse.h"
+
+namespace
+{
+	// Grows a scratch buffer to the requested size, counting real reallocations
+	template <typename ElementType>
+	void PrepareScratch(TArray<ElementType>& Buffer, int32 Num, FGridSearchStats* Stats)
+	{
+		if (Buffer.Max() < Num && Stats)
+		{
+			Stats->ScratchAllocations++;
+		}
+		Buffer.SetNumUninitialized(Num, EAllowShrinking::No);
+	}
+}
+
+//----------------------------------------------
+// Bucket Queue
+//----------------------------------------------
+
+void FGridBucketQueue::Reset(int32 MaxIncrease, int32 FirstPriority)
+{
+	NumBuckets = FMath::Max(1, MaxIncrease + 1);
+	if (Buckets.Num() < NumBuckets)
+	{
+		Buckets.SetNum(NumBuckets);
+	}
+
+	for (int32 i = 0; i < NumBuckets; i++)
+	{
+		Buckets[i].Reset();
+	}
+
+	CurrentPriority = FirstPriority;
+	Count = 0;
+}
+
+bool FGridBucketQueue::Pop(int32& OutPriority, int32& OutIndex)
+{
+	if (Count == 0)
+	{
+		return false;
+	}
+
+	// Every queued priority lies in [CurrentPriority, CurrentPriority + NumBuckets), so this stops within one lap
+	TArray<int32>* Bucket = &Buckets[CurrentPriority % NumBuckets];
+	while (Bucket->Num() == 0)
+	{
+		CurrentPriority++;
+		Bucket = &Buckets[CurrentPriority % NumBuckets];
+	}
+
+	OutPriority = CurrentPriority;
+	OutIndex = Bucket->Pop(EAllowShrinking::No);
+	Count--;
+	return true;
+}
+
+SIZE_T FGridBucketQueue::GetAllocatedSize() const
+{
+	SIZE_T Bytes = Buckets.GetAllocatedSize();
+	for (const TArray<int32>& Bucket : Buckets)
+	{
+		Bytes += Bucket.GetAllocatedSize();
+	}
+	return Bytes;
+}
+
+//----------------------------------------------
+// Distance Field
+//----------------------------------------------
+
+int32 FGridDistanceField::GetDistanceToNeighbourOf(int32 X, int32 Y) const
+{
+	int32 dx[] = { 1, -1, 0, 0 };
+	int32 dy[] = { 0, 0, 1, -1 };
+
+	int32 Best = Unreachable;
+	for (int32 i = 0; i < 4; i++)
+	{
+		Best = FMath::Min(Best, GetDistance(X + dx[i], Y + dy[i]));
+	}
+	return Best;
+}
+
+bool FGridDistanceField::GetPathTo(int32 X, int32 Y, TArray<FVector2D>& OutPath) const
+{
+	OutPath.Reset();
+
+	if (!IsReachable(X, Y))
+	{
+		return false;
+	}
+
+	// Walk the parents back to the source, then flip the order
+	for (int32 Index = Y * Size + X; Index != INDEX_NONE; Index = Parent[Index])
+	{
+		OutPath.Add(FVector2D(Index % Size, Index / Size));
+	}
+
+	Algo::Reverse(OutPath);
+	return true;
+}
+
+//----------------------------------------------
+// Searches
+//----------------------------------------------
+
+void FGridPathfinding::ComputeDistanceField(const FGridSearchGrid& Grid, TArrayView<const FIntPoint> Sources,
+	FGridDistanceField& OutField, int32 MaxDistance, FGridSearchStats* Stats)
+{
+	const int32 NumCells = Grid.Size * Grid.Size;
+
+	OutField.Size = Grid.Size;
+	PrepareScratch(OutField.Distance, NumCells, Stats);
+	PrepareScratch(OutField.Parent, NumCells, Stats);
+	PrepareScratch(OutField.Frontier, NumCells, Stats);
+
+	for (int32 Index = 0; Index < NumCells; Index++)
+	{
+		OutField.Distance[Index] = FGridDistanceField::Unreachable;
+		OutField.Parent[Index] = INDEX_NONE;
+	}
+
+	const uint8 MaxStepCost = Grid.GetMaxStepCost();
+	if (MaxStepCost > 1)
+	{
+		ComputeWeightedDistanceField(Grid, Sources, OutField, MaxStepCost, MaxDistance, Stats);
+		return;
+	}
+
+	// The frontier is a flat FIFO: every cell is pushed at most once, so NumCells slots are enough
+	int32 Head = 0;
+	int32 Tail = 0;
+
+	for (const FIntPoint& Source : Sources)
+	{
+		if (!Grid.IsValidCell(Source.X, Source.Y))
+		{
+			continue;
+		}
+
+		const int32 Index = Grid.ToIndex(Source.X, Source.Y);
+		if (OutField.Distance[Index] != 0)
+		{
+			OutField.Distance[Index] = 0;
+			OutField.Frontier[Tail++] = Index;
+		}
+	}
+
+	int32 dx[] = { 1, -1, 0, 0 };
+	int32 dy[] = { 0, 0, 1, -1 };
+
+	while (Head < Tail)
+	{
+		const int32 Current = OutField.Frontier[Head++];
+		const int32 CurrentDistance = OutField.Distance[Current];
+
+		if (Stats)
+		{
+			Stats->NodesExpanded++;
+		}
+
+		if (CurrentDistance >= MaxDistance)
+		{
+			continue;
+		}
+
+		const int32 CurrentX = Current % Grid.Size;
+		const int32 CurrentY = Current / Grid.Size;
+
+		for (int32 i = 0; i < 4; i++)
+		{
+			const int32 NewX = CurrentX + dx[i];
+			const int32 NewY = CurrentY + dy[i];
+			if (!Grid.IsValidCell(NewX, NewY))
+			{
+				continue;
+			}
+
+			const int32 Neighbour = Grid.ToIndex(NewX, NewY);
+			if (!Grid.IsPassable(Neighbour) || OutField.Distance[Neighbour] != FGridDistanceField::Unreachable)
+			{
+				continue;
+			}
+
+			OutField.Distance[Neighbour] = CurrentDistance + 1;
+			OutField.Parent[Neighbour] = Current;
+			OutField.Frontier[Tail++] = Neighbour;
+		}
+	}
+}
+
+void FGridPathfinding::ComputeWeightedDistanceField(const FGridSearchGrid& Grid, TArrayView<const FIntPoint> Sources,
+	FGridDistanceField& OutField, uint8 MaxStepCost, int32 MaxDistance, FGridSearchStats* Stats)
+{
+	const SIZE_T QueueBytes = OutField.Buckets.GetAllocatedSize();
+	OutField.Buckets.Reset(MaxStepCost);
+
+	for (const FIntPoint& Source : Sources)
+	{
+		if (!Grid.IsValidCell(Source.X, Source.Y))
+		{
+			continue;
+		}
+
+		const int32 Index = Grid.ToIndex(Source.X, Source.Y);
+		if (OutField.Distance[Index] != 0)
+		{
+			OutField.Distance[Index] = 0;
+			OutField.Buckets.Push(0, Index);
+		}
+	}
+
+	int32 dx[] = { 1, -1, 0, 0 };
+	int32 dy[] = { 0, 0, 1, -1 };
+
+	int32 CurrentDistance = 0;
+	int32 Current = INDEX_NONE;
+	while (OutField.Buckets.Pop(CurrentDistance, Current))
+	{
+		// Skip entries left behind by a later improvement
+		if (CurrentDistance != OutField.Distance[Current])
+		{
+			continue;
+		}
+
+		if (Stats)
+		{
+			Stats->NodesExpanded++;
+		}
+
+		const int32 CurrentX = Current % Grid.Size;
+		const int32 CurrentY = Current / Grid.Size;
+
+		for (int32 i = 0; i < 4; i++)
+		{
+			const int32 NewX = CurrentX + dx[i];
+			const int32 NewY = CurrentY + dy[i];
+			if (!Grid.IsValidCell(NewX, NewY))
+			{
+				continue;
+			}
+
+			const int32 Neighbour = Grid.ToIndex(NewX, NewY);
+			if (!Grid.IsPassable(Neighbour))
+			{
+				continue;
+			}
+
+			// Cells past the limit stay Unreachable, as in the unit-cost sweep
+			const int32 NewDistance = CurrentDistance + Grid.StepCost[Neighbour];
+			if (NewDistance > MaxDistance || NewDistance >= OutField.Distance[Neighbour])
+			{
+				continue;
+			}
+
+			OutField.Distance[Neighbour] = NewDistance;
+			OutField.Parent[Neighbour] = Current;
+			OutField.Buckets.Push(NewDistance, Neighbour);
+		}
+	}
+
+	if (Stats && OutField.Buckets.GetAllocatedSize() > QueueBytes)
+	{
+		Stats->ScratchAllocations++;
+	}
+}
+
+void FGridPathfinding::ComputeDistanceField(const FGridSearchGrid& Grid, int32 SourceX, int32 SourceY,
+	FGridDistanceField& OutField, int32 MaxDistance, FGridSearchStats* Stats)
+{
+	const FIntPoint Source(SourceX, SourceY);
+	ComputeDistanceField(Grid, MakeArrayView(&Source, 1), OutField, MaxDistance, Stats);
+}
+
+bool FGridPathfinding::FindPath(const FGridSearchGrid& Grid, int32 StartX, int32 StartY, int32 GoalX, int32 GoalY,
+	TArray<FVector2D>& OutPath, FGridDistanceField& Scratch, FGridSearchStats* Stats, const FGridDistanceTable* HeuristicTable)
+{
+	OutPath.Reset();
+
+	if (!Grid.IsValidCell(StartX, StartY) || !Grid.IsValidCell(GoalX, GoalY))
+	{
+		return false;
+	}
+
+	const int32 Start = Grid.ToIndex(StartX, StartY);
+	const int32 Goal = Grid.ToIndex(GoalX, GoalY);
+	if (Start != Goal && !Grid.IsPassable(Goal))
+	{
+		return false;
+	}
+
+	const int32 NumCells = Grid.Size * Grid.Size;
+
+	// Distance holds the best known cost so far, Parent the way back
+	Scratch.Size = Grid.Size;
+	PrepareScratch(Scratch.Distance, NumCells, Stats);
+	PrepareScratch(Scratch.Parent, NumCells, Stats);
+	for (int32 Index = 0; Index < NumCells; Index++)
+	{
+		Scratch.Distance[Index] = FGridDistanceField::Unreachable;
+		Scratch.Parent[Index] = INDEX_NONE;
+	}
+
+	// The table only helps if it was built for this grid
+	const uint8* GoalColumn = nullptr;
+	const int32 TableStride = NumCells;
+	if (HeuristicTable && HeuristicTable->IsBuilt() && HeuristicTable->GetSize() == Grid.Size)
+	{
+		// Cut off from the goal even without units in the way
+		if (HeuristicTable->GetEntry(Start, Goal) == FGridDistanceTable::UnreachableEntry)
+		{
+			return false;
+		}
+		GoalColumn = HeuristicTable->GetColumn(Goal);
+	}
+
+	auto Heuristic = [GoalX, GoalY, GoalColumn, TableStride, &Grid](int32 Index)
+		{
+			if (GoalColumn)
+			{
+				return int32(GoalColumn[Index * TableStride]);
+			}
+			return FMath::Abs(Index % Grid.Size - GoalX) + FMath::Abs(Index / Grid.Size - GoalY);
+		};
+
+	// Both heuristics are consistent, so a priority never drops below the popped one; a step raises it by at most
+	// the step cost plus 1 with Manhattan, or plus the static cost of the cell left behind with the table
+	const SIZE_T QueueBytes = Scratch.Buckets.GetAllocatedSize();
+	const int32 MaxStepCost = Grid.GetMaxStepCost();
+	Scratch.Buckets.Reset(MaxStepCost + (GoalColumn ? HeuristicTable->GetMaxStepCost() : 1), Heuristic(Start));
+
+	Scratch.Distance[Start] = 0;
+	Scratch.Buckets.Push(Heuristic(Start), Start);
+
+	int32 dx[] = { 1, -1, 0, 0 };
+	int32 dy[] = { 0, 0, 1, -1 };
+
+	bool bFound = false;
+	int32 Priority = 0;
+	int32 CurrentIndex = INDEX_NONE;
+	while (Scratch.Buckets.Pop(Priority, CurrentIndex))
+	{
+		// Skip entries left behind by a later improvement
+		const int32 CurrentCost = Scratch.Distance[CurrentIndex];
+		if (Priority != CurrentCost + Heuristic(CurrentIndex))
+		{
+			continue;
+		}
+
+		if (Stats)
+		{
+			Stats->NodesExpanded++;
+		}
+
+		if (CurrentIndex == Goal)
+		{
+			bFound = true;
+			break;
+		}
+
+		const int32 CurrentX = CurrentIndex % Grid.Size;
+		const int32 CurrentY = CurrentIndex / Grid.Size;
+
+		for (int32 i = 0; i < 4; i++)
+		{
+			const int32 NewX = CurrentX + dx[i];
+			const int32 NewY = CurrentY + dy[i];
+			if (!Grid.IsValidCell(NewX, NewY))
+			{
+				continue;
+			}
+
+			const int32 Neighbour = Grid.ToIndex(NewX, NewY);
+			if (!Grid.IsPassable(Neighbour) || (GoalColumn && GoalColumn[Neighbour * TableStride] == FGridDistanceTable::UnreachableEntry))
+			{
+				continue;
+			}
+
+			const int32 NewCost = CurrentCost + Grid.StepCost[Neighbour];
+			if (NewCost < Scratch.Distance[Neighbour])
+			{
+				Scratch.Distance[Neighbour] = NewCost;
+				Scratch.Parent[Neighbour] = CurrentIndex;
+				Scratch.Buckets.Push(NewCost + Heuristic(Neighbour), Neighbour);
+			}
+		}
+	}
+
+	if (Stats && Scratch.Buckets.GetAllocatedSize() > QueueBytes)
+	{
+		Stats->ScratchAllocations++;
+	}
+
+	return bFound && Scratch.GetPathTo(GoalX, GoalY, OutPath);
+}
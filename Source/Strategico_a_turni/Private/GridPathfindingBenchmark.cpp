@@ -0,0 +1,338 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridPathfindingBenchmark.h"
+#include "GridBitboard.h"
+#include "GridPathfinding.h"
+#include "GridDistanceTable.h"
+#include "GridHierarchicalPathfinder.h"
+#include "GridManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+	// Cluster size of the hierarchical pathfinder cases
+	constexpr int32 BenchmarkClusterSize = 32;
+
+	// Movement of the Brawler, the widest movement range shown to the player
+	constexpr int32 BenchmarkMovementRange = 6;
+
+	// Obstacles first, then terrain painted on a share of the free cells, as the grid manager generates its field
+	void MakeBoard(int32 Size, float Density, float TerrainShare, FRandomStream& Stream, FGridSearchGrid& OutGrid)
+	{
+		OutGrid.Init(Size, 1);
+		for (uint8& Cost : OutGrid.StepCost)
+		{
+			Cost = Stream.FRand() < Density ? 0 : 1;
+			if (Cost != 0 && Stream.FRand() < TerrainShare)
+			{
+				Cost = AGridManager::GetTerrainCost(static_cast<ETerrainType>(Stream.RandRange(int32(ETerrainType::ROAD), int32(ETerrainType::HILL))));
+			}
+		}
+	}
+
+	bool HasWeightedCells(const FGridSearchGrid& Grid)
+	{
+		for (uint8 Cost : Grid.StepCost)
+		{
+			if (Cost > 1)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	FIntPoint PickPassableCell(const FGridSearchGrid& Grid, FRandomStream& Stream)
+	{
+		for (int32 Attempt = 0; Attempt < 1000; Attempt++)
+		{
+			const int32 X = Stream.RandRange(0, Grid.Size - 1);
+			const int32 Y = Stream.RandRange(0, Grid.Size - 1);
+			if (Grid.IsPassable(Grid.ToIndex(X, Y)))
+			{
+				return FIntPoint(X, Y);
+			}
+		}
+		return FIntPoint(0, 0);
+	}
+
+	FGridBitboard MakePassableBoard(const FGridSearchGrid& Grid)
+	{
+		FGridBitboard Passable;
+		for (int32 Y = 0; Y < Grid.Size; Y++)
+		{
+			for (int32 X = 0; X < Grid.Size; X++)
+			{
+				if (Grid.IsPassable(Grid.ToIndex(X, Y)))
+				{
+					Passable.Set(X, Y);
+				}
+			}
+		}
+		return Passable;
+	}
+
+	// Runs one warm-up query, then times QueriesPerCase more; Query receives the stats to fill
+	template <typename QueryType>
+	FGridBenchmarkResult MeasureCase(const TCHAR* Name, const TCHAR* EntryPoint, int32 Size, float Density, int32 NumQueries, QueryType&& Query)
+	{
+		FGridSearchStats Stats;
+		Query(Stats);
+
+		TArray<double> Micros;
+		Micros.Reserve(NumQueries);
+
+		int64 TotalNodes = 0;
+		int64 TotalAllocations = 0;
+		for (int32 i = 0; i < NumQueries; i++)
+		{
+			Stats.Reset();
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			Query(Stats);
+			const uint64 EndCycles = FPlatformTime::Cycles64();
+
+			Micros.Add(FPlatformTime::ToMilliseconds64(EndCycles - StartCycles) * 1000.0);
+			TotalNodes += Stats.NodesExpanded;
+			TotalAllocations += Stats.ScratchAllocations;
+		}
+
+		Micros.Sort();
+
+		FGridBenchmarkResult Result;
+		Result.Query = Name;
+		Result.EntryPoint = EntryPoint;
+		Result.Size = Size;
+		Result.Density = Density;
+		Result.Queries = NumQueries;
+		if (NumQueries > 0)
+		{
+			Result.P50Micros = Micros[FMath::Min(NumQueries - 1, NumQueries / 2)];
+			Result.P99Micros = Micros[FMath::Min(NumQueries - 1, NumQueries * 99 / 100)];
+			Result.NodesExpanded = double(TotalNodes) / NumQueries;
+			Result.ScratchAllocations = double(TotalAllocations) / NumQueries;
+		}
+		return Result;
+	}
+}
+
+//----------------------------------------------
+// Running
+//----------------------------------------------
+
+void FGridPathfindingBenchmark::Run(const FGridBenchmarkSettings& Settings, TArray<FGridBenchmarkResult>& OutResults)
+{
+	OutResults.Reset();
+
+	for (int32 Size : Settings.Sizes)
+	{
+		if (Size <= 1)
+		{
+			continue;
+		}
+
+		for (float Density : Settings.Densities)
+		{
+			// Every board gets its own stream so adding a size or density does not change the others
+			FRandomStream Stream(HashCombine(HashCombine(GetTypeHash(Settings.Seed), GetTypeHash(Size)), GetTypeHash(Density)));
+
+			FGridSearchGrid Grid;
+			MakeBoard(Size, Density, Settings.TerrainShare, Stream, Grid);
+
+			// Query cells are drawn up front so picking them stays out of the timings
+			TArray<FIntPoint> Cells;
+			Cells.Reserve(1024);
+			for (int32 i = 0; i < 1024; i++)
+			{
+				Cells.Add(PickPassableCell(Grid, Stream));
+			}
+			int32 NextCellIndex = 0;
+			auto NextCell = [&Cells, &NextCellIndex]() { return Cells[NextCellIndex++ % Cells.Num()]; };
+
+			// Only the game's board makes the same calls as the game; the other sizes time the bare searches
+			const bool bGameBoard = Size == FGridBitboard::Stride;
+			auto EntryPoint = [bGameBoard](const TCHAR* Name) { return bGameBoard ? Name : TEXT(""); };
+
+			FGridDistanceField Field;
+			FGridDistanceField MoveTree;
+			TArray<FVector2D> Path;
+
+			// ASaT_RandomPlayer::ComputeDistancesFrom: one unbounded sweep from the AI unit
+			OutResults.Add(MeasureCase(TEXT("DistanceSweep"), EntryPoint(TEXT("MoveTowardPlayerUnit")), Size, Density, Settings.QueriesPerCase,
+				[&](FGridSearchStats& Stats)
+				{
+					const FIntPoint Source = NextCell();
+					FGridPathfinding::ComputeDistanceField(Grid, Source.X, Source.Y, Field, MAX_int32, &Stats);
+				}));
+
+			// A* without a heuristic table, on any board
+			OutResults.Add(MeasureCase(TEXT("AStar"), TEXT(""), Size, Density, Settings.QueriesPerCase,
+				[&](FGridSearchStats& Stats)
+				{
+					const FIntPoint Start = NextCell();
+					const FIntPoint Goal = NextCell();
+					FGridPathfinding::FindPath(Grid, Start.X, Start.Y, Goal.X, Goal.Y, Path, Field, &Stats);
+				}));
+
+			// AGridManager::RebuildDistanceTable and FindPath: the table is built once per field and is A*'s heuristic
+			FGridDistanceTable Table;
+			if (Size * Size <= FGridDistanceTable::MaxCells)
+			{
+				OutResults.Add(MeasureCase(TEXT("DistanceTableBuild"), EntryPoint(TEXT("RebuildDistanceTable")), Size, Density, 1,
+					[&](FGridSearchStats& Stats)
+					{
+						Table.Build(Grid);
+					}));
+
+				OutResults.Add(MeasureCase(TEXT("AStarDistanceTable"), EntryPoint(TEXT("CalculatePath")), Size, Density, Settings.QueriesPerCase,
+					[&](FGridSearchStats& Stats)
+					{
+						const FIntPoint Start = NextCell();
+						const FIntPoint Goal = NextCell();
+						FGridPathfinding::FindPath(Grid, Start.X, Start.Y, Goal.X, Goal.Y, Path, Field, &Stats, &Table);
+					}));
+			}
+
+			// The game never searches hierarchically; these only show where HPA* would pay off
+			if (Size >= BenchmarkClusterSize * 2)
+			{
+				FGridHierarchicalPathfinder Hierarchical;
+				OutResults.Add(MeasureCase(TEXT("HierarchicalBuild"), TEXT(""), Size, Density, 1,
+					[&](FGridSearchStats& Stats)
+					{
+						Hierarchical.Build(&Grid, BenchmarkClusterSize);
+					}));
+
+				OutResults.Add(MeasureCase(TEXT("Hierarchical"), TEXT(""), Size, Density, Settings.QueriesPerCase,
+					[&](FGridSearchStats& Stats)
+					{
+						const FIntPoint Start = NextCell();
+						const FIntPoint Goal = NextCell();
+						Hierarchical.FindPath(Start.X, Start.Y, Goal.X, Goal.Y, Path, &Stats);
+					}));
+
+				// One cell blocked: its cluster goes dirty and is rebuilt by the next query
+				OutResults.Add(MeasureCase(TEXT("HierarchicalAfterEdit"), TEXT(""), Size, Density, Settings.QueriesPerCase,
+					[&](FGridSearchStats& Stats)
+					{
+						const FIntPoint Edited = NextCell();
+						const uint8 EditedCost = Grid.StepCost[Grid.ToIndex(Edited.X, Edited.Y)];
+						Grid.StepCost[Grid.ToIndex(Edited.X, Edited.Y)] = 0;
+						Hierarchical.NotifyCellChanged(Edited.X, Edited.Y);
+
+						const FIntPoint Start = NextCell();
+						const FIntPoint Goal = NextCell();
+						Hierarchical.FindPath(Start.X, Start.Y, Goal.X, Goal.Y, Path, &Stats);
+
+						Grid.StepCost[Grid.ToIndex(Edited.X, Edited.Y)] = EditedCost;
+						Hierarchical.NotifyCellChanged(Edited.X, Edited.Y);
+					}));
+			}
+
+			// The bitboard queries only exist for boards that fit a bitboard
+			if (Size <= FGridBitboard::Stride)
+			{
+				const FGridBitboard Passable = MakePassableBoard(Grid);
+				const bool bWeighted = HasWeightedCells(Grid);
+
+				// AGridManager::GetReachableCells, then ASaT_HumanPlayer::BuildMoveTree for the path preview
+				OutResults.Add(MeasureCase(bWeighted ? TEXT("WeightedReach") : TEXT("ReachableWithin"), EntryPoint(TEXT("ShowMovementRange")),
+					Size, Density, Settings.QueriesPerCase,
+					[&](FGridSearchStats& Stats)
+					{
+						const FIntPoint Source = NextCell();
+						FGridBitboard Reach;
+						if (bWeighted)
+						{
+							// Step counts no longer match movement costs, so the game sweeps the costs
+							FGridPathfinding::ComputeDistanceField(Grid, Source.X, Source.Y, Field, BenchmarkMovementRange, &Stats);
+							for (int32 Index = 0; Index < Field.Distance.Num(); Index++)
+							{
+								const int32 Cost = Field.Distance[Index];
+								if (Cost > 0 && Cost <= BenchmarkMovementRange)
+								{
+									Reach.Set(Index % Size, Index / Size);
+								}
+							}
+						}
+						else
+						{
+							FGridBitboard Start;
+							Start.Set(Source.X, Source.Y);
+							Reach = FGridBitboard::ReachableWithin(Start, BenchmarkMovementRange, Passable);
+							Reach.AndNot(Start);
+						}
+						(void)Reach;
+
+						FGridPathfinding::ComputeDistanceField(Grid, Source.X, Source.Y, MoveTree, BenchmarkMovementRange, &Stats);
+					}));
+
+				// AGridManager::FloodFillRegion, called by EnsureGridConnectivity for every region it finds
+				TArray<bool> ObstacleMap;
+				ObstacleMap.SetNumUninitialized(Size * Size);
+				for (int32 Index = 0; Index < Size * Size; Index++)
+				{
+					ObstacleMap[Index] = !Grid.IsPassable(Index);
+				}
+				TArray<bool> Visited;
+				TArray<int32> RegionMap;
+				RegionMap.SetNumZeroed(Size * Size);
+
+				OutResults.Add(MeasureCase(TEXT("FloodFill"), EntryPoint(TEXT("EnsureGridConnectivity")), Size, Density, Settings.QueriesPerCase,
+					[&](FGridSearchStats& Stats)
+					{
+						Visited.Init(false, Size * Size);
+
+						const FIntPoint Source = NextCell();
+						FGridBitboard RegionPassable;
+						for (int32 Index = 0; Index < Size * Size; Index++)
+						{
+							if (!ObstacleMap[Index] && !Visited[Index])
+							{
+								RegionPassable.Set(Index % Size, Index / Size);
+							}
+						}
+
+						FGridBitboard Seed;
+						Seed.Set(Source.X, Source.Y);
+						FGridBitboard::FloodFill(Seed, RegionPassable).ForEachSetCell([&](int32 X, int32 Y)
+							{
+								Visited[Y * Size + X] = true;
+								RegionMap[Y * Size + X] = 1;
+							});
+					}));
+			}
+		}
+	}
+}
+
+//----------------------------------------------
+// Reporting
+//----------------------------------------------
+
+void FGridPathfindingBenchmark::LogResults(const TArray<FGridBenchmarkResult>& Results)
+{
+	UE_LOG(LogTemp, Display, TEXT("%-22s %-28s %5s %7s %7s %11s %11s %11s %8s"),
+		TEXT("Query"), TEXT("Entry point"), TEXT("Size"), TEXT("Density"), TEXT("Queries"),
+		TEXT("p50 (us)"), TEXT("p99 (us)"), TEXT("Nodes"), TEXT("Allocs"));
+
+	for (const FGridBenchmarkResult& Result : Results)
+	{
+		UE_LOG(LogTemp, Display, TEXT("%-22s %-28s %5d %7.2f %7d %11.2f %11.2f %11.1f %8.3f"),
+			*Result.Query, Result.EntryPoint.IsEmpty() ? TEXT("-") : *Result.EntryPoint, Result.Size, Result.Density, Result.Queries,
+			Result.P50Micros, Result.P99Micros, Result.NodesExpanded, Result.ScratchAllocations);
+	}
+}
+
+FString FGridPathfindingBenchmark::ToCSV(const TArray<FGridBenchmarkResult>& Results)
+{
+	FString CSV = TEXT("Query,EntryPoint,Size,Density,Queries,P50Micros,P99Micros,NodesExpanded,ScratchAllocations\n");
+	for (const FGridBenchmarkResult& Result : Results)
+	{
+		CSV += FString::Printf(TEXT("%s,%s,%d,%.2f,%d,%.3f,%.3f,%.2f,%.4f\n"),
+			*Result.Query, *Result.EntryPoint, Result.Size, Result.Density, Result.Queries,
+			Result.P50Micros, Result.P99Micros, Result.NodesExpanded, Result.ScratchAllocations);
+	}
+	return CSV;
+}
@@ -0,0 +1,160 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridPlacementScorer.h"
+#include "GridPathfinding.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	/** Score lost per point of expected enemy damage next turn */
+	constexpr float ThreatWeight = 1.0f;
+
+	/** Score lost per cell of path distance away from the ideal distance to the nearest enemy */
+	constexpr float EngageWeight = 0.5f;
+
+	/** Score lost by a cell the enemy cannot reach at all, nor the unit it */
+	constexpr float CutOffPenalty = 20.0f;
+
+	/** Score lost per cell an ally is farther than SupportDistance */
+	constexpr float SupportWeight = 0.25f;
+	constexpr int32 SupportDistance = 4;
+
+	/** Ranged units gain this per blocked side (cover in a choke point), melee units this times their reach ratio */
+	constexpr float CoverWeight = 0.75f;
+	constexpr float MobilityWeight = 3.0f;
+
+	/** Number of cells within a Manhattan radius, the centre excluded */
+	int32 GetDiamondArea(int32 Radius)
+	{
+		return 2 * Radius * (Radius + 1);
+	}
+}
+
+bool FGridPlacementScorer::FindBestCell(const FGridSearchGrid& Grid, const FGridPlacementRequest& Request, int32& OutGridX, int32& OutGridY, float* OutScore)
+{
+	const int32 NumCells = Grid.Size * Grid.Size;
+
+	TArray<int32> Candidates;
+	for (int32 Index = 0; Index < NumCells; Index++)
+	{
+		if (Grid.IsPassable(Index))
+		{
+			Candidates.Add(Index);
+		}
+	}
+	if (Candidates.Num() == 0)
+	{
+		return false;
+	}
+
+	// One multi-source sweep per side gives the path distance of every cell to the nearest unit of that side
+	auto ComputeSideDistances = [&Grid](const TArray<FGridPlacementUnit>& Units, FGridDistanceField& OutField)
+	{
+		TArray<FIntPoint> Sources;
+		for (const FGridPlacementUnit& Unit : Units)
+		{
+			Sources.Add(FIntPoint(Unit.GridX, Unit.GridY));
+		}
+		FGridPathfinding::ComputeDistanceField(Grid, Sources, OutField);
+	};
+
+	FGridDistanceField EnemyField;
+	FGridDistanceField AllyField;
+	ComputeSideDistances(Request.Enemies, EnemyField);
+	ComputeSideDistances(Request.Allies, AllyField);
+
+	// Mobility needs a bounded sweep per cell: spread the cells over the workers, each with its own field
+	TArray<float> Scores;
+	Scores.SetNumUninitialized(Candidates.Num());
+	TArray<FGridDistanceField> Fields;
+	ParallelForWithTaskContext(Fields, Candidates.Num(), [&](FGridDistanceField& Field, int32 CandidateIndex)
+		{
+			const int32 Index = Candidates[CandidateIndex];
+			const int32 X = Index % Grid.Size;
+			const int32 Y = Index / Grid.Size;
+
+			FGridPathfinding::ComputeDistanceField(Grid, X, Y, Field, Request.Movement);
+			int32 ReachableCells = -1;
+			for (const int32 Distance : Field.Distance)
+			{
+				ReachableCells += Distance != FGridDistanceField::Unreachable ? 1 : 0;
+			}
+
+			Scores[CandidateIndex] = ScoreCell(Grid, Request, Index, EnemyField.Distance[Index], AllyField.Distance[Index], ReachableCells);
+		});
+
+	// Reduced in cell order so the result does not depend on how the work was split
+	int32 BestCandidate = 0;
+	for (int32 CandidateIndex = 1; CandidateIndex < Candidates.Num(); CandidateIndex++)
+	{
+		if (Scores[CandidateIndex] > Scores[BestCandidate])
+		{
+			BestCandidate = CandidateIndex;
+		}
+	}
+
+	OutGridX = Candidates[BestCandidate] % Grid.Size;
+	OutGridY = Candidates[BestCandidate] / Grid.Size;
+	if (OutScore)
+	{
+		*OutScore = Scores[BestCandidate];
+	}
+	return true;
+}
+
+float FGridPlacementScorer::ScoreCell(const FGridSearchGrid& Grid, const FGridPlacementRequest& Request, int32 Index,
+	int32 EnemyDistance, int32 AllyDistance, int32 ReachableCells)
+{
+	const bool bRanged = Request.Range > 1;
+	float Score = 0.0f;
+
+	if (Request.Threat.IsValidIndex(Index))
+	{
+		Score -= ThreatWeight * Request.Threat[Index];
+	}
+
+	// Ranged units stay one move out of their own range, melee units one step out of reach
+	if (Request.Enemies.Num() > 0)
+	{
+		if (EnemyDistance == FGridDistanceField::Unreachable)
+		{
+			Score -= CutOffPenalty;
+		}
+		else
+		{
+			const int32 IdealDistance = bRanged ? Request.Range + Request.Movement : Request.Movement + 1;
+			Score -= EngageWeight * FMath::Abs(EnemyDistance - IdealDistance);
+		}
+	}
+
+	if (Request.Allies.Num() > 0)
+	{
+		const int32 Distance = AllyDistance == FGridDistanceField::Unreachable ? Grid.Size * 2 : AllyDistance;
+		Score -= SupportWeight * FMath::Max(0, Distance - SupportDistance);
+	}
+
+	// Choke points: a ranged unit likes the cover of blocked sides, a melee unit the room to manoeuvre
+	if (bRanged)
+	{
+		const int32 X = Index % Grid.Size;
+		const int32 Y = Index / Grid.Size;
+		const FIntPoint Sides[] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+		int32 BlockedSides = 0;
+		for (const FIntPoint& Side : Sides)
+		{
+			const int32 SideX = X + Side.X;
+			const int32 SideY = Y + Side.Y;
+			BlockedSides += (!Grid.IsValidCell(SideX, SideY) || !Grid.IsPassable(Grid.ToIndex(SideX, SideY))) ? 1 : 0;
+		}
+
+		// A fully enclosed cell is a trap, not cover
+		Score += CoverWeight * FMath::Min(BlockedSides, 2);
+	}
+	else if (Request.Movement > 0)
+	{
+		Score += MobilityWeight * float(ReachableCells) / GetDiamondArea(Request.Movement);
+	}
+
+	return Score;
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_AttackPreviewWidget.h"
+#include "SaT_HumanPlayer.h"
+#include "Unit.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/Border.h"
+#include "Components/CanvasPanel.h"
+#include "Components/CanvasPanelSlot.h"
+#include "Components/TextBlock.h"
+
+void USaT_AttackPreviewWidget::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+
+	if (WidgetTree && !WidgetTree->RootWidget)
+	{
+		UCanvasPanel* Canvas = WidgetTree->ConstructWidget<UCanvasPanel>(UCanvasPanel::StaticClass(), TEXT("Canvas"));
+		WidgetTree->RootWidget = Canvas;
+
+		UBorder* Background = WidgetTree->ConstructWidget<UBorder>(UBorder::StaticClass(), TEXT("Background"));
+		Background->SetBrushColor(FLinearColor(0.0f, 0.0f, 0.0f, 0.6f));
+		Background->SetPadding(FMargin(12.0f, 8.0f));
+
+		UTextBlock* Text = WidgetTree->ConstructWidget<UTextBlock>(UTextBlock::StaticClass(), TEXT("PreviewText"));
+		Text->SetColorAndOpacity(FSlateColor(FLinearColor::White));
+		Text->SetJustification(ETextJustify::Center);
+		Background->SetContent(Text);
+
+		// Bottom centre, sized to the text
+		if (UCanvasPanelSlot* PanelSlot = Canvas->AddChildToCanvas(Background))
+		{
+			PanelSlot->SetAnchors(FAnchors(0.5f, 1.0f));
+			PanelSlot->SetAlignment(FVector2D(0.5f, 1.0f));
+			PanelSlot->SetPosition(FVector2D(0.0f, -140.0f));
+			PanelSlot->SetAutoSize(true);
+		}
+	}
+
+	if (WidgetTree)
+	{
+		PreviewText = WidgetTree->FindWidget<UTextBlock>(TEXT("PreviewText"));
+	}
+}
+
+void USaT_AttackPreviewWidget::SetPreview(const FSaTAttackPreview& Preview)
+{
+	if (!PreviewText)
+	{
+		return;
+	}
+
+	PreviewText->SetText(FText::FromString(FString::Printf(
+		TEXT("Damage %d-%d, kill %.0f%%\nCounterattack %.0f%% (%d-%d), lethal %.0f%%"),
+		Preview.MinDamage, Preview.MaxDamage, Preview.KillChance * 100.0f,
+		Preview.CounterChance * 100.0f, AUnit::MinCounterDamage, AUnit::MaxCounterDamage,
+		Preview.CounterKillChance * 100.0f)));
+}
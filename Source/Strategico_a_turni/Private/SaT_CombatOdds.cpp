@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_CombatOdds.h"
+
+// A Sniper shot (4 to 8) always kills at 4 hit points and kills at 6 with the rolls 6, 7 and 8
+static_assert(SaTCombatOdds::AttackRolls[0].Odds[4].Kill == 1.0f, "Combat odds: a roll of at least MinDamage must kill");
+static_assert(SaTCombatOdds::AttackRolls[0].Odds[6].Kill == 3.0f / 5.0f, "Combat odds: kill chance of a Sniper shot");
+static_assert(SaTCombatOdds::CounterRolls.Odds[1].Damage == 1.0f, "Combat odds: a dead unit loses only the hit points it had");
+
+EPieceUnit FSaTCombatOdds::GetPieceType(const AUnit* Unit)
+{
+	if (Unit && Unit->IsA<ASniper>())
+	{
+		return EPieceUnit::SNIPER;
+	}
+	if (Unit && Unit->IsA<ABrawler>())
+	{
+		return EPieceUnit::BRAWLER;
+	}
+	return EPieceUnit::NONE;
+}
+
+FSaTCombatOutcome FSaTCombatOdds::Get(const AUnit* Attacker, const AUnit* Target)
+{
+	if (!Attacker || !Target)
+	{
+		return FSaTCombatOutcome();
+	}
+
+	const int32 Distance = FMath::Abs(Target->GridX - Attacker->GridX) + FMath::Abs(Target->GridY - Attacker->GridY);
+	return Get(GetPieceType(Attacker), GetPieceType(Target), Distance, Attacker->Hp, Target->Hp, Attacker->MinDamage, Attacker->MaxDamage);
+}
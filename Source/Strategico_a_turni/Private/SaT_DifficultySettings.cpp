@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_DifficultySettings.h"
+
+USaT_DifficultySettings::USaT_DifficultySettings()
+{
+    CategoryName = TEXT("Game");
+    SetEvalWeights(FSaTEvalWeights());
+}
+
+FSaTDifficultyProfile USaT_DifficultySettings::GetProfile(EAIDifficulty Difficulty)
+{
+    const USaT_DifficultySettings* Settings = GetDefault<USaT_DifficultySettings>();
+    const FSaTDifficultyProfile* Profile = Settings->Profiles.FindByPredicate([Difficulty](const FSaTDifficultyProfile& Candidate)
+        {
+            return Candidate.Difficulty == Difficulty;
+        });
+    return Profile ? *Profile : MakeDefaultProfile(Difficulty);
+}
+
+FSaTDifficultyProfile USaT_DifficultySettings::MakeDefaultProfile(EAIDifficulty Difficulty)
+{
+    FSaTDifficultyProfile Profile;
+    Profile.Difficulty = Difficulty;
+    if (Difficulty == EAIDifficulty::EASY)
+    {
+        Profile.Algorithm = EAIAlgorithm::RANDOM;
+        Profile.bUseEndgameTablebase = false;
+        Profile.bPonderDuringHumanTurn = false;
+        Profile.ObstaclePercentage = 0.1f;
+    }
+    return Profile;
+}
+
+FSaTEvalWeights USaT_DifficultySettings::GetEvalWeights() const
+{
+    FSaTEvalWeights Weights;
+    Weights.Hp = HpWeight;
+    Weights.Kill = KillWeight;
+    Weights.Exposure = ExposureWeight;
+    Weights.Approach = ApproachWeight;
+    Weights.LineControl = LineControlWeight;
+    return Weights;
+}
+
+void USaT_DifficultySettings::SetEvalWeights(const FSaTEvalWeights& Weights)
+{
+    HpWeight = Weights.Hp;
+    KillWeight = Weights.Kill;
+    ExposureWeight = Weights.Exposure;
+    ApproachWeight = Weights.Approach;
+    LineControlWeight = Weights.LineControl;
+}
@@ -0,0 +1,538 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_EndgameTablebase.h"
+#include "Unit.h"
+#include "Sniper.h"
+#include "Brawler.h"
+#include "SaT_CombatOdds.h"
+#include "SaT_Memory.h"
+#include "Async/Async.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	/** Scores closer than this are equal, so ties go to the option with more winning chances */
+	constexpr float ScoreTolerance = 1.0e-6f;
+
+	/** Sweeps over a layer group before giving up on an exact fixed point */
+	constexpr int32 MaxSweeps = 1000;
+
+	bool IsBetter(const FSaTEndgameValue& Value, const FSaTEndgameValue& Best)
+	{
+		const float ScoreDelta = Value.GetScore() - Best.GetScore();
+		return ScoreDelta > ScoreTolerance || (ScoreDelta >= -ScoreTolerance && Value.Win > Best.Win + ScoreTolerance);
+	}
+
+	uint8 QuantiseChance(float Chance)
+	{
+		// Any chance at all stays distinguishable from none, so a thin chance is not read as a stalled position
+		return Chance <= 0.0f ? 0 : uint8(FMath::Clamp(FMath::RoundToInt(Chance * 255.0f), 1, 255));
+	}
+
+	FSaTEndgameValue ToValue(const FSaTEndgameTablebase::FEntry& Entry)
+	{
+		return { Entry.Win / 255.0f, Entry.Loss / 255.0f };
+	}
+
+	/**
+	 * Expected value for the mover of an attack, shared by the generator and the runtime queries
+	 * @param PassValue - Returns the value for the mover of ending the turn at (HpMover, HpOther, Distance)
+	 */
+	template <typename PassFunc>
+	FSaTEndgameValue ComputeAttack(const FSaTEndgameRules& Rules, int32 Mover, int32 Other, int32 HpMover, int32 HpOther, int32 Distance, bool bMoveAfter, PassFunc&& PassValue)
+	{
+		const FSaTEndgameUnitRules& Attacker = Rules.Units[Mover];
+		const int32 NumDamageRolls = Attacker.MaxDamage - Attacker.MinDamage + 1;
+		const int32 NumCounterRolls = Rules.MaxCounterDamage - Rules.MinCounterDamage + 1;
+		const bool bCounter = Rules.CanCounterattack(Mover, Other, Distance) && NumCounterRolls > 0;
+
+		const int32 MinDistance = bMoveAfter ? FMath::Max(1, Distance - Attacker.Movement) : Distance;
+		const int32 MaxDistance = bMoveAfter ? FMath::Min(Rules.MaxDistance, Distance + Attacker.Movement) : Distance;
+
+		// The move after the attack is chosen knowing the rolls
+		auto AfterAttack = [&](int32 NewHpMover, int32 NewHpOther)
+		{
+			FSaTEndgameValue Best = PassValue(NewHpMover, NewHpOther, MinDistance);
+			for (int32 NextDistance = MinDistance + 1; NextDistance <= MaxDistance; NextDistance++)
+			{
+				const FSaTEndgameValue Value = PassValue(NewHpMover, NewHpOther, NextDistance);
+				if (IsBetter(Value, Best))
+				{
+					Best = Value;
+				}
+			}
+			return Best;
+		};
+
+		FSaTEndgameValue Result;
+		const float DamageChance = 1.0f / NumDamageRolls;
+		for (int32 Damage = Attacker.MinDamage; Damage <= Attacker.MaxDamage; Damage++)
+		{
+			if (Damage >= HpOther)
+			{
+				Result.Win += DamageChance;
+				continue;
+			}
+
+			if (!bCounter)
+			{
+				const FSaTEndgameValue Next = AfterAttack(HpMover, HpOther - Damage);
+				Result.Win += DamageChance * Next.Win;
+				Result.Loss += DamageChance * Next.Loss;
+				continue;
+			}
+
+			const float CounterChance = DamageChance / NumCounterRolls;
+			for (int32 Counter = Rules.MinCounterDamage; Counter <= Rules.MaxCounterDamage; Counter++)
+			{
+				if (Counter >= HpMover)
+				{
+					Result.Loss += CounterChance;
+					continue;
+				}
+
+				const FSaTEndgameValue Next = AfterAttack(HpMover - Counter, HpOther - Damage);
+				Result.Win += CounterChance * Next.Win;
+				Result.Loss += CounterChance * Next.Loss;
+			}
+		}
+		return Result;
+	}
+}
+
+//----------------------------------------------
+// Rules
+//----------------------------------------------
+
+FSaTEndgameRules FSaTEndgameRules::FromUnitDefaults(int32 BoardSize)
+{
+	const AUnit* Defaults[NumTypes] = { GetDefault<ASniper>(), GetDefault<ABrawler>() };
+
+	FSaTEndgameRules Rules;
+	for (int32 Type = 0; Type < NumTypes; Type++)
+	{
+		FSaTEndgameUnitRules& Unit = Rules.Units[Type];
+		Unit.MaxHp = Defaults[Type]->Hp;
+		Unit.Movement = Defaults[Type]->Movement;
+		Unit.Range = Defaults[Type]->RangeAttack;
+		Unit.MinDamage = Defaults[Type]->MinDamage;
+		Unit.MaxDamage = Defaults[Type]->MaxDamage;
+	}
+
+	Rules.MinCounterDamage = AUnit::MinCounterDamage;
+	Rules.MaxCounterDamage = AUnit::MaxCounterDamage;
+	for (int32 Attacker = 0; Attacker < NumTypes; Attacker++)
+	{
+		for (int32 Target = 0; Target < NumTypes; Target++)
+		{
+			for (int32 Distance = 1; Distance <= 2; Distance++)
+			{
+				if (AUnit::CanCounterattack(Defaults[Attacker], Defaults[Target], Distance))
+				{
+					Rules.CounterMask |= 1 << ((Attacker * NumTypes + Target) * 2 + Distance - 1);
+				}
+			}
+		}
+	}
+
+	Rules.MaxDistance = FMath::Max(1, 2 * (BoardSize - 1));
+	return Rules;
+}
+
+//----------------------------------------------
+// Singleton
+//----------------------------------------------
+
+FSaTEndgameTablebase& FSaTEndgameTablebase::Get()
+{
+	static FSaTEndgameTablebase Tablebase;
+	return Tablebase;
+}
+
+FString FSaTEndgameTablebase::GetDefaultPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Tablebase") / TEXT("Endgame.sattb");
+}
+
+int32 FSaTEndgameTablebase::ToTypeIndex(EPieceUnit Type)
+{
+	switch (Type)
+	{
+	case EPieceUnit::SNIPER:
+		return 0;
+	case EPieceUnit::BRAWLER:
+		return 1;
+	default:
+		return INDEX_NONE;
+	}
+}
+
+EPieceUnit FSaTEndgameTablebase::GetPieceType(const AUnit* Unit)
+{
+	return FSaTCombatOdds::GetPieceType(Unit);
+}
+
+FSaTEndgameTablebase::~FSaTEndgameTablebase()
+{
+	// A generation still running would publish into the tables destroyed here
+	if (LoadingTask.IsValid())
+	{
+		LoadingTask.Wait();
+	}
+	Reset();
+}
+
+//----------------------------------------------
+// Generation
+//----------------------------------------------
+
+void FSaTEndgameTablebase::Generate(const FSaTEndgameRules& Rules, TArray<FEntry>& OutEntries)
+{
+	LLM_SCOPE_BYTAG(SaT_AISearch);
+
+	constexpr int32 NumTypes = FSaTEndgameRules::NumTypes;
+	const int32 NumEntries = Rules.GetNumEntries();
+	const int32 MaxDistance = Rules.MaxDistance;
+
+	// Solved in full precision, quantised at the end; unsolved positions (hit points above a type's maximum) stay draws
+	TArray<FSaTEndgameValue> Values;
+	Values.SetNumZeroed(NumEntries);
+
+	// The two sides of one pair of hit points: (Mover, Other, HpMover, HpOther) and the same with the roles swapped
+	struct FGroup
+	{
+		int32 Mover;
+		int32 Other;
+		int32 HpMover;
+		int32 HpOther;
+	};
+	TArray<FGroup> Groups;
+
+	const int32 MaxHpSum = 2 * Rules.GetMaxHp();
+	for (int32 HpSum = 2; HpSum <= MaxHpSum; HpSum++)
+	{
+		// Every attack lowers the hit points, so a layer only reads the layers below it and its groups are independent
+		Groups.Reset();
+		for (int32 Mover = 0; Mover < NumTypes; Mover++)
+		{
+			for (int32 Other = Mover; Other < NumTypes; Other++)
+			{
+				const int32 MinHpMover = FMath::Max(1, HpSum - Rules.Units[Other].MaxHp);
+				const int32 MaxHpMover = FMath::Min(Rules.Units[Mover].MaxHp, HpSum - 1);
+				for (int32 HpMover = MinHpMover; HpMover <= MaxHpMover; HpMover++)
+				{
+					// A group of two equal types is listed once
+					if (Mover != Other || HpMover <= HpSum - HpMover)
+					{
+						Groups.Add({ Mover, Other, HpMover, HpSum - HpMover });
+					}
+				}
+			}
+		}
+
+		ParallelFor(Groups.Num(), [&Rules, &Values, &Groups, MaxDistance](int32 GroupIndex)
+			{
+				const FGroup& Group = Groups[GroupIndex];
+				const int32 NumSides = (Group.Mover == Group.Other && Group.HpMover == Group.HpOther) ? 1 : 2;
+
+				// Side 1 is side 0 with the roles swapped; a symmetric group replies to itself
+				const int32 SelfType[2] = { Group.Mover, Group.Other };
+				const int32 SelfHp[2] = { Group.HpMover, Group.HpOther };
+				const int32 ReplySide[2] = { NumSides - 1, 0 };
+
+				FSaTEndgameValue* SideValues[2];
+				for (int32 SideIndex = 0; SideIndex < NumSides; SideIndex++)
+				{
+					const int32 Reply = ReplySide[SideIndex];
+					SideValues[SideIndex] = &Values[ToEntryIndex(Rules, SelfType[SideIndex], SelfType[Reply], SelfHp[SideIndex], SelfHp[Reply], 1)];
+				}
+
+				// Best attack of every position; attacks only lead to solved layers
+				TArray<FSaTEndgameValue> Exits;
+				Exits.SetNumUninitialized(NumSides * MaxDistance);
+				TArray<bool> HasExit;
+				HasExit.SetNumZeroed(NumSides * MaxDistance);
+
+				for (int32 SideIndex = 0; SideIndex < NumSides; SideIndex++)
+				{
+					const int32 Self = SelfType[SideIndex];
+					const int32 Opponent = SelfType[ReplySide[SideIndex]];
+					const int32 HpSelf = SelfHp[SideIndex];
+					const int32 HpOpponent = SelfHp[ReplySide[SideIndex]];
+					const FSaTEndgameUnitRules& Unit = Rules.Units[Self];
+
+					auto PassValue = [&Rules, &Values, Self, Opponent](int32 NewHpMover, int32 NewHpOther, int32 Distance)
+					{
+						return Values[ToEntryIndex(Rules, Opponent, Self, NewHpOther, NewHpMover, Distance)].Flip();
+					};
+
+					for (int32 Distance = 1; Distance <= MaxDistance; Distance++)
+					{
+						const int32 Slot = SideIndex * MaxDistance + Distance - 1;
+
+						// Attack first and move after
+						if (Distance <= Unit.Range)
+						{
+							Exits[Slot] = ComputeAttack(Rules, Self, Opponent, HpSelf, HpOpponent, Distance, true, PassValue);
+							HasExit[Slot] = true;
+						}
+
+						// Move and then attack
+						const int32 FirstDistance = FMath::Max(1, Distance - Unit.Movement);
+						const int32 LastDistance = FMath::Min3(MaxDistance, Distance + Unit.Movement, Unit.Range);
+						for (int32 AttackDistance = FirstDistance; AttackDistance <= LastDistance; AttackDistance++)
+						{
+							const FSaTEndgameValue Value = ComputeAttack(Rules, Self, Opponent, HpSelf, HpOpponent, AttackDistance, false, PassValue);
+							if (!HasExit[Slot] || IsBetter(Value, Exits[Slot]))
+							{
+								Exits[Slot] = Value;
+								HasExit[Slot] = true;
+							}
+						}
+					}
+				}
+
+				// Moves without an attack keep the hit points: sweep to the fixed point, where endless stalling is a draw
+				for (int32 Sweep = 0; Sweep < MaxSweeps; Sweep++)
+				{
+					bool bChanged = false;
+					for (int32 SideIndex = 0; SideIndex < NumSides; SideIndex++)
+					{
+						const int32 Movement = Rules.Units[SelfType[SideIndex]].Movement;
+						const FSaTEndgameValue* Reply = SideValues[ReplySide[SideIndex]];
+						for (int32 Distance = 1; Distance <= MaxDistance; Distance++)
+						{
+							const int32 Slot = SideIndex * MaxDistance + Distance - 1;
+							FSaTEndgameValue Best = HasExit[Slot] ? Exits[Slot] : Reply[Distance - 1].Flip();
+
+							const int32 LastDistance = FMath::Min(MaxDistance, Distance + Movement);
+							for (int32 NextDistance = FMath::Max(1, Distance - Movement); NextDistance <= LastDistance; NextDistance++)
+							{
+								const FSaTEndgameValue Value = Reply[NextDistance - 1].Flip();
+								if (IsBetter(Value, Best))
+								{
+									Best = Value;
+								}
+							}
+
+							FSaTEndgameValue& Current = SideValues[SideIndex][Distance - 1];
+							if (Best.Win != Current.Win || Best.Loss != Current.Loss)
+							{
+								Current = Best;
+								bChanged = true;
+							}
+						}
+					}
+
+					if (!bChanged)
+					{
+						break;
+					}
+				}
+			});
+	}
+
+	OutEntries.SetNumUninitialized(NumEntries);
+	for (int32 Index = 0; Index < NumEntries; Index++)
+	{
+		OutEntries[Index].Win = QuantiseChance(Values[Index].Win);
+		OutEntries[Index].Loss = QuantiseChance(Values[Index].Loss);
+	}
+}
+
+bool FSaTEndgameTablebase::SaveToFile(const FString& Path, const FSaTEndgameRules& Rules, const TArray<FEntry>& Entries)
+{
+	if (Entries.Num() != Rules.GetNumEntries())
+	{
+		return false;
+	}
+
+	FFileHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = FileMagic;
+	Header.Version = FileVersion;
+	Header.Rules = Rules;
+
+	TArray<uint8> Data;
+	Data.Reserve(sizeof(FFileHeader) + Entries.Num() * sizeof(FEntry));
+	Data.Append(reinterpret_cast<const uint8*>(&Header), sizeof(FFileHeader));
+	Data.Append(reinterpret_cast<const uint8*>(Entries.GetData()), Entries.Num() * sizeof(FEntry));
+	return FFileHelper::SaveArrayToFile(Data, *Path);
+}
+
+//----------------------------------------------
+// Loading
+//----------------------------------------------
+
+bool FSaTEndgameTablebase::LoadFromFile(const FString& Path, const FSaTEndgameRules& InRules)
+{
+	IMappedFileHandle* Handle = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path);
+	if (!Handle)
+	{
+		return false;
+	}
+
+	const int64 ExpectedSize = sizeof(FFileHeader) + int64(InRules.GetNumEntries()) * sizeof(FEntry);
+	IMappedFileRegion* Region = Handle->GetFileSize() == ExpectedSize ? Handle->MapRegion(0, ExpectedSize) : nullptr;
+	const FFileHeader* Header = Region ? reinterpret_cast<const FFileHeader*>(Region->GetMappedPtr()) : nullptr;
+	if (!Header || Header->Magic != FileMagic || Header->Version != FileVersion || !(Header->Rules == InRules))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Endgame tablebase %s is out of date or damaged"), *Path);
+		delete Region;
+		delete Handle;
+		return false;
+	}
+
+	TUniquePtr<FTable> NewTable = MakeUnique<FTable>();
+	NewTable->Rules = InRules;
+	NewTable->Entries = reinterpret_cast<const FEntry*>(Region->GetMappedPtr() + sizeof(FFileHeader));
+	NewTable->MappedFile = Handle;
+	NewTable->MappedRegion = Region;
+	Publish(MoveTemp(NewTable));
+	UE_LOG(LogTemp, Display, TEXT("Endgame tablebase mapped from %s (%lld KB)"), *Path, ExpectedSize / 1024);
+	return true;
+}
+
+void FSaTEndgameTablebase::LoadOrGenerateAsync(const FSaTEndgameRules& InRules)
+{
+	const FTable* Current = Table.load(std::memory_order_acquire);
+	if ((Current && Current->Rules == InRules) || bLoading.exchange(true))
+	{
+		return;
+	}
+
+	LoadingTask = Async(EAsyncExecution::Thread, [this, InRules]()
+		{
+			const FString Path = GetDefaultPath();
+			if (!LoadFromFile(Path, InRules))
+			{
+				const double StartSeconds = FPlatformTime::Seconds();
+				TArray<FEntry> NewEntries;
+				Generate(InRules, NewEntries);
+				UE_LOG(LogTemp, Display, TEXT("Endgame tablebase generated in %.1f ms"), (FPlatformTime::Seconds() - StartSeconds) * 1000.0);
+
+				// Play from memory if the file cannot be written or mapped back
+				if (!SaveToFile(Path, InRules, NewEntries) || !LoadFromFile(Path, InRules))
+				{
+					UE_LOG(LogTemp, Warning, TEXT("Endgame tablebase could not be saved to %s, keeping it in memory"), *Path);
+					TUniquePtr<FTable> NewTable = MakeUnique<FTable>();
+					NewTable->Rules = InRules;
+					NewTable->GeneratedEntries = MoveTemp(NewEntries);
+					NewTable->Entries = NewTable->GeneratedEntries.GetData();
+					Publish(MoveTemp(NewTable));
+				}
+			}
+			bLoading.store(false);
+		});
+}
+
+FSaTEndgameTablebase::FTable::~FTable()
+{
+	delete MappedRegion;
+	delete MappedFile;
+}
+
+void FSaTEndgameTablebase::Publish(TUniquePtr<FTable> NewTable)
+{
+	// The lookups only see the new table once it is complete; the old one stays mapped until Reset
+	const FTable* Published = NewTable.Get();
+	{
+		FScopeLock Lock(&TablesLock);
+		Tables.Add(MoveTemp(NewTable));
+	}
+	Table.store(Published, std::memory_order_release);
+}
+
+void FSaTEndgameTablebase::Reset()
+{
+	Table.store(nullptr, std::memory_order_release);
+
+	FScopeLock Lock(&TablesLock);
+	Tables.Empty();
+}
+
+FSaTEndgameRules FSaTEndgameTablebase::GetRules() const
+{
+	const FTable* Current = Table.load(std::memory_order_acquire);
+	return Current ? Current->Rules : FSaTEndgameRules();
+}
+
+SIZE_T FSaTEndgameTablebase::GetAllocatedSize() const
+{
+	FScopeLock Lock(&TablesLock);
+	SIZE_T Size = Tables.GetAllocatedSize();
+	for (const TUniquePtr<FTable>& Each : Tables)
+	{
+		Size += sizeof(FTable) + Each->GeneratedEntries.GetAllocatedSize();
+	}
+	return Size;
+}
+
+//----------------------------------------------
+// Queries
+//----------------------------------------------
+
+FSaTEndgameValue FSaTEndgameTablebase::Lookup(EPieceUnit MoverType, EPieceUnit OtherType, int32 HpMover, int32 HpOther, int32 Distance) const
+{
+	const int32 Mover = ToTypeIndex(MoverType);
+	const int32 Other = ToTypeIndex(OtherType);
+	const FTable* Current = Table.load(std::memory_order_acquire);
+	if (!Current || Mover == INDEX_NONE || Other == INDEX_NONE)
+	{
+		return FSaTEndgameValue();
+	}
+
+	// A unit without hit points has already decided the game
+	if (HpMover <= 0 || HpOther <= 0)
+	{
+		return { HpOther <= 0 && HpMover > 0 ? 1.0f : 0.0f, HpMover <= 0 && HpOther > 0 ? 1.0f : 0.0f };
+	}
+
+	const FSaTEndgameRules& Rules = Current->Rules;
+	const int32 MaxHp = Rules.GetMaxHp();
+	return ToValue(Current->Entries[ToEntryIndex(Rules, Mover, Other, FMath::Min(HpMover, MaxHp), FMath::Min(HpOther, MaxHp), FMath::Clamp(Distance, 1, Rules.MaxDistance))]);
+}
+
+bool FSaTEndgameTablebase::Probe(const AUnit* Mover, const AUnit* Other, FSaTEndgameValue& OutValue) const
+{
+	const EPieceUnit MoverType = GetPieceType(Mover);
+	const EPieceUnit OtherType = GetPieceType(Other);
+	if (!IsReady() || MoverType == EPieceUnit::NONE || OtherType == EPieceUnit::NONE)
+	{
+		return false;
+	}
+
+	const int32 Distance = FMath::Abs(Mover->GridX - Other->GridX) + FMath::Abs(Mover->GridY - Other->GridY);
+	OutValue = Lookup(MoverType, OtherType, Mover->Hp, Other->Hp, Distance);
+	return true;
+}
+
+FSaTEndgameValue FSaTEndgameTablebase::EvaluatePass(EPieceUnit MoverType, EPieceUnit OtherType, int32 HpMover, int32 HpOther, int32 Distance) const
+{
+	return Lookup(OtherType, MoverType, HpOther, HpMover, Distance).Flip();
+}
+
+FSaTEndgameValue FSaTEndgameTablebase::EvaluateAttack(EPieceUnit MoverType, EPieceUnit OtherType, int32 HpMover, int32 HpOther, int32 Distance, bool bMoveAfter) const
+{
+	const int32 Mover = ToTypeIndex(MoverType);
+	const int32 Other = ToTypeIndex(OtherType);
+	const FTable* Current = Table.load(std::memory_order_acquire);
+	if (!Current || Mover == INDEX_NONE || Other == INDEX_NONE)
+	{
+		return FSaTEndgameValue();
+	}
+
+	const FSaTEndgameRules& Rules = Current->Rules;
+	return ComputeAttack(Rules, Mover, Other, HpMover, HpOther, FMath::Clamp(Distance, 1, Rules.MaxDistance), bMoveAfter,
+		[this, MoverType, OtherType](int32 NewHpMover, int32 NewHpOther, int32 NextDistance)
+		{
+			return EvaluatePass(MoverType, OtherType, NewHpMover, NewHpOther, NextDistance);
+		});
+}
@@ -2,7 +2,10 @@
 
 #include "SaT_GameInstance.h"
 #include "SaT_GameMode.h"
+#include "SaT_DifficultySettings.h"
 #include "GridManager.h"
+#include "GridPathfindingBenchmark.h"
+#include "SaT_Memory.h"
 #include "Kismet/GameplayStatics.h"
 
 // Constructor
@@ -42,7 +45,7 @@ void USaT_GameInstance::SetupGameWithDifficulty(EAIDifficulty Difficulty)
         // Clear the difficulty widget and start the game
         GameMode->HideDifficultyWidget();
 
-        // Find the grid manager to adjust obstacle percentage
+        // Find the grid manager to set up the map of the difficulty
         AGridManager* GridManager = nullptr;
         TArray<AActor*> FoundGrids;
         UGameplayStatics::GetAllActorsOfClass(GetWorld(), AGridManager::StaticClass(), FoundGrids);
@@ -55,23 +58,13 @@ void USaT_GameInstance::SetupGameWithDifficulty(EAIDifficulty Difficulty)
             {
                 SavedPathMaterial = GridManager->PathMaterial;
 
-                // Adjust obstacle percentage based on difficulty
-                if (Difficulty == EAIDifficulty::HARD)
-                {
-                    // More obstacles in Hard mode
-                    GridManager->ObstaclePercentage = 0.2f; // 20% obstacles
-                }
-                else
-                {
-                    // Fewer obstacles in Easy mode
-                    GridManager->ObstaclePercentage = 0.1f; // 10% obstacles
-                }
+                // Map settings of the difficulty profile (more obstacles in Hard mode by default)
+                const FSaTDifficultyProfile Profile = USaT_DifficultySettings::GetProfile(Difficulty);
+                GridManager->ObstaclePercentage = Profile.ObstaclePercentage;
+                GridManager->TerrainPercentage = Profile.TerrainPercentage;
+                GridManager->bRequireLineOfSight = Profile.bRequireLineOfSight;
 
-                // Regenerate the grid with the new obstacle percentage
-                GridManager->TileArray.Empty();
-                GridManager->TileMap.Empty();
-                GridManager->HighlightedTiles.Empty();
-                GridManager->PathTiles.Empty();
+                // Regenerate the grid with the new map settings; the existing tiles are reused
                 GridManager->GenerateField();
 
                 if (SavedPathMaterial)
@@ -86,6 +79,38 @@ void USaT_GameInstance::SetupGameWithDifficulty(EAIDifficulty Difficulty)
     }
 }
 
+// Console command: logs tile actor counts and memory of the grid
+void USaT_GameInstance::SaTTileReport()
+{
+    TArray<AActor*> FoundGrids;
+    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AGridManager::StaticClass(), FoundGrids);
+    for (AActor* Actor : FoundGrids)
+    {
+        if (AGridManager* GridManager = Cast<AGridManager>(Actor))
+        {
+            GridManager->LogTileReport();
+        }
+    }
+}
+
+// Console command: runs the pathfinding micro-benchmark (same as the GridBenchmark commandlet)
+void USaT_GameInstance::SaTBenchmarkPathfinding(int32 Seed, int32 QueriesPerCase)
+{
+    FGridBenchmarkSettings Settings;
+    Settings.Seed = Seed;
+    Settings.QueriesPerCase = FMath::Max(1, QueriesPerCase);
+
+    TArray<FGridBenchmarkResult> Results;
+    FGridPathfindingBenchmark::Run(Settings, Results);
+    FGridPathfindingBenchmark::LogResults(Results);
+}
+
+// Console command: logs the game's memory per LLM category against its budget
+void USaT_GameInstance::SaTMemoryBudget()
+{
+    FSaTMemoryBudget::Log(GetWorld());
+}
+
 /*
  * Randomly determines which player starts the game
  * Uses a 50/50 chance to set bPlayerStartsFirst and bIsPlayerTurn
@@ -9,11 +9,15 @@
 #include "Sniper.h"
 #include "Brawler.h"
 #include "Unit.h"
+#include "SaT_CombatOdds.h"
+#include "SaT_AttackPreviewWidget.h"
 #include "SaT_PlayerController.h"
 #include "Blueprint/UserWidget.h"
 #include "Components/Button.h"
 #include "Components/TextBlock.h"
 #include "SaT_GameInstance.h"
+#include "SaT_Stats.h"
+#include "SaT_TurnTelemetry.h"
 #include "UObject/ConstructorHelpers.h"
 
 // Constructor - initializes default values, components, and widget classes
@@ -57,6 +61,9 @@ ASaT_HumanPlayer::ASaT_HumanPlayer()
     {
         MovementAndAttackWidgetClass = DefaultMovementAndAttackClass.Class;
     }
+
+    // The preview panel builds its own widget tree, no asset to load
+    AttackPreviewWidgetClass = USaT_AttackPreviewWidget::StaticClass();
 }
 
 // Called when the game starts - initializes player state, references, and validates components
@@ -156,6 +163,18 @@ void ASaT_HumanPlayer::BeginPlay()
 void ASaT_HumanPlayer::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
+
+    // Preview the path to the hovered cell while choosing where to move
+    if (IsMyTurn && bMoveMode)
+    {
+        UpdateHoverPathPreview();
+    }
+
+    // Preview the odds of attacking the hovered enemy while choosing a target
+    else if (IsMyTurn && bAttackMode)
+    {
+        UpdateHoverAttackPreview();
+    }
 }
 
 // Configures input bindings for the player
@@ -403,35 +422,17 @@ void ASaT_HumanPlayer::OnClick()
         return;
     }
 
-    FHitResult HitResult;
-    bool bHitSuccess = PC->GetHitResultUnderCursor(ECC_Visibility, true, HitResult);
+    // Intersect the cursor ray with the board instead of tracing against the tiles
+    FVector RayOrigin;
+    FVector RayDirection;
+    int32 CellX = 0;
+    int32 CellY = 0;
+    bool bHitSuccess = GridManager && PC->DeprojectMousePositionToWorld(RayOrigin, RayDirection) &&
+        GridManager->GetCellUnderRay(RayOrigin, RayDirection, CellX, CellY);
 
     if (bHitSuccess)
     {
-        // Find the clicked tile or closest tile
-        ATile* ClickedTile = nullptr;
-
-        // First try to get the directly hit tile
-        ClickedTile = Cast<ATile>(HitResult.GetActor());
-
-        // If no direct hit, find the closest tile
-        if (!ClickedTile && GridManager)
-        {
-            float ClosestDistance = FLT_MAX;
-            for (auto& TilePair : GridManager->TileMap)
-            {
-                ATile* Tile = TilePair.Value;
-                if (Tile)
-                {
-                    float DistSq = FVector::DistSquared(Tile->GetActorLocation(), HitResult.Location);
-                    if (DistSq < ClosestDistance)
-                    {
-                        ClosestDistance = DistSq;
-                        ClickedTile = Tile;
-                    }
-                }
-            }
-        }
+        ATile* ClickedTile = GridManager->TileMap.FindRef(FVector2D(CellX, CellY));
 
         // Process the clicked tile if found
         if (ClickedTile)
@@ -464,7 +465,7 @@ void ASaT_HumanPlayer::OnClick()
     }
     else
     {
-        UE_LOG(LogTemp, Warning, TEXT("No hit result under cursor"));
+        UE_LOG(LogTemp, Warning, TEXT("Cursor is not over the board"));
     }
 }
 
@@ -569,7 +570,7 @@ void ASaT_HumanPlayer::HandlePlayingPhaseClick(ATile* ClickedTile)
         if (bMoveMode && SelectedUnit)
         {
             // Check if this cell is in movement range (highlighted)
-            bool bIsInMovementRange = GridManager->HighlightedTiles.Contains(ClickedTile);
+            bool bIsInMovementRange = GridManager->IsCellHighlighted(ClickedTile->GridX, ClickedTile->GridY);
 
             if (bIsInMovementRange)
             {
@@ -580,8 +581,11 @@ void ASaT_HumanPlayer::HandlePlayingPhaseClick(ATile* ClickedTile)
                 }
                 else
                 {
-                    // Calculate path
-                    CalculatePath(SelectedUnit->GridX, SelectedUnit->GridY, ClickedTile->GridX, ClickedTile->GridY);
+                    // Take the path from the move tree (it is the one being previewed), searching only if the tree is stale
+                    if (!GetMoveTreePath(ClickedTile->GridX, ClickedTile->GridY, CurrentPath))
+                    {
+                        CalculatePath(SelectedUnit->GridX, SelectedUnit->GridY, ClickedTile->GridX, ClickedTile->GridY);
+                    }
 
                     // Store unit reference
                     AUnit* UnitToMove = SelectedUnit;
@@ -740,6 +744,7 @@ void ASaT_HumanPlayer::ShowUnitSelectionWidget()
     // Count placed units of each type
     TArray<AActor*> AllUnits;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+    INC_DWORD_STAT_BY(STAT_SaT_ActorsScanned, AllUnits.Num());
 
     for (AActor* UnitActor : AllUnits)
     {
@@ -1124,103 +1129,167 @@ void ASaT_HumanPlayer::ShowMovementRange(AUnit * Unit)
     // Clear previous highlights
     GridManager->ClearAllHighlights();
 
-    // Get unit's current position and movement range
-    int32 UnitX = Unit->GridX;
-    int32 UnitY = Unit->GridY;
-    int32 MovementRange = Unit->Movement;
+    // Cells whose movement cost fits the unit's budget: BFS bitboard layers on plain boards,
+    // a bucket-queue sweep once terrain makes some steps cost more
+    const FGridBitboard ReachableCells = GridManager->GetReachableCells(Unit->GridX, Unit->GridY, Unit->Movement);
 
-    // Dijkstra's algorithm for finding reachable tiles
-    // Initialize distance array (distance from start position)
-    int32 Distance[25][25];
-    for (int32 x = 0; x < 25; x++)
-    {
-        for (int32 y = 0; y < 25; y++)
+    // Highlight all reachable cells
+    ReachableCells.ForEachSetCell([this](int32 X, int32 Y)
         {
-            Distance[x][y] = INT_MAX; // "Infinity"
-        }
-    }
+            GridManager->HighlightCell(X, Y, true);
+        });
 
-    // Start position has distance 0
-    Distance[UnitX][UnitY] = 0;
+    // Paths to those cells come from one tree, built now for the hover preview and the move
+    BuildMoveTree(Unit);
+}
 
-    // Priority queue for Dijkstra
-    TArray<TPair<int32, FVector2D>> Queue;
-    Queue.Add(TPair<int32, FVector2D>(0, FVector2D(UnitX, UnitY)));
+// Sweeps the shortest-path tree of the unit once, limited to its movement range
+void ASaT_HumanPlayer::BuildMoveTree(AUnit* Unit)
+{
+    SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_Pathfinding);
 
-    // Direction vectors for 4-way movement
-    int32 dx[] = { 1, -1, 0, 0 };
-    int32 dy[] = { 0, 0, 1, -1 };
+    MoveTreeUnit = nullptr;
+    HoveredCell = FIntPoint(-1, -1);
+    if (!Unit || !GridManager)
+    {
+        return;
+    }
 
-    while (Queue.Num() > 0)
+    FGridSearchStats Stats;
+    GridManager->BuildSearchGrid(MoveSearchGrid, true);
+    FGridPathfinding::ComputeDistanceField(MoveSearchGrid, Unit->GridX, Unit->GridY, MoveTree, Unit->Movement, &Stats);
+    INC_DWORD_STAT_BY(STAT_SaT_NodesExpanded, Stats.NodesExpanded);
+    SAT_TELEMETRY_ADD(PathfindingCalls, 1);
+    SAT_TELEMETRY_ADD(NodesExpanded, Stats.NodesExpanded);
+
+    MoveTreeUnit = Unit;
+}
+
+// Walks the move tree from a cell back to the unit; only valid while the unit has not moved
+bool ASaT_HumanPlayer::GetMoveTreePath(int32 GridX, int32 GridY, TArray<FVector2D>& OutPath) const
+{
+    if (!MoveTreeUnit || MoveTreeUnit != SelectedUnit || MoveTree.GetDistance(MoveTreeUnit->GridX, MoveTreeUnit->GridY) != 0)
     {
-        // Find smallest distance node
-        int32 SmallestIdx = 0;
-        for (int32 i = 1; i < Queue.Num(); i++)
-        {
-            if (Queue[i].Key < Queue[SmallestIdx].Key)
-            {
-                SmallestIdx = i;
-            }
-        }
+        return false;
+    }
 
-        // Get and remove closest node
-        TPair<int32, FVector2D> Current = Queue[SmallestIdx];
-        Queue.RemoveAt(SmallestIdx);
+    // The unit's own cell has no path to preview
+    const int32 Distance = MoveTree.GetDistance(GridX, GridY);
+    if (Distance <= 0 || Distance > MoveTreeUnit->Movement)
+    {
+        return false;
+    }
 
-        int32 CurrentX = FMath::FloorToInt(Current.Value.X);
-        int32 CurrentY = FMath::FloorToInt(Current.Value.Y);
-        int32 CurrentDist = Current.Key;
+    return MoveTree.GetPathTo(GridX, GridY, OutPath);
+}
 
-        // If we've exceeded movement range, don't process this node further
-        if (CurrentDist > MovementRange)
-            continue;
+// Highlights the path to the hovered cell; tiles are only touched when the hovered cell changes
+void ASaT_HumanPlayer::UpdateHoverPathPreview()
+{
+    if (!GridManager || !SelectedUnit || SelectedUnit->bHasMovedThisTurn)
+    {
+        return;
+    }
 
-        // Try all four directions
-        for (int32 i = 0; i < 4; i++)
-        {
-            int32 NewX = CurrentX + dx[i];
-            int32 NewY = CurrentY + dy[i];
+    FIntPoint Cell;
+    GetCellUnderCursor(Cell);
+    if (Cell == HoveredCell)
+    {
+        return;
+    }
+    HoveredCell = Cell;
 
-            // Skip if invalid position
-            if (!GridManager->IsValidPosition(FVector2D(NewX, NewY)))
-                continue;
+    if (GetMoveTreePath(Cell.X, Cell.Y, CurrentPath))
+    {
+        GridManager->HighlightPath(CurrentPath, true);
+    }
+    else
+    {
+        ClearPath();
+    }
+}
 
-            // Get the tile
-            ATile* Tile = nullptr;
-            if (GridManager->TileMap.Contains(FVector2D(NewX, NewY)))
-                Tile = GridManager->TileMap[FVector2D(NewX, NewY)];
+// Casts the mouse ray onto the grid; the cell is (-1, -1) when the cursor is off the grid
+bool ASaT_HumanPlayer::GetCellUnderCursor(FIntPoint& OutCell) const
+{
+    APlayerController* PC = GetWorld()->GetFirstPlayerController();
+    FVector RayOrigin;
+    FVector RayDirection;
+    if (!GridManager || !PC || !PC->DeprojectMousePositionToWorld(RayOrigin, RayDirection) ||
+        !GridManager->GetCellUnderRay(RayOrigin, RayDirection, OutCell.X, OutCell.Y))
+    {
+        OutCell = FIntPoint(-1, -1);
+        return false;
+    }
+    return true;
+}
 
-            // Skip if tile is an obstacle or occupied
-            if (!Tile || Tile->bIsObstacle || (Tile->bIsOccupied && !(NewX == UnitX && NewY == UnitY)))
-                continue;
+// Shows the odds of attacking the hovered enemy; the combat odds are a table lookup, done only when the hovered cell changes
+void ASaT_HumanPlayer::UpdateHoverAttackPreview()
+{
+    if (!GridManager || !SelectedUnit || SelectedUnit->bHasAttackedThisTurn)
+    {
+        ClearAttackPreview();
+        return;
+    }
 
-            // Cost to move to this tile is 1
-            int32 NewDist = CurrentDist + 1;
+    FIntPoint Cell;
+    GetCellUnderCursor(Cell);
+    if (Cell == HoveredAttackCell)
+    {
+        return;
+    }
+    HoveredAttackCell = Cell;
 
-            // If we found a shorter path, update distance
-            if (NewDist < Distance[NewX][NewY])
-            {
-                Distance[NewX][NewY] = NewDist;
-                Queue.Add(TPair<int32, FVector2D>(NewDist, FVector2D(NewX, NewY)));
-            }
+    AUnit* Target = Cell.X >= 0 ? GridManager->GetUnitAt(Cell.X, Cell.Y) : nullptr;
+    if (!Target || Target->bIsPlayerUnit || !Target->IsAlive() ||
+        !GridManager->CanAttackCell(SelectedUnit->GridX, SelectedUnit->GridY, Target->GridX, Target->GridY, SelectedUnit->RangeAttack))
+    {
+        AttackPreview = FSaTAttackPreview();
+        if (AttackPreviewWidget)
+        {
+            AttackPreviewWidget->SetVisibility(ESlateVisibility::Collapsed);
         }
+        return;
     }
 
-    // Highlight all reachable cells
-    int32 HighlightCount = 0;
-    for (int32 x = 0; x < 25; x++)
+    const FSaTCombatOutcome Odds = FSaTCombatOdds::Get(SelectedUnit, Target);
+    const int32 Distance = FMath::Abs(Target->GridX - SelectedUnit->GridX) + FMath::Abs(Target->GridY - SelectedUnit->GridY);
+
+    AttackPreview.bValid = true;
+    AttackPreview.MinDamage = SelectedUnit->MinDamage;
+    AttackPreview.MaxDamage = SelectedUnit->MaxDamage;
+    AttackPreview.KillChance = Odds.TargetDies;
+    AttackPreview.ExpectedDamage = Odds.TargetHpLoss;
+    AttackPreview.CounterChance = AUnit::CanCounterattack(SelectedUnit, Target, Distance) ? 1.0f - Odds.TargetDies : 0.0f;
+    AttackPreview.CounterKillChance = Odds.AttackerDies;
+
+    if (!AttackPreviewWidget && AttackPreviewWidgetClass)
+    {
+        AttackPreviewWidget = CreateWidget<USaT_AttackPreviewWidget>(GetWorld()->GetFirstPlayerController(), AttackPreviewWidgetClass);
+    }
+    if (AttackPreviewWidget)
     {
-        for (int32 y = 0; y < 25; y++)
+        AttackPreviewWidget->SetPreview(AttackPreview);
+        AttackPreviewWidget->SetVisibility(ESlateVisibility::HitTestInvisible);
+        if (!AttackPreviewWidget->IsInViewport())
         {
-            if (Distance[x][y] <= MovementRange && Distance[x][y] > 0)
-            {
-                GridManager->HighlightCell(x, y, true);
-                HighlightCount++;
-            }
+            AttackPreviewWidget->AddToViewport(10001);
         }
     }
 }
 
+// Hides the attack preview and forgets the hovered cell
+void ASaT_HumanPlayer::ClearAttackPreview()
+{
+    AttackPreview = FSaTAttackPreview();
+    HoveredAttackCell = FIntPoint(-1, -1);
+    if (AttackPreviewWidget)
+    {
+        AttackPreviewWidget->SetVisibility(ESlateVisibility::Collapsed);
+    }
+}
+
 // Attempts to move a unit to the specified grid location
 bool ASaT_HumanPlayer::TryMoveUnit(AUnit* Unit, int32 TargetGridX, int32 TargetGridY)
 {
@@ -1229,10 +1298,14 @@ bool ASaT_HumanPlayer::TryMoveUnit(AUnit* Unit, int32 TargetGridX, int32 TargetG
         return false;
     }
 
+    const int32 OldGridX = Unit->GridX;
+    const int32 OldGridY = Unit->GridY;
+
     // Use the Unit's Move method which has the bHasMovedThisTurn check
     if (Unit->Move(TargetGridX, TargetGridY))
     {
-        // The move was successful, update the grid
+        // The move was successful, free the old cell and occupy the new one
+        GridManager->OccupyCell(OldGridX, OldGridY, nullptr);
         GridManager->OccupyCell(TargetGridX, TargetGridY, Unit);
 
         return true;
@@ -1271,122 +1344,14 @@ void ASaT_HumanPlayer::CalculatePath(int32 StartX, int32 StartY, int32 EndX, int
         }
     }
 
-    // Setup Dijkstra's algorithm for pathfinding
-    int32 Distance[25][25];
-    FVector2D Previous[25][25];
-    bool Visited[25][25] = { false };
-
-    // Initialize distance array
-    for (int32 x = 0; x < 25; x++)
-    {
-        for (int32 y = 0; y < 25; y++)
-        {
-            Distance[x][y] = INT_MAX;
-            Previous[x][y] = FVector2D(-1, -1); // Invalid previous position
-        }
-    }
-
-    // Start position has distance 0
-    Distance[StartX][StartY] = 0;
-
-    // Direction vectors for 4-way movement
-    int32 dx[] = { 0, 1, 0, -1 };
-    int32 dy[] = { -1, 0, 1, 0 };
-
-    // Dijkstra's algorithm
-    for (int32 i = 0; i < 25 * 25; i++) // Max iterations
-    {
-        // Find unvisited node with smallest distance
-        int32 MinDist = INT_MAX;
-        int32 MinX = -1, MinY = -1;
-
-        for (int32 x = 0; x < 25; x++)
-        {
-            for (int32 y = 0; y < 25; y++)
-            {
-                if (!Visited[x][y] && Distance[x][y] < MinDist)
-                {
-                    MinDist = Distance[x][y];
-                    MinX = x;
-                    MinY = y;
-                }
-            }
-        }
-
-        // If no more nodes to process or we reached destination
-        if (MinX == -1 || (MinX == EndX && MinY == EndY))
-            break;
-
-        // Mark as visited
-        Visited[MinX][MinY] = true;
-
-        // Try all four directions
-        for (int32 dir = 0; dir < 4; dir++)
-        {
-            int32 NewX = MinX + dx[dir];
-            int32 NewY = MinY + dy[dir];
-
-            // Skip if outside grid
-            if (!GridManager->IsValidPosition(FVector2D(NewX, NewY)))
-                continue;
-
-            // Skip if already visited
-            if (Visited[NewX][NewY])
-                continue;
-
-            // Skip obstacles
-            ATile* Tile = nullptr;
-            if (GridManager->TileMap.Contains(FVector2D(NewX, NewY)))
-                Tile = GridManager->TileMap[FVector2D(NewX, NewY)];
-
-            if (!Tile || Tile->bIsObstacle || (Tile->bIsOccupied && !(NewX == EndX && NewY == EndY)))
-                continue;
-
-            // Calculate new distance (cost is 1 per step)
-            int32 NewDist = Distance[MinX][MinY] + 1;
-
-            // If found shorter path
-            if (NewDist < Distance[NewX][NewY])
-            {
-                Distance[NewX][NewY] = NewDist;
-                Previous[NewX][NewY] = FVector2D(MinX, MinY);
-            }
-        }
-    }
-
-    // Check if we found a path to the destination
-    if (Distance[EndX][EndY] == INT_MAX)
+    // Shortest path over the grid manager's navigation grid
+    if (!GridManager->FindPath(StartX, StartY, EndX, EndY, CurrentPath))
     {
         // Add start point for fallback visualization
         CurrentPath.Add(FVector2D(StartX, StartY));
         return;
     }
 
-    // Reconstruct path from end to start
-    TArray<FVector2D> ReversePath;
-    int32 CurrentX = EndX;
-    int32 CurrentY = EndY;
-
-    while (CurrentX != -1 && CurrentY != -1)
-    {
-        ReversePath.Add(FVector2D(CurrentX, CurrentY));
-
-        // If we reached the start
-        if (CurrentX == StartX && CurrentY == StartY)
-            break;
-
-        // Get previous position
-        FVector2D PrevPos = Previous[CurrentX][CurrentY];
-        CurrentX = FMath::FloorToInt(PrevPos.X);
-        CurrentY = FMath::FloorToInt(PrevPos.Y);
-    }
-
-    // Reverse to get start-to-end path
-    for (int32 i = ReversePath.Num() - 1; i >= 0; i--)
-    {
-        CurrentPath.Add(ReversePath[i]);
-    }
-
     // Visualize the path
     if (CurrentPath.Num() > 0 && GridManager)
     {
@@ -1419,6 +1384,12 @@ void ASaT_HumanPlayer::ClearAllHighlightsAndPaths()
         // Also clear our path tracking array
         CurrentPath.Empty();
     }
+
+    // The next move mode builds a fresh tree
+    MoveTreeUnit = nullptr;
+    HoveredCell = FIntPoint(-1, -1);
+
+    ClearAttackPreview();
 }
 
 // Calculates and highlights valid attack targets for a unit
@@ -1431,62 +1402,17 @@ void ASaT_HumanPlayer::ShowAttackRange(AUnit* Unit)
 
     GridManager->ClearAllHighlights();
 
-    // Get the unit's current position and attack range
-    int32 UnitX = Unit->GridX;
-    int32 UnitY = Unit->GridY;
-    int32 AttackRange = Unit->RangeAttack;
-
-    // For Sniper (long range attack), show all cells within range
-    // For Brawler (close combat), only show adjacent cells
-    bool bIsSniper = Cast<ASniper>(Unit) != nullptr;
+    // Enemy units inside the attack diamond; Snipers shoot through obstacles unless the
+    // line-of-sight rule is on, in which case hidden cells are masked out of the diamond
+    const FGridBitboard TargetCells =
+        GridManager->GetAttackableCells(Unit->GridX, Unit->GridY, Unit->RangeAttack) &
+        GridManager->GetUnitBoard(false);
 
     // Highlight cells in attack range
-    int32 HighlightedCount = 0;
-
-    // Simple Manhattan distance calculation for all cells
-    for (int32 X = UnitX - AttackRange; X <= UnitX + AttackRange; X++)
-    {
-        for (int32 Y = UnitY - AttackRange; Y <= UnitY + AttackRange; Y++)
+    TargetCells.ForEachSetCell([this](int32 X, int32 Y)
         {
-            // Skip if out of grid bounds
-            if (X < 0 || X >= 25 || Y < 0 || Y >= 25)
-                continue;
-
-            // Calculate Manhattan distance
-            int32 Distance = FMath::Abs(X - UnitX) + FMath::Abs(Y - UnitY);
-
-            // Check if in range and not the unit's own position
-            if (Distance <= AttackRange && (X != UnitX || Y != UnitY))
-            {
-                // For Snipers, ignore obstacles
-                // For Brawlers, check if path is clear (simplified)
-                bool bCanAttack = false;
-
-                if (bIsSniper)
-                {
-                    // Snipers can attack through obstacles
-                    bCanAttack = true;
-                }
-                else
-                {
-                    // Brawlers need adjacent cells (already checked with Distance)
-                    bCanAttack = (Distance <= AttackRange);
-                }
-
-                // Only highlight cells that can be attacked
-                if (bCanAttack)
-                {
-                    // Check if there's an enemy unit at this position
-                    AUnit* TargetUnit = FindUnitAtPosition(X, Y);
-                    if (TargetUnit && !TargetUnit->bIsPlayerUnit)
-                    {
-                        GridManager->HighlightCell(X, Y, true);
-                        HighlightedCount++;
-                    }
-                }
-            }
-        }
-    }
+            GridManager->HighlightCell(X, Y, true);
+        });
 }
 
 // Attempts to attack a target unit and processes the results
@@ -1510,11 +1436,8 @@ bool ASaT_HumanPlayer::TryAttackUnit(AUnit* AttackingUnit, AUnit* TargetUnit)
     int32 TargetX = TargetUnit->GridX;
     int32 TargetY = TargetUnit->GridY;
 
-    // Calculate Manhattan distance
-    int32 Distance = FMath::Abs(TargetX - AttackerX) + FMath::Abs(TargetY - AttackerY);
-
-    // Check if target is in range
-    if (Distance <= AttackingUnit->RangeAttack)
+    // Check if target is in range (and in sight, if the rule is on)
+    if (GridManager->CanAttackCell(AttackerX, AttackerY, TargetX, TargetY, AttackingUnit->RangeAttack))
     {
         // Save the target's health before attack for damage calculation
         int32 TargetHpBefore = TargetUnit->Hp;
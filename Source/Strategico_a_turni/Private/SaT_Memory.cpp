@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_Memory.h"
+#include "GridManager.h"
+#include "Sat_GameMode.h"
+#include "SaT_RandomPlayer.h"
+#include "EngineUtils.h"
+
+// Underscores become the tag hierarchy, so these show up as SaT/Grid, SaT/Tiles, ...
+LLM_DEFINE_TAG(SaT);
+LLM_DEFINE_TAG(SaT_Grid);
+LLM_DEFINE_TAG(SaT_Tiles);
+LLM_DEFINE_TAG(SaT_Pathfinding);
+LLM_DEFINE_TAG(SaT_AISearch);
+LLM_DEFINE_TAG(SaT_LogHUD);
+
+namespace
+{
+	// Budgets for the 25x25 board, loose enough that only leaks and runaway caches cross them
+	constexpr SIZE_T GridBudgetBytes = 1 * 1024 * 1024;
+	constexpr SIZE_T TilesBudgetBytes = 16 * 1024 * 1024;
+	constexpr SIZE_T PathfindingBudgetBytes = 4 * 1024 * 1024;
+	constexpr SIZE_T AISearchBudgetBytes = 16 * 1024 * 1024;
+	constexpr SIZE_T LogHUDBudgetBytes = 1 * 1024 * 1024;
+
+	int64 GetLLMTagBytes(FName TagName)
+	{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		if (FLowLevelMemTracker::IsEnabled())
+		{
+			return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, TagName, ELLMTagSet::None, UE::LLM::ESizeParams::ReportCurrent);
+		}
+#endif
+		return -1;
+	}
+
+	void AddCategory(TArray<FSaTMemoryCategory>& OutCategories, const TCHAR* Name, FName TagName, SIZE_T TrackedBytes, SIZE_T BudgetBytes)
+	{
+		FSaTMemoryCategory& Category = OutCategories.AddDefaulted_GetRef();
+		Category.Name = Name;
+		Category.TrackedBytes = TrackedBytes;
+		Category.LLMBytes = GetLLMTagBytes(TagName);
+		Category.BudgetBytes = BudgetBytes;
+	}
+}
+
+//----------------------------------------------
+// Budget Report
+//----------------------------------------------
+
+void FSaTMemoryBudget::Collect(UWorld* World, TArray<FSaTMemoryCategory>& OutCategories)
+{
+	OutCategories.Reset();
+
+	SIZE_T GridBytes = 0;
+	SIZE_T TileBytes = 0;
+	SIZE_T PathfindingBytes = 0;
+	SIZE_T AISearchBytes = 0;
+	SIZE_T LogHUDBytes = 0;
+
+	if (World)
+	{
+		for (TActorIterator<AGridManager> It(World); It; ++It)
+		{
+			const FGridTileReport Report = It->GetTileReport();
+			GridBytes += Report.ContainerBytes + It->GetGridStateAllocatedSize();
+			TileBytes += Report.TileActorBytes;
+			PathfindingBytes += It->GetPathfindingAllocatedSize();
+		}
+
+		for (TActorIterator<ASaT_RandomPlayer> It(World); It; ++It)
+		{
+			AISearchBytes += It->GetSearchAllocatedSize();
+		}
+
+		if (const ASaT_GameMode* GameMode = World->GetAuthGameMode<ASaT_GameMode>())
+		{
+			LogHUDBytes += GameMode->GetLogAllocatedSize();
+		}
+	}
+
+	AddCategory(OutCategories, TEXT("Grid"), LLMTagDeclaration_SaT_Grid.GetUniqueName(), GridBytes, GridBudgetBytes);
+	AddCategory(OutCategories, TEXT("Tiles"), LLMTagDeclaration_SaT_Tiles.GetUniqueName(), TileBytes, TilesBudgetBytes);
+	AddCategory(OutCategories, TEXT("Pathfinding"), LLMTagDeclaration_SaT_Pathfinding.GetUniqueName(), PathfindingBytes, PathfindingBudgetBytes);
+	AddCategory(OutCategories, TEXT("AISearch"), LLMTagDeclaration_SaT_AISearch.GetUniqueName(), AISearchBytes, AISearchBudgetBytes);
+	AddCategory(OutCategories, TEXT("LogHUD"), LLMTagDeclaration_SaT_LogHUD.GetUniqueName(), LogHUDBytes, LogHUDBudgetBytes);
+}
+
+void FSaTMemoryBudget::Log(UWorld* World)
+{
+	TArray<FSaTMemoryCategory> Categories;
+	Collect(World, Categories);
+
+	UE_LOG(LogTemp, Display, TEXT("%-12s %12s %12s %12s"), TEXT("Category"), TEXT("Tracked KB"), TEXT("LLM KB"), TEXT("Budget KB"));
+	for (const FSaTMemoryCategory& Category : Categories)
+	{
+		const FString LLMText = Category.LLMBytes >= 0 ? FString::Printf(TEXT("%.1f"), Category.LLMBytes / 1024.0) : FString(TEXT("n/a"));
+		UE_LOG(LogTemp, Display, TEXT("%-12s %12.1f %12s %12.1f"),
+			*Category.Name, Category.TrackedBytes / 1024.0, *LLMText, Category.BudgetBytes / 1024.0);
+
+		if (Category.IsOverBudget())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SaT/%s is over its memory budget"), *Category.Name);
+		}
+	}
+
+	if (Categories.Num() > 0 && Categories[0].LLMBytes < 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("LLM is not running; start with -llm for the per-tag totals"));
+	}
+}
@@ -3,6 +3,15 @@
 #include "SaT_RandomPlayer.h"
 #include "Kismet/GameplayStatics.h"
 #include "GridManager.h"
+#include "GridPathfinding.h"
+#include "GridPlacementScorer.h"
+#include "SaT_Stats.h"
+#include "SaT_TurnTelemetry.h"
+#include "SaT_Memory.h"
+#include "SaT_SearchStatsFeed.h"
+#include "SaT_EndgameTablebase.h"
+#include "SaT_CombatOdds.h"
+#include "SaT_TurnPonderer.h"
 #include "SaT_GameInstance.h"
 #include "Sniper.h"
 #include "Brawler.h"
@@ -66,6 +75,14 @@ void ASaT_RandomPlayer::BeginPlay()
     }
 }
 
+// Called when the player leaves the game - the ponder worker must not outlive the grid it reads
+void ASaT_RandomPlayer::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    Ponderer.Stop();
+
+    Super::EndPlay(EndPlayReason);
+}
+
 //  Called every frame to update AI state
 void ASaT_RandomPlayer::Tick(float DeltaTime)
 {
@@ -78,6 +95,10 @@ void ASaT_RandomPlayer::Tick(float DeltaTime)
  */
 void ASaT_RandomPlayer::OnTurn()
 {
+    // The human turn is over, so is pondering it; what it searched joins the planner table
+    Ponderer.Stop();
+    Ponderer.MergeTableInto(PlannerTable);
+
     AGameModeBase* GameModeBase = UGameplayStatics::GetGameMode(GetWorld());
     ASaT_GameMode* GameMode = Cast<ASaT_GameMode>(GameModeBase);
     if (GameMode)
@@ -112,6 +133,8 @@ void ASaT_RandomPlayer::OnTurn()
     // Explicitly set this player's turn flag to true
     IsMyTurn = true;
 
+    ApplyDifficultyProfile();
+
     // Check the game phase
     EGamePhase CurrentPhase = GameInstance->GetGamePhase();
 
@@ -146,11 +169,29 @@ void ASaT_RandomPlayer::OnTurn()
         AIUnits.Empty();
         FindAllAIUnits();
 
+        // Pick up the search of the last turn where the human's actions left the board
+        if (Profile.Algorithm == EAIAlgorithm::PLANNER)
+        {
+            ReRootFromEvents();
+            PlannerTable.NewGeneration();
+        }
+
         if (AIUnits.Num() > 0)
         {
             // Start the sequence of actions for all AI units
             CurrentUnitIndex = 0;
 
+            // The planner plans two or more units together
+            int32 AIUnitsAlive = 0;
+            for (AUnit* Unit : AIUnits)
+            {
+                if (Unit && Unit->IsAlive())
+                {
+                    AIUnitsAlive++;
+                }
+            }
+            bPlanTurnJointly = AIUnitsAlive >= 2 && Profile.Algorithm == EAIAlgorithm::PLANNER;
+
             // Schedule the first unit action
             FTimerHandle TimerHandle;
             GetWorld()->GetTimerManager().SetTimer(TimerHandle, this, &ASaT_RandomPlayer::ProcessNextAIUnit, 1.0f, false);
@@ -183,6 +224,9 @@ void ASaT_RandomPlayer::EndTurn()
     // Set his own IsMyTurn to false BEFORE calling GameMode->EndTurn()
     IsMyTurn = false;
 
+    // Think about the next turn while the human plays this one
+    StartPondering();
+
     // Get the game mode and tell it to end the turn
     AGameModeBase* GameModeBase = UGameplayStatics::GetGameMode(GetWorld());
     ASaT_GameMode* GameMode = Cast<ASaT_GameMode>(GameModeBase);
@@ -227,61 +271,61 @@ void ASaT_RandomPlayer::PlaceRandomUnit()
             return;
         }
 
-        // Find an empty cell randomly
-        int32 GridX, GridY;
-        bool bFoundEmptyCell = FindRandomEmptyCell(GridX, GridY);
-
-        if (bFoundEmptyCell)
-        {
-            // Randomly choose between Sniper and Brawler
-            bool bHasPlacedSniper = false;
-            bool bHasPlacedBrawler = false;
+        // Check which units already placed
+        bool bHasPlacedSniper = false;
+        bool bHasPlacedBrawler = false;
 
-            // Check which units already placed
-            TArray<AActor*> AllUnits;
-            UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+        TArray<AActor*> AllUnits;
+        UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+        INC_DWORD_STAT_BY(STAT_SaT_ActorsScanned, AllUnits.Num());
 
-            for (AActor* UnitActor : AllUnits)
+        for (AActor* UnitActor : AllUnits)
+        {
+            AUnit* Unit = Cast<AUnit>(UnitActor);
+            if (Unit && !Unit->bIsPlayerUnit) // Check AI units
             {
-                AUnit* Unit = Cast<AUnit>(UnitActor);
-                if (Unit && !Unit->bIsPlayerUnit) // Check AI units
+                if (Cast<ASniper>(Unit))
                 {
-                    if (Cast<ASniper>(Unit))
-                    {
-                        bHasPlacedSniper = true;
-                    }
-                    else if (Cast<ABrawler>(Unit))
-                    {
-                        bHasPlacedBrawler = true;
-                    }
+                    bHasPlacedSniper = true;
+                }
+                else if (Cast<ABrawler>(Unit))
+                {
+                    bHasPlacedBrawler = true;
                 }
             }
+        }
 
-            // Determine which unit to place
-            bool bIsSniper;
+        // Determine which unit to place
+        bool bIsSniper;
 
-            // If he hasn't placed either, randomly choose
-            if (!bHasPlacedSniper && !bHasPlacedBrawler)
-            {
-                bIsSniper = (FMath::RandBool()); // 50% chance for either
-            }
-            // If he has placed Sniper but not Brawler, place Brawler
-            else if (bHasPlacedSniper && !bHasPlacedBrawler)
-            {
-                bIsSniper = false;
-            }
-            // If he has placed Brawler but not Sniper, place Sniper
-            else if (!bHasPlacedSniper && bHasPlacedBrawler)
-            {
-                bIsSniper = true;
-            }
-            // Just in case both are already placed
-            else
-            {
-                EndTurn();
-                return;
-            }
+        // If he hasn't placed either, randomly choose
+        if (!bHasPlacedSniper && !bHasPlacedBrawler)
+        {
+            bIsSniper = (FMath::RandBool()); // 50% chance for either
+        }
+        // If he has placed Sniper but not Brawler, place Brawler
+        else if (bHasPlacedSniper && !bHasPlacedBrawler)
+        {
+            bIsSniper = false;
+        }
+        // If he has placed Brawler but not Sniper, place Sniper
+        else if (!bHasPlacedSniper && bHasPlacedBrawler)
+        {
+            bIsSniper = true;
+        }
+        // Just in case both are already placed
+        else
+        {
+            EndTurn();
+            return;
+        }
+
+        // Score every free cell for this unit and take the best one
+        int32 GridX, GridY;
+        bool bFoundEmptyCell = FindBestPlacementCell(bIsSniper, GridX, GridY);
 
+        if (bFoundEmptyCell)
+        {
             // Check if class references are valid
             if (bIsSniper && !SniperClass)
             {
@@ -364,45 +408,75 @@ void ASaT_RandomPlayer::PlaceRandomUnit()
 }
 
 /*
- * Finds a random empty cell on the grid
+ * Finds the best free cell to place a unit on with the placement scorer
+ * Cells are scored against the player units already placed, the AI's own units and the player's threat
+ * @param bIsSniper - Type of the unit to place
  * @param OutGridX - Output parameter for grid X coordinate
  * @param OutGridY - Output parameter for grid Y coordinate
- * @return True if an empty cell was found, false otherwise
+ * @return True if a free cell was found, which is always the case while the board has one
  */
-bool ASaT_RandomPlayer::FindRandomEmptyCell(int32& OutGridX, int32& OutGridY)
+bool ASaT_RandomPlayer::FindBestPlacementCell(bool bIsSniper, int32& OutGridX, int32& OutGridY)
 {
+    SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_AIDecision);
+    LLM_SCOPE_BYTAG(SaT_AISearch);
+
     if (!GridManager) return false;
 
-    // Grid size
-    int32 GridSize = 25;
+    // Stats of the unit about to be spawned, from its Blueprint class when there is one
+    const AUnit* UnitDefaults = nullptr;
+    if (bIsSniper)
+    {
+        UnitDefaults = SniperClass ? SniperClass.GetDefaultObject() : GetDefault<ASniper>();
+    }
+    else
+    {
+        UnitDefaults = BrawlerClass ? BrawlerClass.GetDefaultObject() : GetDefault<ABrawler>();
+    }
 
-    // Maximum number of attempts to find an empty cell
-    const int32 MaxAttempts = 100;
+    FGridPlacementRequest Request;
+    Request.Movement = UnitDefaults->Movement;
+    Request.Range = UnitDefaults->RangeAttack;
 
-    for (int32 Attempt = 0; Attempt < MaxAttempts; Attempt++)
+    TArray<AActor*> AllUnits;
+    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+    INC_DWORD_STAT_BY(STAT_SaT_ActorsScanned, AllUnits.Num());
+
+    for (AActor* UnitActor : AllUnits)
     {
-        // Generate random coordinates
-        OutGridX = FMath::RandRange(0, GridSize - 1);
-        OutGridY = FMath::RandRange(0, GridSize - 1);
+        AUnit* Unit = Cast<AUnit>(UnitActor);
+        if (Unit && Unit->IsAlive())
+        {
+            FGridPlacementUnit& Placed = Unit->bIsPlayerUnit ? Request.Enemies.AddDefaulted_GetRef() : Request.Allies.AddDefaulted_GetRef();
+            Placed.GridX = Unit->GridX;
+            Placed.GridY = Unit->GridY;
+        }
+    }
 
-        // Double-check if cell is free from both occupation AND obstacles
-        if (!GridManager->IsCellOccupied(OutGridX, OutGridY))
+    // Expected damage the placed player units could deal to each cell
+    if (Request.Enemies.Num() > 0)
+    {
+        const FGridInfluenceMap& InfluenceMap = GridManager->GetInfluenceMap();
+        Request.Threat.SetNumUninitialized(GridManager->Size * GridManager->Size);
+        for (int32 Y = 0; Y < GridManager->Size; Y++)
         {
-            // Additional obstacle check to be absolutely sure
-            ATile* Tile = nullptr;
-            if (GridManager->TileMap.Contains(FVector2D(OutGridX, OutGridY)))
+            for (int32 X = 0; X < GridManager->Size; X++)
             {
-                Tile = GridManager->TileMap[FVector2D(OutGridX, OutGridY)];
-                if (Tile && !Tile->bIsObstacle && !Tile->bIsOccupied)
-                {
-                    // Triple check - this position is definitely valid
-                    return true;
-                }
+                Request.Threat[Y * GridManager->Size + X] = InfluenceMap.GetDamageReceivable(X, Y, false);
             }
         }
     }
 
-    return false;
+    // Units block, so the passable cells are exactly the free ones
+    GridManager->BuildSearchGrid(SearchGrid, true);
+    float Score = 0.0f;
+    if (!FGridPlacementScorer::FindBestCell(SearchGrid, Request, OutGridX, OutGridY, &Score))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("AI: No free cell left to place a unit"));
+        return false;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("AI: Placing %s at (%d, %d), score %.2f"), bIsSniper ? TEXT("Sniper") : TEXT("Brawler"), OutGridX, OutGridY, Score);
+    return true;
 }
 
 /*
@@ -414,6 +488,7 @@ void ASaT_RandomPlayer::FindAllAIUnits()
     // Get all unit actors in the world
     TArray<AActor*> AllUnits;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+    INC_DWORD_STAT_BY(STAT_SaT_ActorsScanned, AllUnits.Num());
 
     // Filter for AI-controlled units
     for (AActor* UnitActor : AllUnits)
@@ -440,6 +515,9 @@ void ASaT_RandomPlayer::ProcessNextAIUnit()
 
     if (CurrentUnitIndex < AIUnits.Num())
     {
+        // The plan decides which unit acts next
+        PlanRemainingUnits();
+
         AUnit* CurrentUnit = AIUnits[CurrentUnitIndex];
         if (CurrentUnit && CurrentUnit->IsAlive())
         {
@@ -466,23 +544,79 @@ void ASaT_RandomPlayer::ProcessNextAIUnit()
     }
 }
 
+/*
+ * Takes the difficulty profile of the current difficulty from the difficulty settings
+ * A config change is picked up at the next AI turn
+ */
+void ASaT_RandomPlayer::ApplyDifficultyProfile()
+{
+    const EAIDifficulty Difficulty = GameInstance ? GameInstance->AIDifficulty : EAIDifficulty::HARD;
+    Profile = USaT_DifficultySettings::GetProfile(Difficulty);
+}
+
 /*
  * Process actions for a specific AI unit based on difficulty setting
  * @param Unit - The AI unit to process actions for
  */
 void ASaT_RandomPlayer::ProcessUnitActions(AUnit* Unit)
 {
-    // Check the current difficulty setting
-    if (GameInstance && GameInstance->AIDifficulty == EAIDifficulty::EASY)
+    SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_AIDecision);
+    SAT_TELEMETRY_SCOPE(AIDecisionMs);
+    LLM_SCOPE_BYTAG(SaT_AISearch);
+
+    // Feed the "AI thinking" widget while the decision runs
+    ASaT_GameMode* GameMode = Cast<ASaT_GameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+    SearchFeed = GameMode ? &GameMode->GetAISearchFeed() : nullptr;
+    if (SearchFeed)
+    {
+        // Only the planner searches under a time budget
+        SearchFeed->BeginSearch(Profile.Algorithm == EAIAlgorithm::PLANNER ? Profile.TurnPlanBudgetMs : 0.0f);
+    }
+
+    // Check the algorithm of the difficulty profile
+    if (Profile.Algorithm == EAIAlgorithm::RANDOM)
     {
-        // Use random behavior for Easy mode
+        // Use random behavior (Easy mode by default)
         ProcessUnitActionsRandom(Unit);
     }
     else
     {
-        // Use strategic A* pathfinding for Hard mode
+        // Use strategic pathfinding, with the joint plan for the planner (Hard mode by default)
         ProcessUnitActionsStrategic(Unit);
     }
+
+    if (SearchFeed)
+    {
+        SearchFeed->FinishSearch();
+        SearchFeed = nullptr;
+    }
+}
+
+/*
+ * Records a move as the best line of the running decision
+ * @param AIUnit - The unit that moves
+ * @param ToX, ToY - Destination cell (the unit's own cell to attack without moving)
+ * @param Target - Attacked unit, or null for a plain move
+ * @param Score - Score of the move, higher is better
+ */
+void ASaT_RandomPlayer::ReportSearchMove(AUnit* AIUnit, int32 ToX, int32 ToY, const AUnit* Target, float Score)
+{
+    if (!SearchFeed || !AIUnit)
+    {
+        return;
+    }
+
+    FSaTSearchSnapshot& Snapshot = SearchFeed->GetSnapshot();
+    FSaTSearchMove& Move = Snapshot.PV[0];
+    Move.FromX = AIUnit->GridX;
+    Move.FromY = AIUnit->GridY;
+    Move.ToX = ToX;
+    Move.ToY = ToY;
+    Move.TargetX = Target ? Target->GridX : -1;
+    Move.TargetY = Target ? Target->GridY : -1;
+    Snapshot.PVLength = 1;
+    Snapshot.Depth = 1;
+    Snapshot.BestScore = Score;
 }
 
 /*
@@ -651,31 +785,11 @@ void ASaT_RandomPlayer::ProcessUnitActionsRandom(AUnit* Unit)
  */
 AUnit* ASaT_RandomPlayer::FindRandomAttackTarget(AUnit* AIUnit)
 {
-    if (!AIUnit) return nullptr;
-
-    // Get all player units
-    TArray<AActor*> AllUnits;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+    if (!AIUnit || !GridManager) return nullptr;
 
     // Find player units in attack range
     TArray<AUnit*> PotentialTargets;
-
-    for (AActor* UnitActor : AllUnits)
-    {
-        AUnit* PlayerUnit = Cast<AUnit>(UnitActor);
-        if (PlayerUnit && PlayerUnit->bIsPlayerUnit && PlayerUnit->IsAlive())
-        {
-            // Calculate Manhattan distance
-            int32 Distance = FMath::Abs(PlayerUnit->GridX - AIUnit->GridX) +
-                FMath::Abs(PlayerUnit->GridY - AIUnit->GridY);
-
-            // Check if within attack range
-            if (Distance <= AIUnit->RangeAttack)
-            {
-                PotentialTargets.Add(PlayerUnit);
-            }
-        }
-    }
+    CollectTargetsInRange(AIUnit, PotentialTargets);
 
     // If he has targets, select a random one
     if (PotentialTargets.Num() > 0)
@@ -716,6 +830,10 @@ bool ASaT_RandomPlayer::MoveRandomly(AUnit* Unit)
     // Store valid move options
     TArray<FVector2D> ValidMoves;
 
+    // On weighted terrain the Manhattan distance underestimates the cost, so also check the real reach
+    const bool bWeightedTerrain = GridManager->HasWeightedTerrain();
+    const FGridBitboard ReachableCells = bWeightedTerrain ? GridManager->GetReachableCells(UnitX, UnitY, MovementRange) : FGridBitboard();
+
     // Collect potential moves within movement range
     for (int32 X = UnitX - MovementRange; X <= UnitX + MovementRange; X++)
     {
@@ -738,7 +856,7 @@ bool ASaT_RandomPlayer::MoveRandomly(AUnit* Unit)
                 // Validate the entire path between current position and target
                 bool bPathClear = IsPathClear(UnitX, UnitY, X, Y);
 
-                if (bPathClear && !GridManager->IsCellOccupied(X, Y))
+                if (bPathClear && !GridManager->IsCellOccupied(X, Y) && (!bWeightedTerrain || ReachableCells.Test(X, Y)))
                 {
                     ValidMoves.Add(FVector2D(X, Y));
                 }
@@ -871,7 +989,41 @@ void ASaT_RandomPlayer::ProcessUnitActionsStrategic(AUnit* Unit)
         return;
     }
 
-    // First try to attack without moving
+    // A solved 1v1 is played from the endgame tablebase
+    if (Profile.bUseEndgameTablebase && PlayEndgameTurn(Unit))
+    {
+        return;
+    }
+
+    // Several units are played from the joint plan of the turn
+    if (PlayPlannedAction(Unit))
+    {
+        return;
+    }
+
+    // Pick the least exposed cell this unit can attack from, moving there first if needed
+    int32 AttackX = Unit->GridX;
+    int32 AttackY = Unit->GridY;
+    AUnit* SafeTarget = nullptr;
+    if (!Unit->bHasAttackedThisTurn && FindSafeAttackPosition(Unit, AttackX, AttackY, SafeTarget))
+    {
+        if (AttackX != Unit->GridX || AttackY != Unit->GridY)
+        {
+            TArray<FVector2D> Path;
+            if (GridManager->FindPathWithin(Unit->GridX, Unit->GridY, AttackX, AttackY, Unit->Movement, Path))
+            {
+                ExecuteMove(Unit, Path);
+            }
+        }
+
+        if (Unit->IsTargetInRange(SafeTarget))
+        {
+            ExecuteAttack(Unit, SafeTarget);
+            return;
+        }
+    }
+
+    // Otherwise try to attack without moving
     AUnit* TargetWithoutMoving = FindAttackTarget(Unit);
 
     // If he can attack now, do it
@@ -905,7 +1057,7 @@ void ASaT_RandomPlayer::ProcessUnitActionsStrategic(AUnit* Unit)
     // If he can't attack now but hasn't moved yet, move strategically toward a player unit
     else if (!Unit->bHasMovedThisTurn)
     {
-        // Use A* pathing to move toward a player unit
+        // Sweep path distances and move toward the nearest attack square
         MoveTowardPlayerUnit(Unit);
 
         // After moving, check if he can attack
@@ -944,6 +1096,469 @@ void ASaT_RandomPlayer::ProcessUnitActionsStrategic(AUnit* Unit)
     }
 }
 
+/*
+ * Plays the last AI unit against the last player unit from the endgame tablebase
+ * Every reachable cell is rated as the end of the turn, with an attack from it when the target is in range;
+ * attacking first is rated with the move after it picked once the rolls are known
+ * @param AIUnit - The AI unit to play
+ * @return False if this is not a 1v1, the unit already acted or the table is not ready
+ */
+bool ASaT_RandomPlayer::PlayEndgameTurn(AUnit* AIUnit)
+{
+    const FSaTEndgameTablebase& Tablebase = FSaTEndgameTablebase::Get();
+    if (!Tablebase.IsReady() || !GridManager ||
+        AIUnit->bHasMovedThisTurn || AIUnit->bHasAttackedThisTurn)
+    {
+        return false;
+    }
+
+    int32 AIUnitsAlive = 0;
+    for (AUnit* Unit : AIUnits)
+    {
+        AIUnitsAlive += (Unit && Unit->IsAlive()) ? 1 : 0;
+    }
+
+    TArray<AUnit*> PlayerUnits;
+    CollectPlayerUnits(PlayerUnits);
+    if (AIUnitsAlive != 1 || PlayerUnits.Num() != 1)
+    {
+        return false;
+    }
+
+    AUnit* Enemy = PlayerUnits[0];
+    const EPieceUnit OwnType = FSaTEndgameTablebase::GetPieceType(AIUnit);
+    const EPieceUnit EnemyType = FSaTEndgameTablebase::GetPieceType(Enemy);
+    if (OwnType == EPieceUnit::NONE || EnemyType == EPieceUnit::NONE)
+    {
+        return false;
+    }
+
+    // Staying put without attacking
+    int32 BestX = AIUnit->GridX;
+    int32 BestY = AIUnit->GridY;
+    const int32 Distance = FMath::Abs(Enemy->GridX - BestX) + FMath::Abs(Enemy->GridY - BestY);
+    FSaTEndgameValue Best = Tablebase.EvaluatePass(OwnType, EnemyType, AIUnit->Hp, Enemy->Hp, Distance);
+    bool bBestAttacks = false;
+    bool bAttackFirst = false;
+
+    if (GridManager->CanAttackCell(AIUnit->GridX, AIUnit->GridY, Enemy->GridX, Enemy->GridY, AIUnit->RangeAttack))
+    {
+        const FSaTEndgameValue Value = Tablebase.EvaluateAttack(OwnType, EnemyType, AIUnit->Hp, Enemy->Hp, Distance, true);
+        if (Value.GetScore() > Best.GetScore())
+        {
+            Best = Value;
+            bBestAttacks = true;
+            bAttackFirst = true;
+        }
+    }
+
+    GridManager->GetReachableCells(AIUnit->GridX, AIUnit->GridY, AIUnit->Movement).ForEachSetCell([&](int32 X, int32 Y)
+        {
+            const int32 CellDistance = FMath::Abs(Enemy->GridX - X) + FMath::Abs(Enemy->GridY - Y);
+            const FSaTEndgameValue Pass = Tablebase.EvaluatePass(OwnType, EnemyType, AIUnit->Hp, Enemy->Hp, CellDistance);
+            if (Pass.GetScore() > Best.GetScore())
+            {
+                Best = Pass;
+                BestX = X;
+                BestY = Y;
+                bBestAttacks = false;
+                bAttackFirst = false;
+            }
+
+            if (GridManager->CanAttackCell(X, Y, Enemy->GridX, Enemy->GridY, AIUnit->RangeAttack))
+            {
+                const FSaTEndgameValue Attack = Tablebase.EvaluateAttack(OwnType, EnemyType, AIUnit->Hp, Enemy->Hp, CellDistance, false);
+                if (Attack.GetScore() > Best.GetScore())
+                {
+                    Best = Attack;
+                    BestX = X;
+                    BestY = Y;
+                    bBestAttacks = true;
+                    bAttackFirst = false;
+                }
+            }
+
+            if (SearchFeed)
+            {
+                SearchFeed->GetSnapshot().NodesSearched++;
+                SearchFeed->Update();
+            }
+        });
+
+    ReportSearchMove(AIUnit, BestX, BestY, bBestAttacks ? Enemy : nullptr, Best.GetScore());
+    UE_LOG(LogTemp, Display, TEXT("AI: Endgame move to (%d, %d)%s, win %.2f loss %.2f"),
+        BestX, BestY, bBestAttacks ? TEXT(" with attack") : TEXT(""), Best.Win, Best.Loss);
+
+    if (bAttackFirst)
+    {
+        ExecuteAttack(AIUnit, Enemy);
+        if (AIUnit->IsAlive() && Enemy->IsAlive())
+        {
+            MoveToBestEndgameCell(AIUnit, Enemy);
+        }
+        return true;
+    }
+
+    if (BestX != AIUnit->GridX || BestY != AIUnit->GridY)
+    {
+        TArray<FVector2D> Path;
+        if (GridManager->FindPathWithin(AIUnit->GridX, AIUnit->GridY, BestX, BestY, AIUnit->Movement, Path))
+        {
+            ExecuteMove(AIUnit, Path);
+        }
+    }
+
+    if (bBestAttacks && AIUnit->IsTargetInRange(Enemy))
+    {
+        ExecuteAttack(AIUnit, Enemy);
+    }
+    return true;
+}
+
+/*
+ * Moves to the reachable cell with the best endgame value for ending the turn, after the unit attacked
+ * @param AIUnit - The AI unit to move
+ * @param Enemy - The last player unit
+ */
+void ASaT_RandomPlayer::MoveToBestEndgameCell(AUnit* AIUnit, AUnit* Enemy)
+{
+    const FSaTEndgameTablebase& Tablebase = FSaTEndgameTablebase::Get();
+    const EPieceUnit OwnType = FSaTEndgameTablebase::GetPieceType(AIUnit);
+    const EPieceUnit EnemyType = FSaTEndgameTablebase::GetPieceType(Enemy);
+
+    int32 BestX = AIUnit->GridX;
+    int32 BestY = AIUnit->GridY;
+    FSaTEndgameValue Best = Tablebase.EvaluatePass(OwnType, EnemyType, AIUnit->Hp, Enemy->Hp,
+        FMath::Abs(Enemy->GridX - BestX) + FMath::Abs(Enemy->GridY - BestY));
+
+    GridManager->GetReachableCells(AIUnit->GridX, AIUnit->GridY, AIUnit->Movement).ForEachSetCell([&](int32 X, int32 Y)
+        {
+            const FSaTEndgameValue Value = Tablebase.EvaluatePass(OwnType, EnemyType, AIUnit->Hp, Enemy->Hp,
+                FMath::Abs(Enemy->GridX - X) + FMath::Abs(Enemy->GridY - Y));
+            if (Value.GetScore() > Best.GetScore())
+            {
+                Best = Value;
+                BestX = X;
+                BestY = Y;
+            }
+        });
+
+    TArray<FVector2D> Path;
+    if ((BestX != AIUnit->GridX || BestY != AIUnit->GridY) &&
+        GridManager->FindPathWithin(AIUnit->GridX, AIUnit->GridY, BestX, BestY, AIUnit->Movement, Path))
+    {
+        ExecuteMove(AIUnit, Path);
+    }
+}
+
+/*
+ * Plans the AI units that have not acted yet together with the turn planner
+ * The plan is searched again before each unit, since the rolls of the units before it are known by then;
+ * the first unit of the plan is swapped to CurrentUnitIndex and its action kept for PlayPlannedAction
+ */
+void ASaT_RandomPlayer::PlanRemainingUnits()
+{
+    TurnPlan = FSaTTurnPlan();
+    TurnPlanUnits.Reset();
+    if (!bPlanTurnJointly || !GridManager)
+    {
+        return;
+    }
+
+    TArray<AUnit*> PlayerUnits;
+    CollectPlayerUnits(PlayerUnits);
+    if (PlayerUnits.Num() == 0)
+    {
+        return;
+    }
+
+    // Player units in the order of the board the last turn left, which the pondered plans and table entries use
+    PlayerUnits.StableSort([this](const AUnit& A, const AUnit& B)
+        {
+            return uint32(LastBoardUnits.Find(const_cast<AUnit*>(&A))) < uint32(LastBoardUnits.Find(const_cast<AUnit*>(&B)));
+        });
+
+    SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_AIDecision);
+    SAT_TELEMETRY_SCOPE(AIDecisionMs);
+    LLM_SCOPE_BYTAG(SaT_AISearch);
+
+    // AI units in processing order, the ones that already acted only block; then the player units
+    TArray<FSaTPlannerUnit> Units;
+    for (int32 Index = 0; Index < AIUnits.Num(); Index++)
+    {
+        if (AIUnits[Index] && AIUnits[Index]->IsAlive())
+        {
+            TurnPlanUnits.Add(AIUnits[Index]);
+            Units.AddDefaulted().bHasActed = Index < CurrentUnitIndex;
+        }
+    }
+    for (AUnit* PlayerUnit : PlayerUnits)
+    {
+        TurnPlanUnits.Add(PlayerUnit);
+        Units.AddDefaulted();
+    }
+    FillPlannerUnits(TurnPlanUnits, Units);
+
+    // The first plan of the turn may have been found while the human played
+    if (CurrentUnitIndex == 0 && !Ponderer.IsRunning() && Ponderer.Find(Units, TurnPlan))
+    {
+        UE_LOG(LogTemp, Log, TEXT("AI: Playing the turn plan pondered during the human turn (%d boards pondered)"),
+            Ponderer.GetNumPonderedBoards());
+    }
+    else
+    {
+        GridManager->BuildSearchGrid(SearchGrid, false);
+        TurnPlan = FSaTTurnPlanner::Plan(SearchGrid, Units, MakePlannerSettings(), [this](int32 FromX, int32 FromY, int32 ToX, int32 ToY, int32 Range)
+            {
+                return GridManager->CanAttackCell(FromX, FromY, ToX, ToY, Range);
+            });
+    }
+
+    if (TurnPlan.Actions.Num() == 0)
+    {
+        return;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("AI: Turn plan of %d units, %d plans, %lld nodes and %d table hits in %.2f ms%s, score %.2f"),
+        TurnPlan.Actions.Num(), TurnPlan.PlansEvaluated, TurnPlan.NodesSearched, TurnPlan.TableHits, TurnPlan.ElapsedMs,
+        TurnPlan.bBudgetExhausted ? TEXT(" (budget exhausted)") : TEXT(""), TurnPlan.Score);
+
+    const int32 Slot = AIUnits.Find(TurnPlanUnits[TurnPlan.Actions[0].UnitIndex]);
+    if (Slot != INDEX_NONE && Slot != CurrentUnitIndex)
+    {
+        AIUnits.Swap(Slot, CurrentUnitIndex);
+    }
+}
+
+/*
+ * Copies the state of units into planner units
+ * @param Actors - The units; OutUnits keeps their order
+ * @param OutUnits - Planner units, already sized like Actors; acted flags are left as they are
+ */
+void ASaT_RandomPlayer::FillPlannerUnits(const TArray<AUnit*>& Actors, TArray<FSaTPlannerUnit>& OutUnits) const
+{
+    for (int32 Index = 0; Index < Actors.Num(); Index++)
+    {
+        const AUnit* Unit = Actors[Index];
+        FSaTPlannerUnit& PlannerUnit = OutUnits[Index];
+        PlannerUnit.Type = FSaTCombatOdds::GetPieceType(Unit);
+        PlannerUnit.GridX = Unit->GridX;
+        PlannerUnit.GridY = Unit->GridY;
+        PlannerUnit.Hp = Unit->Hp;
+        PlannerUnit.Movement = Unit->Movement;
+        PlannerUnit.Range = Unit->RangeAttack;
+        PlannerUnit.MinDamage = Unit->MinDamage;
+        PlannerUnit.MaxDamage = Unit->MaxDamage;
+        PlannerUnit.bIsPlayerUnit = Unit->bIsPlayerUnit;
+    }
+}
+
+/*
+ * Replays the game events since the end of the last AI turn on the board it left, to find the board of this turn
+ * If the replayed board is the actual one, the AI units are put back in that board's order, so the pondered plans and
+ * the planner table entries of the last turn keep matching unit for unit
+ * @return True if the events led to the actual board
+ */
+bool ASaT_RandomPlayer::ReRootFromEvents()
+{
+    const ASaT_GameMode* GameMode = Cast<ASaT_GameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+    if (!GameMode || LastBoardUnits.Num() == 0 || GameMode->GetGameEvents().Num() < LastEventCount)
+    {
+        return false;
+    }
+
+    const TArray<FSaTGameEvent>& Events = GameMode->GetGameEvents();
+    TArray<FSaTPlannerUnit> Board = LastBoard;
+    for (int32 Index = LastEventCount; Index < Events.Num(); Index++)
+    {
+        ApplyGameEvent(Board, Events[Index]);
+    }
+
+    // Every unit must be where the events put it, and no AI unit may have appeared since
+    int32 AIUnitsAlive = 0;
+    for (int32 Index = 0; Index < Board.Num(); Index++)
+    {
+        const AUnit* Unit = LastBoardUnits[Index];
+        const bool bAlive = IsValid(Unit) && Unit->IsAlive();
+        if (bAlive != (Board[Index].AliveChance > 0.0f) ||
+            (bAlive && (Unit->GridX != Board[Index].GridX || Unit->GridY != Board[Index].GridY || Unit->Hp != Board[Index].Hp)))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("AI: The event log does not lead to the board, planning from scratch"));
+            return false;
+        }
+        AIUnitsAlive += bAlive && !Board[Index].bIsPlayerUnit ? 1 : 0;
+    }
+    if (AIUnitsAlive != AIUnits.Num())
+    {
+        return false;
+    }
+
+    AIUnits.Reset();
+    for (int32 Index = 0; Index < Board.Num(); Index++)
+    {
+        if (Board[Index].AliveChance > 0.0f && !Board[Index].bIsPlayerUnit)
+        {
+            AIUnits.Add(LastBoardUnits[Index]);
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("AI: Re-rooted the search after %d events, %d boards in the planner table"),
+        Events.Num() - LastEventCount, PlannerTable.Num());
+    return true;
+}
+
+/*
+ * Plays one logged action on a planner board; units are found by side and cell
+ * @param Board - Board to update; a unit that loses its last hit points is marked dead
+ * @param Event - The action
+ */
+void ASaT_RandomPlayer::ApplyGameEvent(TArray<FSaTPlannerUnit>& Board, const FSaTGameEvent& Event)
+{
+    auto FindUnit = [&Board](bool bIsPlayerUnit, int32 X, int32 Y) -> FSaTPlannerUnit*
+        {
+            return Board.FindByPredicate([=](const FSaTPlannerUnit& Unit)
+                {
+                    return Unit.AliveChance > 0.0f && Unit.bIsPlayerUnit == bIsPlayerUnit && Unit.GridX == X && Unit.GridY == Y;
+                });
+        };
+
+    if (Event.Type == FSaTGameEvent::EType::Move)
+    {
+        if (FSaTPlannerUnit* Unit = FindUnit(Event.bIsPlayerUnit, Event.FromX, Event.FromY))
+        {
+            Unit->GridX = Event.ToX;
+            Unit->GridY = Event.ToY;
+        }
+    }
+    else if (Event.Type == FSaTGameEvent::EType::Attack || Event.Type == FSaTGameEvent::EType::Counterattack)
+    {
+        if (FSaTPlannerUnit* Unit = FindUnit(!Event.bIsPlayerUnit, Event.ToX, Event.ToY))
+        {
+            Unit->Hp = FMath::Max(0.0f, Unit->Hp - Event.Damage);
+            Unit->AliveChance = Unit->Hp > 0.0f ? 1.0f : 0.0f;
+        }
+    }
+}
+
+/*
+ * Returns the planner settings of this AI, with the planner table it keeps across turns
+ */
+FSaTTurnPlannerSettings ASaT_RandomPlayer::MakePlannerSettings()
+{
+    FSaTTurnPlannerSettings Settings;
+    Settings.BudgetMs = Profile.TurnPlanBudgetMs;
+    Settings.MaxActionsPerUnit = FMath::Max(1, Profile.MaxActionsPerUnit);
+    Settings.MaxPlannedUnits = Profile.MaxPlannedUnits;
+    Settings.Temperature = FMath::Max(0.0f, Profile.Temperature);
+    Settings.RandomSeed = FMath::Rand();
+    Settings.Weights = GetDefault<USaT_DifficultySettings>()->GetEvalWeights();
+    Settings.Table = &PlannerTable;
+    Settings.RulesKey = GridManager && GridManager->bRequireLineOfSight ? 1 : 0;
+    return Settings;
+}
+
+/*
+ * Remembers the board this turn left and starts pondering the next AI turn on it, while the human plays
+ * The board is taken in the order PlanRemainingUnits builds it at the start of the next turn, so pondered plans match
+ */
+void ASaT_RandomPlayer::StartPondering()
+{
+    LastBoard.Reset();
+    LastBoardUnits.Reset();
+    if (!GridManager || !GameInstance ||
+        Profile.Algorithm != EAIAlgorithm::PLANNER || GameInstance->GetGamePhase() != EGamePhase::PLAYING)
+    {
+        return;
+    }
+
+    AIUnits.Empty();
+    FindAllAIUnits();
+    TArray<AUnit*> PlayerUnits;
+    CollectPlayerUnits(PlayerUnits);
+    if (AIUnits.Num() < 2 || PlayerUnits.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<AUnit*> Actors = AIUnits;
+    Actors.Append(PlayerUnits);
+    TArray<FSaTPlannerUnit> Units;
+    Units.SetNum(Actors.Num());
+    FillPlannerUnits(Actors, Units);
+
+    // The next turn re-roots here with the events logged from now on
+    const ASaT_GameMode* GameMode = Cast<ASaT_GameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+    LastBoard = Units;
+    LastBoardUnits = Actors;
+    LastEventCount = GameMode ? GameMode->GetGameEvents().Num() : 0;
+
+    if (!Profile.bPonderDuringHumanTurn)
+    {
+        return;
+    }
+
+    // The worker gets its own copies of the board and the sight tables, the grid may change while the human plays
+    GridManager->BuildSearchGrid(SearchGrid, false);
+    Ponderer.Start(SearchGrid, GridManager->GetLineOfSight(), GridManager->bRequireLineOfSight, Units, MakePlannerSettings());
+}
+
+/*
+ * Plays the first action of the turn plan: the move, then the attack if the target is still there and in range
+ * @param AIUnit - The AI unit to play
+ * @return False if the plan has no action for the unit or its destination cannot be reached
+ */
+bool ASaT_RandomPlayer::PlayPlannedAction(AUnit* AIUnit)
+{
+    if (TurnPlan.Actions.Num() == 0 || TurnPlanUnits[TurnPlan.Actions[0].UnitIndex] != AIUnit ||
+        AIUnit->bHasMovedThisTurn || AIUnit->bHasAttackedThisTurn)
+    {
+        return false;
+    }
+
+    // The whole plan is the principal variation of the decision
+    if (SearchFeed)
+    {
+        FSaTSearchSnapshot& Snapshot = SearchFeed->GetSnapshot();
+        Snapshot.NodesSearched += TurnPlan.NodesSearched;
+        Snapshot.PVLength = FMath::Min(TurnPlan.Actions.Num(), FSaTSearchSnapshot::MaxPVLength);
+        for (int32 Index = 0; Index < Snapshot.PVLength; Index++)
+        {
+            const FSaTPlannedAction& Planned = TurnPlan.Actions[Index];
+            const AUnit* PlannedUnit = TurnPlanUnits[Planned.UnitIndex];
+            FSaTSearchMove& Move = Snapshot.PV[Index];
+            Move.FromX = PlannedUnit->GridX;
+            Move.FromY = PlannedUnit->GridY;
+            Move.ToX = Planned.ToX;
+            Move.ToY = Planned.ToY;
+            Move.TargetX = Planned.TargetX;
+            Move.TargetY = Planned.TargetY;
+        }
+        Snapshot.Depth = Snapshot.PVLength;
+        Snapshot.BestScore = TurnPlan.Score;
+    }
+
+    // Only the first action is played; the next unit is planned again with the rolls of this one
+    const FSaTPlannedAction Action = TurnPlan.Actions[0];
+    TurnPlan.Actions.Reset();
+
+    if (Action.ToX != AIUnit->GridX || Action.ToY != AIUnit->GridY)
+    {
+        TArray<FVector2D> Path;
+        if (!GridManager->FindPathWithin(AIUnit->GridX, AIUnit->GridY, Action.ToX, Action.ToY, AIUnit->Movement, Path))
+        {
+            return false;
+        }
+        ExecuteMove(AIUnit, Path);
+    }
+
+    AUnit* Target = Action.TargetX >= 0 ? GridManager->GetUnitAt(Action.TargetX, Action.TargetY) : nullptr;
+    if (Target && Target->bIsPlayerUnit && Target->IsAlive() && AIUnit->IsTargetInRange(Target))
+    {
+        ExecuteAttack(AIUnit, Target);
+    }
+    return true;
+}
+
 /*
  * Calculates Manhattan distance between two grid positions
  * @param A - First position
@@ -964,31 +1579,11 @@ int32 ASaT_RandomPlayer::ManhattanDistance(const FVector2D& A, const FVector2D&
  */
 AUnit* ASaT_RandomPlayer::FindAttackTarget(AUnit* AIUnit)
 {
-    if (!AIUnit) return nullptr;
-
-    // Get all player units
-    TArray<AActor*> AllUnits;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+    if (!AIUnit || !GridManager) return nullptr;
 
     // Find player units in attack range, prioritizing the weakest ones
     TArray<AUnit*> PotentialTargets;
-
-    for (AActor* UnitActor : AllUnits)
-    {
-        AUnit* PlayerUnit = Cast<AUnit>(UnitActor);
-        if (PlayerUnit && PlayerUnit->bIsPlayerUnit && PlayerUnit->IsAlive())
-        {
-            // Calculate Manhattan distance
-            int32 Distance = FMath::Abs(PlayerUnit->GridX - AIUnit->GridX) +
-                FMath::Abs(PlayerUnit->GridY - AIUnit->GridY);
-
-            // Check if within attack range
-            if (Distance <= AIUnit->RangeAttack)
-            {
-                PotentialTargets.Add(PlayerUnit);
-            }
-        }
-    }
+    CollectTargetsInRange(AIUnit, PotentialTargets);
 
     // If he has targets, prioritize the weakest one
     if (PotentialTargets.Num() > 0)
@@ -1006,192 +1601,263 @@ AUnit* ASaT_RandomPlayer::FindAttackTarget(AUnit* AIUnit)
 }
 
 /*
- * Finds the closest player unit to the given AI unit
- * Searches all player units and returns the one with the shortest Manhattan distance
- * @param AIUnit - The AI unit to calculate distances from
- * @return Pointer to the closest player unit, or nullptr if none found
+ * Collects the living player units inside the attack range of the AI unit
+ * Intersects the precomputed range diamond with the player occupancy bitboard
+ * @param AIUnit - The attacking AI unit
+ * @param OutTargets - Receives the units that can be attacked
  */
-AUnit* ASaT_RandomPlayer::FindClosestPlayerUnit(AUnit* AIUnit)
+void ASaT_RandomPlayer::CollectTargetsInRange(AUnit* AIUnit, TArray<AUnit*>& OutTargets) const
 {
-    if (!AIUnit) return nullptr;
+    const FGridBitboard TargetCells =
+        GridManager->GetAttackableCells(AIUnit->GridX, AIUnit->GridY, AIUnit->RangeAttack) &
+        GridManager->GetUnitBoard(true);
 
-    AUnit* ClosestUnit = nullptr;
-    int32 ClosestDistance = INT_MAX;
+    TargetCells.ForEachSetCell([this, &OutTargets](int32 X, int32 Y)
+        {
+            AUnit* PlayerUnit = GridManager->GetUnitAt(X, Y);
+            if (PlayerUnit && PlayerUnit->bIsPlayerUnit && PlayerUnit->IsAlive())
+            {
+                OutTargets.Add(PlayerUnit);
+            }
+        });
+}
 
-    // Get all units
+/*
+ * Collects the living player units
+ * @param OutPlayerUnits - Receives every player unit still on the board
+ */
+void ASaT_RandomPlayer::CollectPlayerUnits(TArray<AUnit*>& OutPlayerUnits) const
+{
     TArray<AActor*> AllUnits;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+    INC_DWORD_STAT_BY(STAT_SaT_ActorsScanned, AllUnits.Num());
 
     for (AActor* UnitActor : AllUnits)
     {
         AUnit* PlayerUnit = Cast<AUnit>(UnitActor);
         if (PlayerUnit && PlayerUnit->bIsPlayerUnit && PlayerUnit->IsAlive())
         {
-            // Calculate Manhattan distance
-            int32 Distance = FMath::Abs(PlayerUnit->GridX - AIUnit->GridX) +
-                FMath::Abs(PlayerUnit->GridY - AIUnit->GridY);
-
-            if (Distance < ClosestDistance)
-            {
-                ClosestDistance = Distance;
-                ClosestUnit = PlayerUnit;
-            }
+            OutPlayerUnits.Add(PlayerUnit);
         }
     }
-
-    return ClosestUnit;
 }
 
 /*
- * Moves the AI unit toward the closest player unit using A* pathfinding
- * Calculates the optimal path within the unit's movement range
- * @param AIUnit - The AI unit to move
+ * Computes the path distance from the AI unit to every cell in one sweep
+ * Units and obstacles block movement; the result is kept in DistanceField
+ * @param AIUnit - The AI unit the sweep starts from
  */
-void ASaT_RandomPlayer::MoveTowardPlayerUnit(AUnit* AIUnit)
+void ASaT_RandomPlayer::ComputeDistancesFrom(AUnit* AIUnit)
 {
-    if (!AIUnit || !GridManager) return;
+    SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_Pathfinding);
+    LLM_SCOPE_BYTAG(SaT_AISearch);
 
-    // Find closest player unit
-    AUnit* ClosestUnit = FindClosestPlayerUnit(AIUnit);
-    if (!ClosestUnit)
+    FGridSearchStats Stats;
+    GridManager->BuildSearchGrid(SearchGrid, true);
+    FGridPathfinding::ComputeDistanceField(SearchGrid, AIUnit->GridX, AIUnit->GridY, DistanceField, MAX_int32, &Stats);
+    INC_DWORD_STAT_BY(STAT_SaT_NodesExpanded, Stats.NodesExpanded);
+    SAT_TELEMETRY_ADD(PathfindingCalls, 1);
+    SAT_TELEMETRY_ADD(NodesExpanded, Stats.NodesExpanded);
+
+    if (SearchFeed)
     {
-        return;
+        SearchFeed->GetSnapshot().NodesSearched += Stats.NodesExpanded;
+        SearchFeed->Update();
     }
+}
 
-    // Get the unit's movement range
-    int32 MovementRange = AIUnit->Movement;
-
-    // Find best move using A* pathfinding
-    // Initialize data structures for A* algorithm
-    TArray<FVector2D> ClosedSet;
-    TArray<FVector2D> OpenSet;
-    TMap<FVector2D, FVector2D> CameFrom;
-    TMap<FVector2D, int32> GScore;
-    TMap<FVector2D, int32> FScore;
+/*
+ * Returns the memory held by the search scratch, for the memory budget report
+ */
+SIZE_T ASaT_RandomPlayer::GetSearchAllocatedSize() const
+{
+    SIZE_T Total = SearchGrid.StepCost.GetAllocatedSize() + DistanceField.GetAllocatedSize() + AIUnits.GetAllocatedSize() +
+        LastBoard.GetAllocatedSize() + LastBoardUnits.GetAllocatedSize();
 
-    // Direction vectors for the four cardinal directions
-    int32 dx[] = { 1, -1, 0, 0 };
-    int32 dy[] = { 0, 0, 1, -1 };
+    // The ponderer fills its own table while it runs
+    Total += PlannerTable.GetAllocatedSize();
+    if (!Ponderer.IsRunning())
+    {
+        Total += Ponderer.GetTableAllocatedSize();
+    }
+    return Total;
+}
 
-    // Start position
-    FVector2D Start(AIUnit->GridX, AIUnit->GridY);
-    // Target position
-    FVector2D Target(ClosestUnit->GridX, ClosestUnit->GridY);
+/*
+ * Finds the closest player unit to the given AI unit
+ * Uses the path distance to each player unit, falling back to Manhattan distance
+ * for units that cannot be reached at all
+ * The grid's static distance table answers each unit in O(1), ignoring the other units
+ * @param AIUnit - The AI unit to calculate distances from
+ * @return Pointer to the closest player unit, or nullptr if none found
+ */
+AUnit* ASaT_RandomPlayer::FindClosestPlayerUnit(AUnit* AIUnit)
+{
+    if (!AIUnit || !GridManager) return nullptr;
 
-    // Initialize A* parameters
-    OpenSet.Add(Start);
-    GScore.Add(Start, 0);
-    FScore.Add(Start, ManhattanDistance(Start, Target));
+    TArray<AUnit*> PlayerUnits;
+    CollectPlayerUnits(PlayerUnits);
+    if (PlayerUnits.Num() == 0)
+    {
+        return nullptr;
+    }
 
-    // Best move found so far
-    FVector2D BestMove = Start;
-    int32 BestDistanceToTarget = ManhattanDistance(Start, Target);
-    bool bFoundPath = false;
+    const FGridDistanceTable& DistanceTable = GridManager->GetDistanceTable();
+    AUnit* ClosestUnit = nullptr;
+    bool bClosestReachable = false;
+    int32 ClosestDistance = INT_MAX;
 
-    // A* main loop - find a path toward the target, limited by movement range
-    while (OpenSet.Num() > 0)
+    for (AUnit* PlayerUnit : PlayerUnits)
     {
-        // Find node with lowest F score
-        FVector2D Current = OpenSet[0];
-        int32 LowestFScore = FScore[Current];
-        int32 CurrentIndex = 0;
-
-        for (int32 i = 1; i < OpenSet.Num(); i++)
-        {
-            if (FScore[OpenSet[i]] < LowestFScore)
-            {
-                Current = OpenSet[i];
-                LowestFScore = FScore[Current];
-                CurrentIndex = i;
-            }
-        }
+        const int32 PathDistance = DistanceTable.GetDistance(AIUnit->GridX, AIUnit->GridY, PlayerUnit->GridX, PlayerUnit->GridY);
+        const bool bReachable = PathDistance != FGridDistanceField::Unreachable;
+        const int32 Distance = bReachable ? PathDistance :
+            ManhattanDistance(FVector2D(AIUnit->GridX, AIUnit->GridY), FVector2D(PlayerUnit->GridX, PlayerUnit->GridY));
 
-        // Check if he has reached the target
-        if (Current.Equals(Target))
+        // Reachable units always beat unreachable ones
+        if ((bReachable && !bClosestReachable) || (bReachable == bClosestReachable && Distance < ClosestDistance))
         {
-            bFoundPath = true;
-            BestMove = ReconstructPath(CameFrom, Current, Start, MovementRange);
-            break;
+            ClosestUnit = PlayerUnit;
+            ClosestDistance = Distance;
+            bClosestReachable = bReachable;
         }
+    }
 
-        // Remove current from open set and add to closed set
-        OpenSet.RemoveAt(CurrentIndex);
-        ClosedSet.Add(Current);
+    return ClosestUnit;
+}
 
-        // Get current G score
-        int32 CurrentG = GScore[Current];
+/*
+ * Finds the nearest cell, by path distance, from which a player unit can be attacked
+ * Scans the attack diamond around every player unit against the last distance sweep, keeping the
+ * cells the unit could really attack from (line of sight if required); ties go to the cell the player threatens least
+ * @param AIUnit - The AI unit looking for an attack square
+ * @param PlayerUnits - The living player units
+ * @param OutGridX, OutGridY - Receive the chosen cell
+ * @return True if some attack square can be reached
+ */
+bool ASaT_RandomPlayer::FindClosestAttackSquare(AUnit* AIUnit, const TArray<AUnit*>& PlayerUnits, int32& OutGridX, int32& OutGridY) const
+{
+    const int32 Range = AIUnit->RangeAttack;
+    const FGridInfluenceMap& InfluenceMap = GridManager->GetInfluenceMap();
 
-        // Stop expanding if he has reached his movement limit
-        if (CurrentG >= MovementRange)
-            continue;
+    int32 BestDistance = FGridDistanceField::Unreachable;
+    float BestThreat = MAX_flt;
 
-        // Check all four directions
-        for (int32 i = 0; i < 4; i++)
+    for (AUnit* PlayerUnit : PlayerUnits)
+    {
+        for (int32 Y = FMath::Max(0, PlayerUnit->GridY - Range); Y <= FMath::Min(DistanceField.Size - 1, PlayerUnit->GridY + Range); Y++)
         {
-            int32 NewX = FMath::FloorToInt(Current.X) + dx[i];
-            int32 NewY = FMath::FloorToInt(Current.Y) + dy[i];
-            FVector2D Neighbor(NewX, NewY);
+            const int32 HalfWidth = Range - FMath::Abs(Y - PlayerUnit->GridY);
+            for (int32 X = FMath::Max(0, PlayerUnit->GridX - HalfWidth); X <= FMath::Min(DistanceField.Size - 1, PlayerUnit->GridX + HalfWidth); X++)
+            {
+                const int32 Distance = DistanceField.GetDistance(X, Y);
+                if (Distance == FGridDistanceField::Unreachable || Distance > BestDistance ||
+                    !GridManager->CanAttackCell(X, Y, PlayerUnit->GridX, PlayerUnit->GridY, Range))
+                {
+                    continue;
+                }
 
-            // Skip if invalid position
-            if (!GridManager->IsValidPosition(Neighbor))
-                continue;
+                const float Threat = InfluenceMap.GetDamageReceivable(X, Y, false);
+                if (Distance < BestDistance || Threat < BestThreat)
+                {
+                    BestDistance = Distance;
+                    BestThreat = Threat;
+                    OutGridX = X;
+                    OutGridY = Y;
+                }
+            }
+        }
+    }
 
-            // Skip if in closed set
-            if (ClosedSet.Contains(Neighbor))
-                continue;
+    return BestDistance != FGridDistanceField::Unreachable;
+}
 
-            // Skip if cell is occupied (unless it's the target)
-            if (GridManager->IsCellOccupied(NewX, NewY) &&
-                !(NewX == Target.X && NewY == Target.Y))
-                continue;
+/*
+ * Moves the AI unit toward the nearest square it can attack from
+ * A single distance sweep from the unit covers every player unit and every attack square,
+ * the unit then walks the shortest path as far as its movement allows
+ * @param AIUnit - The AI unit to move
+ */
+void ASaT_RandomPlayer::MoveTowardPlayerUnit(AUnit* AIUnit)
+{
+    if (!AIUnit || !GridManager) return;
 
-            // Calculate new G score (one more move)
-            int32 TentativeG = CurrentG + 1;
+    TArray<AUnit*> PlayerUnits;
+    CollectPlayerUnits(PlayerUnits);
+    if (PlayerUnits.Num() == 0)
+    {
+        return;
+    }
 
-            // If he hasn't seen this neighbor yet or found a better path
-            if (!GScore.Contains(Neighbor) || TentativeG < GScore[Neighbor])
-            {
-                // Record this path
-                CameFrom.Add(Neighbor, Current);
-                GScore.Add(Neighbor, TentativeG);
-                FScore.Add(Neighbor, TentativeG + ManhattanDistance(Neighbor, Target));
-
-                // If this move is better than his current best and within movement range
-                if (TentativeG <= MovementRange &&
-                    ManhattanDistance(Neighbor, Target) < BestDistanceToTarget)
-                {
-                    BestMove = Neighbor;
-                    BestDistanceToTarget = ManhattanDistance(Neighbor, Target);
-                }
+    // One sweep gives the true path distance to every cell
+    ComputeDistancesFrom(AIUnit);
 
-                // Add to open set if not already there
-                if (!OpenSet.Contains(Neighbor))
+    int32 GoalX = AIUnit->GridX;
+    int32 GoalY = AIUnit->GridY;
+    if (!FindClosestAttackSquare(AIUnit, PlayerUnits, GoalX, GoalY))
+    {
+        // Every player unit is walled off: get as close as possible in a straight line
+        UE_LOG(LogTemp, Warning, TEXT("AI: No attack square reachable, moving toward the closest player unit"));
+
+        AUnit* ClosestUnit = FindClosestPlayerUnit(AIUnit);
+        if (!ClosestUnit)
+        {
+            return;
+        }
+
+        const FVector2D Target(ClosestUnit->GridX, ClosestUnit->GridY);
+        int32 BestDistanceToTarget = ManhattanDistance(FVector2D(AIUnit->GridX, AIUnit->GridY), Target);
+        for (int32 Y = 0; Y < DistanceField.Size; Y++)
+        {
+            for (int32 X = 0; X < DistanceField.Size; X++)
+            {
+                if (DistanceField.GetDistance(X, Y) <= AIUnit->Movement &&
+                    ManhattanDistance(FVector2D(X, Y), Target) < BestDistanceToTarget)
                 {
-                    OpenSet.Add(Neighbor);
+                    BestDistanceToTarget = ManhattanDistance(FVector2D(X, Y), Target);
+                    GoalX = X;
+                    GoalY = Y;
                 }
             }
         }
     }
 
-    if (!bFoundPath && !BestMove.Equals(Start))
+    // Walk the cheapest path as far as the movement budget allows (terrain can make a step cost more than 1)
+    TArray<FVector2D> Path;
+    DistanceField.GetPathTo(GoalX, GoalY, Path);
+    while (Path.Num() > 1 && DistanceField.GetDistance(int32(Path.Last().X), int32(Path.Last().Y)) > AIUnit->Movement)
+    {
+        Path.Pop(EAllowShrinking::No);
+    }
+
+    // Closer to the goal scores higher
+    if (Path.Num() >= 2)
     {
-        UE_LOG(LogTemp, Warning, TEXT("AI: No complete path found, using best available move"));
+        ReportSearchMove(AIUnit, Path.Last().X, Path.Last().Y, nullptr,
+            -float(DistanceField.GetDistance(GoalX, GoalY) - DistanceField.GetDistance(int32(Path.Last().X), int32(Path.Last().Y))));
     }
-    else if (BestMove.Equals(Start))
+
+    if (Path.Num() < 2)
     {
         UE_LOG(LogTemp, Warning, TEXT("AI: No valid moves found, staying in place"));
         return;
     }
 
-    // Reconstruct the path from the start to the best move
-    TArray<FVector2D> Path;
-    FVector2D Current = BestMove;
-    while (CameFrom.Contains(Current) && !Current.Equals(Start))
+    // Move along the path and log it
+    ExecuteMove(AIUnit, Path);
+}
+
+/*
+ * Moves an AI unit to the last point of a path, updates the grid and logs the move
+ * @param AIUnit - The AI unit to move
+ * @param Path - Cells from the unit's position (first) to its destination (last)
+ */
+void ASaT_RandomPlayer::ExecuteMove(AUnit* AIUnit, const TArray<FVector2D>& Path)
+{
+    if (!AIUnit || !GridManager || Path.Num() < 2)
     {
-        Path.Insert(Current, 0);
-        Current = CameFrom[Current];
+        return;
     }
-    Path.Insert(Start, 0);
 
     // Store old position for logging
     int32 OldX = AIUnit->GridX;
@@ -1201,8 +1867,8 @@ void ASaT_RandomPlayer::MoveTowardPlayerUnit(AUnit* AIUnit)
     GridManager->OccupyCell(OldX, OldY, nullptr);
 
     // Update unit's position
-    AIUnit->GridX = FMath::FloorToInt(BestMove.X);
-    AIUnit->GridY = FMath::FloorToInt(BestMove.Y);
+    AIUnit->GridX = FMath::FloorToInt(Path.Last().X);
+    AIUnit->GridY = FMath::FloorToInt(Path.Last().Y);
     AIUnit->SetActorLocation(GridManager->GetWorldLocationFromGrid(AIUnit->GridX, AIUnit->GridY));
 
     // Mark unit as moved
@@ -1215,7 +1881,7 @@ void ASaT_RandomPlayer::MoveTowardPlayerUnit(AUnit* AIUnit)
     GridManager->HighlightPath(Path, true);
 
     // Log the move
-    AGameModeBase* GameModeBase = UGameplayStatics::GetGameMode(GetWorld());  
+    AGameModeBase* GameModeBase = UGameplayStatics::GetGameMode(GetWorld());
     ASaT_GameMode* GameMode = Cast<ASaT_GameMode>(GameModeBase);
     if (GameMode)
     {
@@ -1231,61 +1897,152 @@ void ASaT_RandomPlayer::MoveTowardPlayerUnit(AUnit* AIUnit)
 }
 
 /*
- * Reconstructs a path from A* search results and determines the best move within range
- * @param CameFrom - Map storing the path connections
- * @param Current - Current end position being reconstructed
- * @param Start - Starting position of the unit
- * @param MaxSteps - Maximum number of steps the unit can take
- * @return The best grid position to move to within the movement range
+ * Attacks a player unit and logs the result
+ * @param AIUnit - The attacking AI unit
+ * @param Target - The player unit to attack
  */
-FVector2D ASaT_RandomPlayer::ReconstructPath(const TMap<FVector2D, FVector2D>& CameFrom,
-    FVector2D Current, FVector2D Start, int32 MaxSteps)
+void ASaT_RandomPlayer::ExecuteAttack(AUnit* AIUnit, AUnit* Target)
 {
-    // Build the complete path
-    TArray<FVector2D> Path;
-    Path.Add(Current);
+    if (!AIUnit || !Target)
+    {
+        return;
+    }
+
+    // Get target's HP before attack
+    int32 TargetHPBefore = Target->Hp;
+
+    // Perform attack
+    AIUnit->Attack(Target);
+
+    // Calculate actual damage by checking HP difference
+    int32 DamageDealt = TargetHPBefore - Target->Hp;
+
+    // Log the attack
+    AGameModeBase* GameModeBase = UGameplayStatics::GetGameMode(GetWorld());
+    ASaT_GameMode* GameMode = Cast<ASaT_GameMode>(GameModeBase);
+    if (GameMode)
+    {
+        FString UnitType = Cast<ASniper>(AIUnit) ? TEXT("Sniper") : TEXT("Brawler");
+        GameMode->AddFormattedMoveToLog(
+            false, // IsPlayerUnit = false for AI units
+            UnitType,
+            TEXT("Attack"),
+            FVector2D(AIUnit->GridX, AIUnit->GridY), // Attack from position
+            FVector2D(Target->GridX, Target->GridY), // Target position
+            DamageDealt
+        );
+    }
+}
+
+/*
+ * Finds the attack position with the least exposure in one pass over the reachable cells
+ * Exposure is the player's next-turn threat from the influence map plus the expected counterattack
+ * @param AIUnit - The AI unit looking for an attack
+ * @param OutGridX, OutGridY - Receive the cell to attack from (the unit's own cell if it should stay)
+ * @param OutTarget - Receives the weakest player unit in range of that cell
+ * @return True if an attack position was found
+ */
+bool ASaT_RandomPlayer::FindSafeAttackPosition(AUnit* AIUnit, int32& OutGridX, int32& OutGridY, AUnit*& OutTarget)
+{
+    OutTarget = nullptr;
 
-    while (CameFrom.Contains(Current) && !Current.Equals(Start))
+    if (!AIUnit || !GridManager)
     {
-        Current = CameFrom[Current];
-        Path.Add(Current);
+        return false;
     }
 
-    // Reverse the path and find the last step within range
-    if (Path.Num() <= MaxSteps + 1)
+    const FGridInfluenceMap& InfluenceMap = GridManager->GetInfluenceMap();
+    const FGridBitboard& PlayerUnitCells = GridManager->GetUnitBoard(true);
+
+    // Candidate cells: staying put, plus every free cell reachable this turn
+    FGridBitboard Candidates;
+    Candidates.Set(AIUnit->GridX, AIUnit->GridY);
+    if (!AIUnit->bHasMovedThisTurn)
     {
-        // He can reach the end of the path, so return the last non-start point
-        for (int32 i = Path.Num() - 1; i >= 0; i--)
+        Candidates |= GridManager->GetReachableCells(AIUnit->GridX, AIUnit->GridY, AIUnit->Movement);
+    }
+
+    // Only cells within attack range of a player unit can be attack positions
+    Candidates &= PlayerUnitCells.ExpandedBy(AIUnit->RangeAttack);
+
+    float BestRisk = MAX_flt;
+    int32 BestTargetHp = MAX_int32;
+
+    Candidates.ForEachSetCell([&](int32 X, int32 Y)
         {
-            if (!Path[i].Equals(Start))
+            // Weakest player unit in range of this cell, as FindAttackTarget prioritizes
+            AUnit* Target = nullptr;
+            const FGridBitboard TargetCells = GridManager->GetAttackableCells(X, Y, AIUnit->RangeAttack) & PlayerUnitCells;
+            TargetCells.ForEachSetCell([&](int32 TargetX, int32 TargetY)
+                {
+                    AUnit* PlayerUnit = GridManager->GetUnitAt(TargetX, TargetY);
+                    if (PlayerUnit && PlayerUnit->IsAlive() && (!Target || PlayerUnit->Hp < Target->Hp))
+                    {
+                        Target = PlayerUnit;
+                    }
+                });
+
+            if (SearchFeed)
             {
-                return Path[i];
+                SearchFeed->GetSnapshot().NodesSearched++;
+                SearchFeed->Update();
             }
-        }
-    }
-    else
-    {
-        // He can only go MaxSteps steps, so return the MaxSteps-th position from the end
-        return Path[Path.Num() - 1 - MaxSteps];
-    }
 
-    return Start;
+            if (!Target)
+            {
+                return;
+            }
+
+            // Expected counterattack: only if the target survives the hit
+            float Risk = InfluenceMap.GetDamageReceivable(X, Y, false);
+            const int32 Distance = FMath::Abs(Target->GridX - X) + FMath::Abs(Target->GridY - Y);
+            if (AUnit::CanCounterattack(AIUnit, Target, Distance))
+            {
+                const int32 DamageRolls = AIUnit->MaxDamage - AIUnit->MinDamage + 1;
+                const int32 SurvivingRolls = FMath::Clamp(Target->Hp - AIUnit->MinDamage, 0, DamageRolls);
+                const float SurviveChance = DamageRolls > 0 ? float(SurvivingRolls) / DamageRolls : 1.0f;
+                Risk += SurviveChance * (AUnit::MinCounterDamage + AUnit::MaxCounterDamage) * 0.5f;
+            }
+
+            // Least exposure first, then the weakest target; ties keep the earlier cell,
+            // except that staying put always wins a tie
+            const bool bStays = (X == AIUnit->GridX && Y == AIUnit->GridY);
+            const bool bBetter = OutTarget == nullptr ||
+                Risk < BestRisk - KINDA_SMALL_NUMBER ||
+                (FMath::IsNearlyEqual(Risk, BestRisk) && (Target->Hp < BestTargetHp ||
+                    (Target->Hp == BestTargetHp && bStays)));
+
+            if (bBetter)
+            {
+                BestRisk = Risk;
+                BestTargetHp = Target->Hp;
+                OutGridX = X;
+                OutGridY = Y;
+                OutTarget = Target;
+                ReportSearchMove(AIUnit, X, Y, Target, -Risk);
+            }
+        });
+
+    return OutTarget != nullptr;
 }
 
 // Called when the AI player wins the game
 void ASaT_RandomPlayer::OnWin()
 {
+    Ponderer.Stop();
     UE_LOG(LogTemp, Warning, TEXT("AI Player has won!"));
 }
 
 // Called when the AI player loses the game
 void ASaT_RandomPlayer::OnLose()
 {
+    Ponderer.Stop();
     UE_LOG(LogTemp, Warning, TEXT("AI Player has lost!"));
 }
 
 // Called when the game ends in a draw
 void ASaT_RandomPlayer::OnDraw()
 {
+    Ponderer.Stop();
     UE_LOG(LogTemp, Warning, TEXT("AI Player: Game ended in a draw"));
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_SearchStatsFeed.h"
+#include "GridManager.h"
+#include "HAL/PlatformTime.h"
+
+//----------------------------------------------
+// Producer
+//----------------------------------------------
+
+void FSaTSearchStatsFeed::BeginSearch(float InBudgetMs)
+{
+	Working = FSaTSearchSnapshot();
+	BudgetMs = InBudgetMs;
+	StartSeconds = FPlatformTime::Seconds();
+	Publish(StartSeconds);
+}
+
+bool FSaTSearchStatsFeed::Update()
+{
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LastPublishSeconds < PublishIntervalSeconds)
+	{
+		return false;
+	}
+
+	Publish(Now);
+	return true;
+}
+
+void FSaTSearchStatsFeed::FinishSearch()
+{
+	Working.bFinished = true;
+	Publish(FPlatformTime::Seconds());
+}
+
+void FSaTSearchStatsFeed::Publish(double NowSeconds)
+{
+	const double ElapsedSeconds = NowSeconds - StartSeconds;
+	Working.NodesPerSecond = ElapsedSeconds > 0.0 ? float(Working.NodesSearched / ElapsedSeconds) : 0.0f;
+	Working.TimeRemainingMs = FMath::Max(0.0f, BudgetMs - float(ElapsedSeconds * 1000.0));
+
+	Buffer.GetWriteBuffer() = Working;
+	Buffer.Publish();
+	LastPublishSeconds = NowSeconds;
+}
+
+//----------------------------------------------
+// Widget View
+//----------------------------------------------
+
+FSaTAISearchStats FSaTAISearchStats::FromSnapshot(const FSaTSearchSnapshot& Snapshot)
+{
+	FSaTAISearchStats Stats;
+	Stats.NodesSearched = Snapshot.NodesSearched;
+	Stats.NodesPerSecond = Snapshot.NodesPerSecond;
+	Stats.Depth = Snapshot.Depth;
+	Stats.BestScore = Snapshot.BestScore;
+	Stats.TimeRemainingMs = Snapshot.TimeRemainingMs;
+	Stats.bFinished = Snapshot.bFinished;
+
+	const int32 PVLength = FMath::Clamp(Snapshot.PVLength, 0, FSaTSearchSnapshot::MaxPVLength);
+	for (int32 i = 0; i < PVLength; i++)
+	{
+		const FSaTSearchMove& Move = Snapshot.PV[i];
+		if (i > 0)
+		{
+			Stats.PrincipalVariation += TEXT(" ");
+		}
+
+		// Staying put shows only the attack
+		if (Move.FromX != Move.ToX || Move.FromY != Move.ToY)
+		{
+			Stats.PrincipalVariation += AGridManager::ConvertToLetterNumberFormat(Move.FromX, Move.FromY) + TEXT("-") +
+				AGridManager::ConvertToLetterNumberFormat(Move.ToX, Move.ToY);
+		}
+		if (Move.TargetX >= 0)
+		{
+			Stats.PrincipalVariation += TEXT(" x") + AGridManager::ConvertToLetterNumberFormat(Move.TargetX, Move.TargetY);
+		}
+	}
+
+	Stats.PrincipalVariation.TrimStartInline();
+	return Stats;
+}
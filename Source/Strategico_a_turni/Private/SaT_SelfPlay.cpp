@@ -0,0 +1,398 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_SelfPlay.h"
+#include "SaT_CombatOdds.h"
+#include "GridPathfinding.h"
+#include "GridLineOfSight.h"
+#include "Async/ParallelFor.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+	constexpr int32 NumWeights = 5;
+
+	/** Exponents of the SPSA gain sequences, the usual choice for noisy objectives */
+	constexpr float GainDecay = 0.602f;
+	constexpr float PerturbationDecay = 0.101f;
+
+	void ToValues(const FSaTEvalWeights& Weights, float (&OutValues)[NumWeights])
+	{
+		OutValues[0] = Weights.Hp;
+		OutValues[1] = Weights.Kill;
+		OutValues[2] = Weights.Exposure;
+		OutValues[3] = Weights.Approach;
+		OutValues[4] = Weights.LineControl;
+	}
+
+	/** Every term is a reward or a penalty by construction, so weights never change sign */
+	FSaTEvalWeights FromValues(const float (&Values)[NumWeights])
+	{
+		FSaTEvalWeights Weights;
+		Weights.Hp = FMath::Max(0.0f, Values[0]);
+		Weights.Kill = FMath::Max(0.0f, Values[1]);
+		Weights.Exposure = FMath::Max(0.0f, Values[2]);
+		Weights.Approach = FMath::Max(0.0f, Values[3]);
+		Weights.LineControl = FMath::Max(0.0f, Values[4]);
+		return Weights;
+	}
+
+	/** Random boards tried per seed before the match is given up */
+	constexpr int32 MaxBoardAttempts = 100;
+
+	/** Board of a match and the attack rule played on it */
+	struct FSelfPlayBoard
+	{
+		FGridSearchGrid Grid;
+		FGridLineOfSight LineOfSight;
+		bool bRequireLineOfSight = false;
+
+		/** AGridManager::CanAttackCell on the board */
+		bool CanAttack(int32 FromX, int32 FromY, int32 ToX, int32 ToY, int32 Range) const
+		{
+			return FGridBitboard::IsOffsetInRange(ToX - FromX, ToY - FromY, Range) &&
+				(!bRequireLineOfSight || LineOfSight.IsVisible(FromX, FromY, ToX, ToY));
+		}
+	};
+
+	/**
+	 * Rolls obstacles until every free cell is connected to the others, as AGridManager::EnsureGridConnectivity leaves the map
+	 * @return False if no attempt gave a connected board
+	 */
+	bool GenerateBoard(const FSaTSelfPlaySettings& Settings, int32 Size, FRandomStream& Stream, FSelfPlayBoard& OutBoard)
+	{
+		FGridSearchGrid& Grid = OutBoard.Grid;
+		Grid.Init(Size, 1);
+		for (int32 Attempt = 0; Attempt < MaxBoardAttempts; Attempt++)
+		{
+			FGridBitboard BoardCells;
+			FGridBitboard Obstacles;
+			FGridBitboard Passable;
+			FGridBitboard Seed;
+			for (int32 Y = 0; Y < Size; Y++)
+			{
+				for (int32 X = 0; X < Size; X++)
+				{
+					uint8& Cost = Grid.StepCost[Grid.ToIndex(X, Y)];
+					Cost = Stream.FRand() < Settings.ObstacleDensity ? 0 : 1;
+					BoardCells.Set(X, Y);
+					(Cost == 0 ? Obstacles : Passable).Set(X, Y);
+					if (Cost != 0 && Seed.IsEmpty())
+					{
+						Seed.Set(X, Y);
+					}
+				}
+			}
+
+			// Everything flooded from one free cell is everything free
+			if (Seed.IsEmpty() || FGridBitboard::FloodFill(Seed, Passable) != Passable)
+			{
+				continue;
+			}
+
+			OutBoard.bRequireLineOfSight = Settings.bRequireLineOfSight;
+			if (OutBoard.bRequireLineOfSight)
+			{
+				OutBoard.LineOfSight.Build(Obstacles, BoardCells);
+			}
+			return true;
+		}
+		return false;
+	}
+
+	void KillUnit(FSaTPlannerUnit& Unit)
+	{
+		Unit.Hp = 0.0f;
+		Unit.AliveChance = 0.0f;
+	}
+
+	/**
+	 * Adds a unit of the type at full hit points on a random free passable cell of the rows [MinY, MaxY)
+	 * @return False if the rows have no such cell; the unit is not added
+	 */
+	bool PlaceUnit(EPieceUnit Type, bool bSecondSide, int32 MinY, int32 MaxY, const FGridSearchGrid& Grid, FRandomStream& Stream,
+		TArray<FSaTPlannerUnit>& Units)
+	{
+		const bool bSniper = Type == EPieceUnit::SNIPER;
+		FSaTPlannerUnit Unit;
+		Unit.Type = Type;
+		Unit.Hp = bSniper ? ASniper::DefaultHp : ABrawler::DefaultHp;
+		Unit.Movement = bSniper ? ASniper::DefaultMovement : ABrawler::DefaultMovement;
+		Unit.Range = bSniper ? ASniper::DefaultRangeAttack : ABrawler::DefaultRangeAttack;
+		Unit.MinDamage = bSniper ? ASniper::DefaultMinDamage : ABrawler::DefaultMinDamage;
+		Unit.MaxDamage = bSniper ? ASniper::DefaultMaxDamage : ABrawler::DefaultMaxDamage;
+		Unit.bIsPlayerUnit = bSecondSide;
+
+		TArray<FIntPoint, TInlineAllocator<64>> FreeCells;
+		for (int32 Y = MinY; Y < MaxY; Y++)
+		{
+			for (int32 X = 0; X < Grid.Size; X++)
+			{
+				const bool bTaken = Units.ContainsByPredicate([X, Y](const FSaTPlannerUnit& Other)
+					{
+						return Other.GridX == X && Other.GridY == Y;
+					});
+				if (!bTaken && Grid.IsPassable(Grid.ToIndex(X, Y)))
+				{
+					FreeCells.Add(FIntPoint(X, Y));
+				}
+			}
+		}
+		if (FreeCells.Num() == 0)
+		{
+			return false;
+		}
+
+		const FIntPoint Cell = FreeCells[Stream.RandRange(0, FreeCells.Num() - 1)];
+		Unit.GridX = Cell.X;
+		Unit.GridY = Cell.Y;
+		Units.Add(Unit);
+		return true;
+	}
+
+	/** Plays a planned action with a real damage roll and, if the target survives and may strike back, a counterattack roll */
+	void PlayAction(const FSelfPlayBoard& Board, TArray<FSaTPlannerUnit>& Units, const FSaTPlannedAction& Action, FRandomStream& Stream)
+	{
+		FSaTPlannerUnit& Attacker = Units[Action.UnitIndex];
+		Attacker.GridX = Action.ToX;
+		Attacker.GridY = Action.ToY;
+		Attacker.bHasActed = true;
+		if (!Units.IsValidIndex(Action.TargetIndex))
+		{
+			return;
+		}
+
+		FSaTPlannerUnit& Target = Units[Action.TargetIndex];
+		if (Target.AliveChance <= 0.0f || !Board.CanAttack(Attacker.GridX, Attacker.GridY, Target.GridX, Target.GridY, Attacker.Range))
+		{
+			return;
+		}
+
+		const int32 Damage = Stream.RandRange(Attacker.MinDamage, Attacker.MaxDamage);
+		if (Damage >= Target.Hp)
+		{
+			KillUnit(Target);
+			return;
+		}
+		Target.Hp -= Damage;
+
+		const int32 Distance = FMath::Abs(Target.GridX - Attacker.GridX) + FMath::Abs(Target.GridY - Attacker.GridY);
+		if (FSaTCombatOdds::CanCounterattack(Attacker.Type, Target.Type, Distance))
+		{
+			const int32 CounterDamage = Stream.RandRange(AUnit::MinCounterDamage, AUnit::MaxCounterDamage);
+			if (CounterDamage >= Attacker.Hp)
+			{
+				KillUnit(Attacker);
+			}
+			else
+			{
+				Attacker.Hp -= CounterDamage;
+			}
+		}
+	}
+
+	/** Match score of the first side; a match out of turns is worth up to half a point by the hit points each side has left */
+	float ScoreMatch(const FSaTMatchResult& Result)
+	{
+		if (Result.Winner != 0)
+		{
+			return float(Result.Winner);
+		}
+		constexpr float SideHp = ASniper::DefaultHp + ABrawler::DefaultHp;
+		return FMath::Clamp(0.5f * Result.HpDifference / SideHp, -0.5f, 0.5f);
+	}
+
+	/** Scores of First in NumPairs seeds played twice, the sides swapped, in parallel; seeds without a playable board are left out */
+	void PlayMatchScores(const FSaTSelfPlaySettings& Settings, const FSaTEvalWeights& First, const FSaTEvalWeights& Second, int32 FirstSeed, int32 NumPairs,
+		TArray<float>& OutScores)
+	{
+		const int32 NumMatches = FMath::Max(0, NumPairs) * 2;
+		TArray<FSaTMatchResult> Results;
+		Results.SetNum(NumMatches);
+
+		// Odd matches replay the board of the even one before with the sides swapped, so neither weights keep the first move
+		ParallelFor(NumMatches, [&](int32 Index)
+			{
+				const int32 MatchSeed = FirstSeed + Index / 2;
+				Results[Index] = Index % 2 == 0 ?
+					FSaTSelfPlay::PlayMatch(Settings, First, Second, MatchSeed) :
+					FSaTSelfPlay::PlayMatch(Settings, Second, First, MatchSeed);
+			});
+
+		OutScores.Reset(NumMatches);
+		for (int32 Index = 0; Index < NumMatches; Index++)
+		{
+			if (!Results[Index].bPlayed)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Self-play seed %d has no playable board, match skipped"), FirstSeed + Index / 2);
+				continue;
+			}
+			OutScores.Add(Index % 2 == 0 ? ScoreMatch(Results[Index]) : -ScoreMatch(Results[Index]));
+		}
+	}
+
+	float Average(const TArray<float>& Values)
+	{
+		float Total = 0.0f;
+		for (float Value : Values)
+		{
+			Total += Value;
+		}
+		return Values.Num() > 0 ? Total / Values.Num() : 0.0f;
+	}
+}
+
+FSaTMatchResult FSaTSelfPlay::PlayMatch(const FSaTSelfPlaySettings& Settings, const FSaTEvalWeights& First, const FSaTEvalWeights& Second, int32 MatchSeed)
+{
+	FSaTMatchResult Result;
+	FRandomStream Stream(MatchSeed);
+	const int32 Size = FMath::Clamp(Settings.BoardSize, 4, FGridBitboard::Stride);
+	FSelfPlayBoard Board;
+	if (!GenerateBoard(Settings, Size, Stream, Board))
+	{
+		return Result;
+	}
+	const FGridSearchGrid& Grid = Board.Grid;
+
+	// The first side in the top half of the board, the second in the bottom one
+	TArray<FSaTPlannerUnit> Units;
+	const int32 Half = Size / 2;
+	if (!PlaceUnit(EPieceUnit::SNIPER, false, 0, Half, Grid, Stream, Units) ||
+		!PlaceUnit(EPieceUnit::BRAWLER, false, 0, Half, Grid, Stream, Units) ||
+		!PlaceUnit(EPieceUnit::SNIPER, true, Size - Half, Size, Grid, Stream, Units) ||
+		!PlaceUnit(EPieceUnit::BRAWLER, true, Size - Half, Size, Grid, Stream, Units))
+	{
+		return Result;
+	}
+	Result.bPlayed = true;
+
+	auto CanAttack = [&Board](int32 FromX, int32 FromY, int32 ToX, int32 ToY, int32 Range)
+	{
+		return Board.CanAttack(FromX, FromY, ToX, ToY, Range);
+	};
+
+	FSaTTurnPlannerSettings PlannerSettings;
+	PlannerSettings.BudgetMs = Settings.PlannerBudgetMs;
+	PlannerSettings.MaxActionsPerUnit = FMath::Max(1, Settings.MaxActionsPerUnit);
+
+	TArray<FSaTPlannerUnit> View;
+	for (; Result.Winner == 0 && Result.Turns < Settings.MaxTurns * 2; Result.Turns++)
+	{
+		// The side to move is the AI side of the planner
+		const bool bSecondSide = Result.Turns % 2 == 1;
+		PlannerSettings.Weights = bSecondSide ? Second : First;
+		for (FSaTPlannerUnit& Unit : Units)
+		{
+			Unit.bHasActed = false;
+		}
+
+		// One unit at a time, planned again after the rolls of the one before, as the AI plays in game
+		for (int32 Step = 0; Step < Units.Num(); Step++)
+		{
+			View = Units;
+			for (FSaTPlannerUnit& Unit : View)
+			{
+				Unit.bIsPlayerUnit = Unit.bIsPlayerUnit != bSecondSide;
+			}
+
+			const FSaTTurnPlan Plan = FSaTTurnPlanner::Plan(Grid, View, PlannerSettings, CanAttack);
+			if (Plan.Actions.Num() == 0)
+			{
+				break;
+			}
+			PlayAction(Board, Units, Plan.Actions[0], Stream);
+		}
+
+		bool bFirstAlive = false;
+		bool bSecondAlive = false;
+		for (const FSaTPlannerUnit& Unit : Units)
+		{
+			if (Unit.AliveChance > 0.0f)
+			{
+				(Unit.bIsPlayerUnit ? bSecondAlive : bFirstAlive) = true;
+			}
+		}
+		if (!bFirstAlive || !bSecondAlive)
+		{
+			Result.Winner = bFirstAlive ? 1 : bSecondAlive ? -1 : 0;
+		}
+	}
+
+	for (const FSaTPlannerUnit& Unit : Units)
+	{
+		Result.HpDifference += Unit.bIsPlayerUnit ? -Unit.Hp : Unit.Hp;
+	}
+	return Result;
+}
+
+float FSaTSelfPlay::PlayMatches(const FSaTSelfPlaySettings& Settings, const FSaTEvalWeights& First, const FSaTEvalWeights& Second, int32 FirstSeed, int32 NumPairs)
+{
+	TArray<float> Scores;
+	PlayMatchScores(Settings, First, Second, FirstSeed, NumPairs, Scores);
+	return Average(Scores);
+}
+
+FSaTTuningResult FSaTSelfPlay::Tune(const FSaTSelfPlaySettings& Settings, const FSaTEvalWeights& Initial)
+{
+	float Theta[NumWeights];
+	ToValues(Initial, Theta);
+
+	// Each weight moves in proportion to its own size, weights under one hit point as if they were one
+	float Scale[NumWeights];
+	for (int32 Index = 0; Index < NumWeights; Index++)
+	{
+		Scale[Index] = FMath::Max(1.0f, FMath::Abs(Theta[Index]));
+	}
+
+	FRandomStream Stream(Settings.Seed);
+	const int32 NumPairs = FMath::Max(1, Settings.MatchPairs);
+	const float StabilityOffset = 0.1f * Settings.Iterations;
+	int32 NextSeed = Settings.Seed;
+
+	FSaTTuningResult Result;
+	for (int32 Iteration = 0; Iteration < Settings.Iterations; Iteration++)
+	{
+		const float Gain = Settings.StepSize / FMath::Pow(Iteration + 1.0f + StabilityOffset, GainDecay);
+		const float Perturbation = Settings.Perturbation / FMath::Pow(Iteration + 1.0f, PerturbationDecay);
+
+		float Delta[NumWeights];
+		float Plus[NumWeights];
+		float Minus[NumWeights];
+		for (int32 Index = 0; Index < NumWeights; Index++)
+		{
+			Delta[Index] = Stream.FRand() < 0.5f ? -1.0f : 1.0f;
+			Plus[Index] = Theta[Index] + Perturbation * Scale[Index] * Delta[Index];
+			Minus[Index] = Theta[Index] - Perturbation * Scale[Index] * Delta[Index];
+		}
+
+		// New boards every iteration, the same ones for both perturbed weights
+		TArray<float> Scores;
+		PlayMatchScores(Settings, FromValues(Plus), FromValues(Minus), NextSeed, NumPairs, Scores);
+		const float Score = Average(Scores);
+		NextSeed += NumPairs;
+		Result.MatchesPlayed += Scores.Num();
+
+		for (int32 Index = 0; Index < NumWeights; Index++)
+		{
+			Theta[Index] = FMath::Max(0.0f, Theta[Index] + Gain * Scale[Index] * Score / (2.0f * Perturbation * Delta[Index]));
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("SPSA %d/%d: score %+.3f -> Hp %.3f, Kill %.3f, Exposure %.3f, Approach %.3f, LineControl %.3f"),
+			Iteration + 1, Settings.Iterations, Score, Theta[0], Theta[1], Theta[2], Theta[3], Theta[4]);
+	}
+
+	// Checked on boards the tuning never saw
+	Result.Weights = FromValues(Theta);
+	TArray<float> Scores;
+	PlayMatchScores(Settings, Result.Weights, Initial, NextSeed, NumPairs * 4, Scores);
+	Result.MatchesPlayed += Scores.Num();
+	Result.ScoreVsInitial = Average(Scores);
+
+	float SquaredDeviations = 0.0f;
+	for (float Score : Scores)
+	{
+		SquaredDeviations += FMath::Square(Score - Result.ScoreVsInitial);
+	}
+	Result.ScoreStdError = FMath::Sqrt(SquaredDeviations / FMath::Max(1, Scores.Num() - 1) / FMath::Max(1, Scores.Num()));
+	return Result;
+}
@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_Stats.h"
+
+DEFINE_STAT(STAT_SaT_AIDecision);
+DEFINE_STAT(STAT_SaT_Pathfinding);
+DEFINE_STAT(STAT_SaT_HighlightCommit);
+DEFINE_STAT(STAT_SaT_UpdateGameHUD);
+DEFINE_STAT(STAT_SaT_AddMoveToLog);
+DEFINE_STAT(STAT_SaT_CheckGameOver);
+DEFINE_STAT(STAT_SaT_BoardGeneration);
+
+DEFINE_STAT(STAT_SaT_NodesExpanded);
+DEFINE_STAT(STAT_SaT_ActorsScanned);
+DEFINE_STAT(STAT_SaT_MaterialsSet);
+
+UE_TRACE_CHANNEL_DEFINE(SaTChannel);
@@ -0,0 +1,407 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_TurnPlanner.h"
+#include "GridPathfinding.h"
+#include "SaT_CombatOdds.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Hash/CityHash.h"
+
+namespace
+{
+	/** Returns the planner table key of a board with the units of RemainingMask still to act */
+	uint64 HashNode(const TArray<FSaTPlannerUnit>& Units, uint32 RemainingMask)
+	{
+		TArray<uint32, TInlineAllocator<64>> Words;
+		Words.Add(RemainingMask);
+		for (const FSaTPlannerUnit& Unit : Units)
+		{
+			Words.Add(uint32(Unit.GridX) | uint32(Unit.GridY) << 10 | uint32(Unit.Type) << 20 | uint32(Unit.bIsPlayerUnit) << 28 | uint32(Unit.bHasActed) << 29);
+			Words.Add(*reinterpret_cast<const uint32*>(&Unit.Hp));
+			Words.Add(*reinterpret_cast<const uint32*>(&Unit.AliveChance));
+			Words.Add(uint32(Unit.Movement) | uint32(Unit.Range) << 8 | uint32(Unit.MinDamage) << 16 | uint32(Unit.MaxDamage) << 24);
+		}
+		return CityHash64(reinterpret_cast<const char*>(Words.GetData()), Words.Num() * sizeof(uint32));
+	}
+
+	struct FActionCandidate
+	{
+		FSaTPlannedAction Action;
+		float Score;
+	};
+
+	/** State of one search, shared by every node */
+	struct FPlannerSearch
+	{
+		const FGridSearchGrid& StaticGrid;
+		const FSaTTurnPlannerSettings& Settings;
+		TFunctionRef<bool(int32, int32, int32, int32, int32)> CanAttack;
+
+		double EndSeconds = 0.0;
+		FSaTTurnPlan Best;
+
+		/** Units planned at the root, and the draw among its actions */
+		uint32 RootMask = 0;
+		FRandomStream Random;
+
+		/** Scratch of the action generation, reused by every node */
+		FGridSearchGrid NodeGrid;
+		FGridDistanceField Field;
+
+		bool IsOutOfTime()
+		{
+			if (!Best.bBudgetExhausted && (FPlatformTime::Seconds() >= EndSeconds ||
+				(Settings.CancelFlag && Settings.CancelFlag->load(std::memory_order_relaxed))))
+			{
+				Best.bBudgetExhausted = true;
+			}
+			return Best.bBudgetExhausted;
+		}
+
+		/** Lists the actions of a unit on the board and keeps the best MaxActionsPerUnit of them */
+		void GenerateActions(const TArray<FSaTPlannerUnit>& Units, int32 UnitIndex, TArray<FActionCandidate>& OutActions)
+		{
+			const FSaTPlannerUnit& Self = Units[UnitIndex];
+
+			// Units that are likely still alive block movement
+			NodeGrid = StaticGrid;
+			for (const FSaTPlannerUnit& Other : Units)
+			{
+				if (Other.IsLikelyAlive() && NodeGrid.IsValidCell(Other.GridX, Other.GridY))
+				{
+					NodeGrid.StepCost[NodeGrid.ToIndex(Other.GridX, Other.GridY)] = 0;
+				}
+			}
+			FGridPathfinding::ComputeDistanceField(NodeGrid, Self.GridX, Self.GridY, Field, Self.Movement);
+
+			TArray<FSaTPlannerUnit> Child;
+			auto AddCandidate = [&](int32 ToX, int32 ToY, int32 TargetIndex)
+			{
+				FActionCandidate& Candidate = OutActions.AddDefaulted_GetRef();
+				Candidate.Action.UnitIndex = UnitIndex;
+				Candidate.Action.ToX = ToX;
+				Candidate.Action.ToY = ToY;
+				Candidate.Action.TargetIndex = TargetIndex;
+				Candidate.Action.TargetX = TargetIndex != INDEX_NONE ? Units[TargetIndex].GridX : -1;
+				Candidate.Action.TargetY = TargetIndex != INDEX_NONE ? Units[TargetIndex].GridY : -1;
+
+				Child = Units;
+				FSaTTurnPlanner::ApplyAction(Child, Candidate.Action);
+				Candidate.Score = FSaTTurnPlanner::Evaluate(Child, Settings.Weights);
+				Best.NodesSearched++;
+			};
+
+			OutActions.Reset();
+			for (int32 Index = 0; Index < Field.Distance.Num(); Index++)
+			{
+				if (Field.Distance[Index] == FGridDistanceField::Unreachable)
+				{
+					continue;
+				}
+
+				const int32 X = Index % NodeGrid.Size;
+				const int32 Y = Index / NodeGrid.Size;
+				AddCandidate(X, Y, INDEX_NONE);
+
+				for (int32 TargetIndex = 0; TargetIndex < Units.Num(); TargetIndex++)
+				{
+					const FSaTPlannerUnit& Target = Units[TargetIndex];
+					if (Target.bIsPlayerUnit != Self.bIsPlayerUnit && Target.IsLikelyAlive() &&
+						CanAttack(X, Y, Target.GridX, Target.GridY, Self.Range))
+					{
+						AddCandidate(X, Y, TargetIndex);
+					}
+				}
+			}
+
+			// Ties keep the order of the cells, so equal boards always give the same plan
+			OutActions.StableSort([](const FActionCandidate& A, const FActionCandidate& B)
+				{
+					return A.Score > B.Score;
+				});
+			if (OutActions.Num() > Settings.MaxActionsPerUnit)
+			{
+				OutActions.SetNum(Settings.MaxActionsPerUnit);
+			}
+		}
+
+		/**
+		 * Tries every unit left as the next one to act, with each of its kept actions
+		 * @param OutLine - Receives the actions of the best plan found below the board
+		 * @return Score of that plan
+		 */
+		float Search(const TArray<FSaTPlannerUnit>& Units, uint32 RemainingMask, TArray<FSaTPlannedAction>& OutLine)
+		{
+			OutLine.Reset();
+			if (RemainingMask == 0 || IsOutOfTime())
+			{
+				// Units the budget did not reach stay where they are
+				Best.PlansEvaluated++;
+				return FSaTTurnPlanner::Evaluate(Units, Settings.Weights);
+			}
+
+			// The root draws its action by adding Gumbel noise to the plan scores, a softmax draw at the temperature;
+			// the drawn line is not the best one, so it is neither looked up nor stored
+			const bool bDrawRoot = RemainingMask == RootMask && Settings.Temperature > 0.0f;
+
+			uint64 Key = 0;
+			if (Settings.Table && !bDrawRoot)
+			{
+				Key = HashNode(Units, RemainingMask);
+				if (const FSaTPlannerTable::FEntry* Entry = Settings.Table->Find(Key))
+				{
+					Best.TableHits++;
+					OutLine = Entry->Continuation;
+					return Entry->Score;
+				}
+			}
+
+			float BestScore = -MAX_flt;
+			float BestDrawn = -MAX_flt;
+			TArray<FActionCandidate> Actions;
+			TArray<FSaTPlannerUnit> Child;
+			TArray<FSaTPlannedAction> ChildLine;
+			for (int32 UnitIndex = 0; UnitIndex < Units.Num(); UnitIndex++)
+			{
+				if ((RemainingMask & (1u << UnitIndex)) == 0)
+				{
+					continue;
+				}
+
+				GenerateActions(Units, UnitIndex, Actions);
+				for (const FActionCandidate& Candidate : Actions)
+				{
+					Child = Units;
+					FSaTTurnPlanner::ApplyAction(Child, Candidate.Action);
+
+					const float Score = Search(Child, RemainingMask & ~(1u << UnitIndex), ChildLine);
+					const float Drawn = bDrawRoot ?
+						Score - Settings.Temperature * FMath::Loge(-FMath::Loge(Random.FRandRange(KINDA_SMALL_NUMBER, 1.0f - KINDA_SMALL_NUMBER))) : Score;
+					if (Drawn > BestDrawn)
+					{
+						BestDrawn = Drawn;
+						BestScore = Score;
+						OutLine.Reset();
+						OutLine.Add(Candidate.Action);
+						OutLine.Append(ChildLine);
+					}
+
+					// A board the budget cut short is not stored
+					if (Best.bBudgetExhausted)
+					{
+						return BestScore;
+					}
+				}
+			}
+
+			if (Settings.Table && !bDrawRoot)
+			{
+				Settings.Table->Store(Key, BestScore, OutLine);
+			}
+			return BestScore;
+		}
+	};
+}
+
+FSaTTurnPlan FSaTTurnPlanner::Plan(const FGridSearchGrid& StaticGrid, const TArray<FSaTPlannerUnit>& Units, const FSaTTurnPlannerSettings& Settings,
+	TFunctionRef<bool(int32 FromX, int32 FromY, int32 ToX, int32 ToY, int32 Range)> CanAttack)
+{
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	FPlannerSearch Search{ StaticGrid, Settings, CanAttack };
+	Search.EndSeconds = StartSeconds + Settings.BudgetMs / 1000.0;
+
+	// Entries of another board or other rules would give plans this board does not have
+	if (Settings.Table)
+	{
+		uint64 Context = CityHash64(reinterpret_cast<const char*>(StaticGrid.StepCost.GetData()), StaticGrid.StepCost.Num());
+		Context = CityHash128to64(Uint128_64(Context, uint64(Settings.MaxActionsPerUnit) << 32 | Settings.RulesKey));
+		Context = CityHash128to64(Uint128_64(Context, CityHash64(reinterpret_cast<const char*>(&Settings.Weights), sizeof(FSaTEvalWeights))));
+		Settings.Table->CheckContext(Context);
+	}
+
+	// Every AI unit that can still act, up to MaxPlannedUnits of them
+	const int32 MaxUnits = FMath::Clamp(Settings.MaxPlannedUnits, 1, MaxPlannedUnits);
+	uint32 PlannedMask = 0;
+	int32 NumPlanned = 0;
+	for (int32 UnitIndex = 0; UnitIndex < Units.Num() && UnitIndex < 32; UnitIndex++)
+	{
+		if (!Units[UnitIndex].bIsPlayerUnit && !Units[UnitIndex].bHasActed && Units[UnitIndex].IsLikelyAlive() && NumPlanned < MaxUnits)
+		{
+			PlannedMask |= 1u << UnitIndex;
+			NumPlanned++;
+		}
+	}
+
+	Search.RootMask = PlannedMask;
+	Search.Random.Initialize(Settings.RandomSeed);
+	Search.Best.Score = Search.Search(Units, PlannedMask, Search.Best.Actions);
+
+	Search.Best.ElapsedMs = (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+	return MoveTemp(Search.Best);
+}
+
+float FSaTTurnPlanner::Evaluate(const TArray<FSaTPlannerUnit>& Units, const FSaTEvalWeights& Weights)
+{
+	float Score = 0.0f;
+	for (const FSaTPlannerUnit& Unit : Units)
+	{
+		const float Sign = Unit.bIsPlayerUnit ? -1.0f : 1.0f;
+		Score += Sign * (Weights.Hp * Unit.AliveChance * Unit.Hp - (1.0f - Unit.AliveChance) * Weights.Kill);
+
+		if (Unit.bIsPlayerUnit || !Unit.IsLikelyAlive())
+		{
+			continue;
+		}
+
+		// Exposure: expected damage of the player units that can reach attack range next turn
+		int32 ClosestGap = MAX_int32;
+		for (const FSaTPlannerUnit& Enemy : Units)
+		{
+			if (!Enemy.bIsPlayerUnit || !Enemy.IsLikelyAlive())
+			{
+				continue;
+			}
+
+			const int32 Distance = FMath::Abs(Enemy.GridX - Unit.GridX) + FMath::Abs(Enemy.GridY - Unit.GridY);
+			if (Distance <= Enemy.Movement + Enemy.Range)
+			{
+				Score -= Weights.Exposure * Unit.AliveChance * Enemy.AliveChance * (Enemy.MinDamage + Enemy.MaxDamage) * 0.5f;
+			}
+			if (Unit.Type == EPieceUnit::SNIPER && Distance <= Unit.Range)
+			{
+				Score += Weights.LineControl * Unit.AliveChance * Enemy.AliveChance;
+			}
+			ClosestGap = FMath::Min(ClosestGap, FMath::Max(0, Distance - Unit.Range));
+		}
+
+		// Units out of the fight are pulled toward it
+		if (ClosestGap != MAX_int32)
+		{
+			Score -= Weights.Approach * ClosestGap;
+		}
+	}
+	return Score;
+}
+
+FSaTPlannerBoardKey FSaTTurnPlanner::MakeBoardKey(const TArray<FSaTPlannerUnit>& Units)
+{
+	FSaTPlannerBoardKey Key;
+	Key.Units.Reserve(Units.Num());
+	for (const FSaTPlannerUnit& Unit : Units)
+	{
+		if (Unit.AliveChance > 0.0f)
+		{
+			// Side in the top bit, then the cell, then the hit points
+			Key.Units.Add((Unit.bIsPlayerUnit ? 1u << 31 : 0u) | uint32(Unit.GridY) << 20 | uint32(Unit.GridX) << 10 | uint32(FMath::CeilToInt(Unit.Hp)));
+		}
+	}
+	return Key;
+}
+
+void FSaTTurnPlanner::ApplyAction(TArray<FSaTPlannerUnit>& Units, const FSaTPlannedAction& Action)
+{
+	FSaTPlannerUnit& Attacker = Units[Action.UnitIndex];
+	Attacker.GridX = Action.ToX;
+	Attacker.GridY = Action.ToY;
+
+	if (!Units.IsValidIndex(Action.TargetIndex))
+	{
+		return;
+	}
+
+	FSaTPlannerUnit& Target = Units[Action.TargetIndex];
+	const int32 Distance = FMath::Abs(Target.GridX - Attacker.GridX) + FMath::Abs(Target.GridY - Attacker.GridY);
+	const FSaTCombatOutcome Odds = FSaTCombatOdds::Get(Attacker.Type, Target.Type, Distance,
+		FMath::CeilToInt(Attacker.Hp), FMath::CeilToInt(Target.Hp), Attacker.MinDamage, Attacker.MaxDamage);
+
+	// The counterattack only comes if the target is still there and survives the attack
+	const float CounterChance = Target.AliveChance * Odds.CounterChance;
+
+	// Expected hit points of each side if it survives, next to the chance that it does
+	Target.Hp = FMath::Max(1.0f, Target.Hp - Odds.TargetHpLossIfSurvives);
+	Target.AliveChance *= 1.0f - Odds.TargetDies;
+
+	const float AttackerSurvives = 1.0f - CounterChance * Odds.CounterKills;
+	if (AttackerSurvives > 0.0f)
+	{
+		const float AttackerHpLoss = CounterChance * (1.0f - Odds.CounterKills) * Odds.CounterHpLossIfSurvives / AttackerSurvives;
+		Attacker.Hp = FMath::Max(1.0f, Attacker.Hp - AttackerHpLoss);
+	}
+	Attacker.AliveChance *= AttackerSurvives;
+}
+
+//----------------------------------------------
+// Planner table
+//----------------------------------------------
+
+const FSaTPlannerTable::FEntry* FSaTPlannerTable::Find(uint64 Key)
+{
+	FEntry* Entry = Entries.Find(Key);
+	if (Entry)
+	{
+		Entry->Generation = Generation;
+	}
+	return Entry;
+}
+
+void FSaTPlannerTable::Store(uint64 Key, float Score, const TArray<FSaTPlannedAction>& Continuation)
+{
+	if (Entries.Num() >= MaxEntries && !Entries.Contains(Key))
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries.FindOrAdd(Key);
+	Entry.Score = Score;
+	Entry.Continuation = Continuation;
+	Entry.Generation = Generation;
+}
+
+void FSaTPlannerTable::CheckContext(uint64 InContext)
+{
+	if (Context != InContext)
+	{
+		Entries.Reset();
+		Context = InContext;
+	}
+}
+
+void FSaTPlannerTable::NewGeneration()
+{
+	Generation++;
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (It.Value().Generation + 1 < Generation)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FSaTPlannerTable::Merge(const FSaTPlannerTable& Other)
+{
+	CheckContext(Other.Context);
+	for (const TPair<uint64, FEntry>& Pair : Other.Entries)
+	{
+		Store(Pair.Key, Pair.Value.Score, Pair.Value.Continuation);
+	}
+}
+
+void FSaTPlannerTable::Reset()
+{
+	Entries.Reset();
+	Generation = 0;
+	Context = 0;
+}
+
+SIZE_T FSaTPlannerTable::GetAllocatedSize() const
+{
+	SIZE_T Bytes = Entries.GetAllocatedSize();
+	for (const TPair<uint64, FEntry>& Pair : Entries)
+	{
+		Bytes += Pair.Value.Continuation.GetAllocatedSize();
+	}
+	return Bytes;
+}
@@ -0,0 +1,272 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_TurnPonderer.h"
+#include "SaT_CombatOdds.h"
+#include "SaT_Memory.h"
+#include "Async/Async.h"
+
+namespace
+{
+	/** Boards kept between the expansions of two predicted actions */
+	constexpr int32 MaxExpandedBoards = 64;
+
+	/** A board the human's turn may end on, with its chance under the prediction */
+	struct FPonderedBoard
+	{
+		TArray<FSaTPlannerUnit> Units;
+		float Chance = 1.0f;
+	};
+
+	void KillUnit(FSaTPlannerUnit& Unit)
+	{
+		Unit.Hp = 0.0f;
+		Unit.AliveChance = 0.0f;
+	}
+
+	/** Plays an action on a concrete board once per damage and counterattack roll */
+	void ExpandAction(const FPonderedBoard& Board, const FSaTPlannedAction& Action, TArray<FPonderedBoard>& OutBoards)
+	{
+		if (Board.Units[Action.UnitIndex].AliveChance <= 0.0f)
+		{
+			OutBoards.Add(Board);
+			return;
+		}
+
+		FPonderedBoard Moved = Board;
+		Moved.Units[Action.UnitIndex].GridX = Action.ToX;
+		Moved.Units[Action.UnitIndex].GridY = Action.ToY;
+		if (!Moved.Units.IsValidIndex(Action.TargetIndex) || Moved.Units[Action.TargetIndex].AliveChance <= 0.0f)
+		{
+			OutBoards.Add(MoveTemp(Moved));
+			return;
+		}
+
+		const FSaTPlannerUnit& Attacker = Moved.Units[Action.UnitIndex];
+		const FSaTPlannerUnit& Target = Moved.Units[Action.TargetIndex];
+		const int32 Distance = FMath::Abs(Target.GridX - Attacker.GridX) + FMath::Abs(Target.GridY - Attacker.GridY);
+		const bool bCounter = FSaTCombatOdds::CanCounterattack(Attacker.Type, Target.Type, Distance);
+		const int32 NumRolls = Attacker.MaxDamage - Attacker.MinDamage + 1;
+		const int32 NumCounterRolls = AUnit::MaxCounterDamage - AUnit::MinCounterDamage + 1;
+
+		for (int32 Damage = Attacker.MinDamage; Damage <= Attacker.MaxDamage; Damage++)
+		{
+			FPonderedBoard Hit = Moved;
+			Hit.Chance /= NumRolls;
+			FSaTPlannerUnit& HitTarget = Hit.Units[Action.TargetIndex];
+			if (Damage >= HitTarget.Hp)
+			{
+				KillUnit(HitTarget);
+				OutBoards.Add(MoveTemp(Hit));
+				continue;
+			}
+
+			HitTarget.Hp -= Damage;
+			if (!bCounter)
+			{
+				OutBoards.Add(MoveTemp(Hit));
+				continue;
+			}
+
+			for (int32 CounterDamage = AUnit::MinCounterDamage; CounterDamage <= AUnit::MaxCounterDamage; CounterDamage++)
+			{
+				FPonderedBoard Countered = Hit;
+				Countered.Chance /= NumCounterRolls;
+				FSaTPlannerUnit& CounteredAttacker = Countered.Units[Action.UnitIndex];
+				if (CounterDamage >= CounteredAttacker.Hp)
+				{
+					KillUnit(CounteredAttacker);
+				}
+				else
+				{
+					CounteredAttacker.Hp -= CounterDamage;
+				}
+				OutBoards.Add(MoveTemp(Countered));
+			}
+		}
+	}
+
+	/** Merges the boards with the same key and keeps the likeliest MaxBoards of them */
+	void MergeBoards(TArray<FPonderedBoard>& Boards, int32 MaxBoards)
+	{
+		TMap<FSaTPlannerBoardKey, int32> Merged;
+		TArray<FPonderedBoard> Unique;
+		for (FPonderedBoard& Board : Boards)
+		{
+			const FSaTPlannerBoardKey Key = FSaTTurnPlanner::MakeBoardKey(Board.Units);
+			if (const int32* Existing = Merged.Find(Key))
+			{
+				Unique[*Existing].Chance += Board.Chance;
+			}
+			else
+			{
+				Merged.Add(Key, Unique.Num());
+				Unique.Add(MoveTemp(Board));
+			}
+		}
+
+		Unique.StableSort([](const FPonderedBoard& A, const FPonderedBoard& B)
+			{
+				return A.Chance > B.Chance;
+			});
+		if (Unique.Num() > MaxBoards)
+		{
+			Unique.SetNum(MaxBoards);
+		}
+		Boards = MoveTemp(Unique);
+	}
+}
+
+FSaTTurnPonderer::~FSaTTurnPonderer()
+{
+	Stop();
+}
+
+void FSaTTurnPonderer::Start(const FGridSearchGrid& InStaticGrid, const FGridLineOfSight& InLineOfSight, bool bInRequireLineOfSight,
+	const TArray<FSaTPlannerUnit>& Units, const FSaTTurnPlannerSettings& InSettings)
+{
+	Stop();
+
+	StaticGrid = InStaticGrid;
+	bRequireLineOfSight = bInRequireLineOfSight;
+	LineOfSight = bRequireLineOfSight ? InLineOfSight : FGridLineOfSight();
+	RootUnits = Units;
+
+	// The worker searches from a copy of the caller's table and never writes to the caller's
+	Table = InSettings.Table ? *InSettings.Table : FSaTPlannerTable();
+	Settings = InSettings;
+	Settings.Table = &Table;
+	Settings.CancelFlag = &bCancel;
+	Plans.Reset();
+
+	bCancel.store(false);
+	Task = Async(EAsyncExecution::ThreadPool, [this]()
+		{
+			Run();
+		});
+}
+
+void FSaTTurnPonderer::Stop()
+{
+	if (Task.IsValid())
+	{
+		bCancel.store(true);
+		Task.Wait();
+		Task.Reset();
+	}
+}
+
+void FSaTTurnPonderer::MergeTableInto(FSaTPlannerTable& Target) const
+{
+	check(!IsRunning());
+	Target.Merge(Table);
+}
+
+SIZE_T FSaTTurnPonderer::GetTableAllocatedSize() const
+{
+	check(!IsRunning());
+	return Table.GetAllocatedSize();
+}
+
+bool FSaTTurnPonderer::Find(const TArray<FSaTPlannerUnit>& Units, FSaTTurnPlan& OutPlan) const
+{
+	check(!IsRunning());
+
+	const FPonderedPlan* Pondered = Plans.Find(FSaTTurnPlanner::MakeBoardKey(Units));
+	if (!Pondered || Pondered->LivingUnits.Num() != Units.Num())
+	{
+		return false;
+	}
+
+	// Same key, so the living units of the pondered board are the actual units in the same order
+	OutPlan = Pondered->Plan;
+	for (FSaTPlannedAction& Action : OutPlan.Actions)
+	{
+		Action.UnitIndex = Pondered->LivingUnits.Find(Action.UnitIndex);
+		Action.TargetIndex = Pondered->LivingUnits.Find(Action.TargetIndex);
+		if (Action.UnitIndex == INDEX_NONE)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FSaTTurnPonderer::Run()
+{
+	LLM_SCOPE_BYTAG(SaT_AISearch);
+
+	// AGridManager::CanAttackCell on the copied tables
+	auto CanAttackRef = [this](int32 FromX, int32 FromY, int32 ToX, int32 ToY, int32 Range)
+	{
+		return FGridBitboard::IsOffsetInRange(ToX - FromX, ToY - FromY, Range) &&
+			(!bRequireLineOfSight || LineOfSight.IsVisible(FromX, FromY, ToX, ToY));
+	};
+
+	// The human's likeliest turn: the planner playing the other side at its best
+	TArray<FSaTPlannerUnit> Flipped = RootUnits;
+	for (FSaTPlannerUnit& Unit : Flipped)
+	{
+		Unit.bIsPlayerUnit = !Unit.bIsPlayerUnit;
+		Unit.bHasActed = false;
+	}
+	FSaTTurnPlannerSettings PredictSettings = Settings;
+	PredictSettings.Temperature = 0.0f;
+	const FSaTTurnPlan Predicted = FSaTTurnPlanner::Plan(StaticGrid, Flipped, PredictSettings, CanAttackRef);
+	if (bCancel.load())
+	{
+		return;
+	}
+
+	// The concrete boards that turn ends on, likeliest first, after the board where the human only passes
+	TArray<FPonderedBoard> Expanded = { FPonderedBoard{ RootUnits, 1.0f } };
+	TArray<FPonderedBoard> Next;
+	for (const FSaTPlannedAction& Action : Predicted.Actions)
+	{
+		Next.Reset();
+		for (const FPonderedBoard& Board : Expanded)
+		{
+			ExpandAction(Board, Action, Next);
+		}
+		Swap(Expanded, Next);
+		MergeBoards(Expanded, MaxExpandedBoards);
+	}
+
+	TArray<FPonderedBoard> Boards = { FPonderedBoard{ RootUnits, 1.0f } };
+	Boards.Append(MoveTemp(Expanded));
+
+	// The AI's reply to each board, until the human's turn ends
+	for (const FPonderedBoard& Board : Boards)
+	{
+		if (Plans.Num() >= MaxPonderedBoards || bCancel.load())
+		{
+			break;
+		}
+
+		FSaTPlannerBoardKey Key = FSaTTurnPlanner::MakeBoardKey(Board.Units);
+		if (Plans.Contains(Key))
+		{
+			continue;
+		}
+
+		FPonderedPlan Pondered;
+		Pondered.Plan = FSaTTurnPlanner::Plan(StaticGrid, Board.Units, Settings, CanAttackRef);
+
+		// A plan the turn cut short is not the plan the AI would find, so it is dropped
+		if (bCancel.load())
+		{
+			break;
+		}
+
+		for (int32 Index = 0; Index < Board.Units.Num(); Index++)
+		{
+			if (Board.Units[Index].AliveChance > 0.0f)
+			{
+				Pondered.LivingUnits.Add(Index);
+			}
+		}
+		Plans.Add(MoveTemp(Key), MoveTemp(Pondered));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("AI: Pondered %d boards of the human turn (%d predicted actions)"), Plans.Num(), Predicted.Actions.Num());
+}
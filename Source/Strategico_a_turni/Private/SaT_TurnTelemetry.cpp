@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_TurnTelemetry.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+CSV_DEFINE_CATEGORY(SaT, true);
+
+namespace
+{
+	TAutoConsoleVariable<int32> CVarSaTTurnTelemetry(
+		TEXT("SaT.TurnTelemetry"),
+		0,
+		TEXT("Writes one CSV row of performance counters per turn to Saved/Profiling/SaT (0 = off, 1 = on)."));
+}
+
+//----------------------------------------------
+// Counters
+//----------------------------------------------
+
+void FSaTTurnCounters::Reset()
+{
+	AIDecisionMs = 0.0;
+	HUDRefreshMs = 0.0;
+	PathfindingCalls = 0;
+	NodesExpanded = 0;
+	TilesRematerialized = 0;
+	LogEntriesAdded = 0;
+	HUDRefreshes = 0;
+	Frames = 0;
+	GameThreadSumMs = 0.0;
+	GameThreadMaxMs = 0.0;
+}
+
+//----------------------------------------------
+// Recorder
+//----------------------------------------------
+
+FSaTTurnTelemetry& FSaTTurnTelemetry::Get()
+{
+	static FSaTTurnTelemetry Instance;
+	return Instance;
+}
+
+FSaTTurnTelemetry::FSaTTurnTelemetry()
+{
+	if (FParse::Param(FCommandLine::Get(), TEXT("SaTTurnTelemetry")))
+	{
+		CVarSaTTurnTelemetry->Set(1);
+	}
+
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FSaTTurnTelemetry::OnEndFrame);
+	PreExitHandle = FCoreDelegates::OnPreExit.AddRaw(this, &FSaTTurnTelemetry::Shutdown);
+	TurnStartSeconds = FPlatformTime::Seconds();
+}
+
+FSaTTurnTelemetry::~FSaTTurnTelemetry()
+{
+	Shutdown();
+}
+
+void FSaTTurnTelemetry::Shutdown()
+{
+	// The handles are reset once removed, so the delegates are not touched again after engine exit
+	if (EndFrameHandle.IsValid())
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		EndFrameHandle.Reset();
+	}
+	if (PreExitHandle.IsValid())
+	{
+		FCoreDelegates::OnPreExit.Remove(PreExitHandle);
+		PreExitHandle.Reset();
+	}
+}
+
+bool FSaTTurnTelemetry::IsEnabled()
+{
+	return CVarSaTTurnTelemetry.GetValueOnGameThread() != 0;
+}
+
+void FSaTTurnTelemetry::OnEndFrame()
+{
+	const double GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	Counters.Frames++;
+	Counters.GameThreadSumMs += GameThreadMs;
+	Counters.GameThreadMaxMs = FMath::Max(Counters.GameThreadMaxMs, GameThreadMs);
+}
+
+void FSaTTurnTelemetry::BeginMatch()
+{
+	MatchIndex++;
+	BeginTurn();
+}
+
+void FSaTTurnTelemetry::BeginTurn()
+{
+	Counters.Reset();
+	TurnStartSeconds = FPlatformTime::Seconds();
+}
+
+void FSaTTurnTelemetry::EndTurn(int32 TurnNumber, bool bHumanTurn, int32 LogEntries, bool bGameOver)
+{
+	const double TurnWallMs = (FPlatformTime::Seconds() - TurnStartSeconds) * 1000.0;
+	const double GameThreadAvgMs = Counters.Frames > 0 ? Counters.GameThreadSumMs / Counters.Frames : 0.0;
+
+	// Also mark the turn in CSV profiler captures (-csvCaptureFrames), so both outputs line up
+	CSV_EVENT(SaT, TEXT("EndTurn %d %s"), TurnNumber, bHumanTurn ? TEXT("Human") : TEXT("AI"));
+	CSV_CUSTOM_STAT(SaT, AIDecisionMs, Counters.AIDecisionMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SaT, PathfindingNodes, int32(Counters.NodesExpanded.load()), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SaT, HUDRefreshMs, Counters.HUDRefreshMs, ECsvCustomStatOp::Set);
+
+	if (IsEnabled())
+	{
+		// One file per session; the header goes in with the first row
+		FString Row;
+		if (FilePath.IsEmpty())
+		{
+			FilePath = FPaths::Combine(FPaths::ProfilingDir(), TEXT("SaT"),
+				FString::Printf(TEXT("TurnTelemetry-%s.csv"), *FDateTime::Now().ToString()));
+			Row = TEXT("Match,Turn,Player,GameOver,TurnWallMs,AIDecisionMs,PathfindingCalls,NodesExpanded,TilesRematerialized,")
+				TEXT("LogEntries,LogEntriesAdded,HUDRefreshes,HUDRefreshMs,Frames,GameThreadAvgMs,GameThreadMaxMs\n");
+		}
+
+		Row += FString::Printf(TEXT("%d,%d,%s,%d,%.3f,%.3f,%d,%lld,%d,%d,%d,%d,%.3f,%d,%.3f,%.3f\n"),
+			MatchIndex, TurnNumber, bHumanTurn ? TEXT("Human") : TEXT("AI"), bGameOver ? 1 : 0,
+			TurnWallMs, Counters.AIDecisionMs, Counters.PathfindingCalls.load(), Counters.NodesExpanded.load(), Counters.TilesRematerialized.load(),
+			LogEntries, Counters.LogEntriesAdded.load(), Counters.HUDRefreshes.load(), Counters.HUDRefreshMs,
+			Counters.Frames, GameThreadAvgMs, Counters.GameThreadMaxMs);
+
+		if (!FFileHelper::SaveStringToFile(Row, *FilePath, FFileHelper::EEncodingOptions::ForceAnsi, &IFileManager::Get(), FILEWRITE_Append))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Could not write turn telemetry to %s"), *FilePath);
+		}
+	}
+
+	BeginTurn();
+}
+
+//----------------------------------------------
+// Scope Timer
+//----------------------------------------------
+
+FSaTTelemetryScope::FSaTTelemetryScope(double& InTargetMs)
+	: TargetMs(InTargetMs)
+	, StartCycles(FPlatformTime::Cycles64())
+{
+	check(IsInGameThread());
+}
+
+FSaTTelemetryScope::~FSaTTelemetryScope()
+{
+	TargetMs += FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+}
@@ -9,6 +9,10 @@
 #include "SaT_HumanPlayer.h"
 #include "SaT_RandomPlayer.h"
 #include "SaT_GameInstance.h"
+#include "SaT_Stats.h"
+#include "SaT_TurnTelemetry.h"
+#include "SaT_Memory.h"
+#include "SaT_EndgameTablebase.h"
 #include "Blueprint/UserWidget.h"
 #include "Components/Button.h"
 #include "Kismet/GameplayStatics.h"
@@ -101,6 +105,9 @@ void ASaT_GameMode::BeginPlay()
     // Schedule game start after a short delay
     if (Gmanager)
     {
+        // Map (or generate in the background) the 1v1 endgame table the AI plays from, long before any endgame is reached
+        FSaTEndgameTablebase::Get().LoadOrGenerateAsync(FSaTEndgameRules::FromUnitDefaults(Gmanager->Size));
+
         FTimerHandle TimerHandle;
         GetWorldTimerManager().SetTimer(TimerHandle, this, &ASaT_GameMode::StartGame, 2.0f, false);
     }
@@ -317,6 +324,9 @@ void ASaT_GameMode::StartGame()
         return;
     }
 
+    // Telemetry rows of the new match start from here
+    FSaTTurnTelemetry::Get().BeginMatch();
+
     // Flip a coin to decide who goes first
     FlipCoinToDecideFirstPlayer();
 
@@ -441,21 +451,30 @@ void ASaT_GameMode::StartFirstTurn()
  */
 void ASaT_GameMode::EndTurn()
 {
+    // Get the current game phase from GameInstance
+    USaT_GameInstance* GameInstance = Cast<USaT_GameInstance>(UGameplayStatics::GetGameInstance(GetWorld()));
+
     // Check if game is over before switching turns
     if (CheckGameOver())
     {
+        if (GameInstance)
+        {
+            FSaTTurnTelemetry::Get().EndTurn(GameInstance->CurrentTurnNumber, GameInstance->bIsPlayerTurn, GameLog.Num(), true);
+        }
+
         UE_LOG(LogTemp, Display, TEXT("Game is over! Not switching turns."));
         return;
     }
 
-    // Get the current game phase from GameInstance
-    USaT_GameInstance* GameInstance = Cast<USaT_GameInstance>(UGameplayStatics::GetGameInstance(GetWorld()));
     if (!GameInstance)
     {
         UE_LOG(LogTemp, Error, TEXT("Failed to get GameInstance in EndTurn!"));
         return;
     }
 
+    // Close the telemetry row of the turn that is ending, before the turn number moves on
+    FSaTTurnTelemetry::Get().EndTurn(GameInstance->CurrentTurnNumber, GameInstance->bIsPlayerTurn, GameLog.Num(), false);
+
     if (Players.IsValidIndex(CurrentPlayer))
     {
         Players[CurrentPlayer]->IsMyTurn = false;
@@ -483,6 +502,8 @@ void ASaT_GameMode::EndTurn()
  */
 bool ASaT_GameMode::CheckGameOver()
 {
+    SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_CheckGameOver);
+
     // Get the current game phase from GameInstance
     USaT_GameInstance* GameInstance = Cast<USaT_GameInstance>(UGameplayStatics::GetGameInstance(GetWorld()));
     if (!GameInstance)
@@ -503,6 +524,7 @@ bool ASaT_GameMode::CheckGameOver()
         // Get all units
         TArray<AActor*> AllUnits;
         UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+        INC_DWORD_STAT_BY(STAT_SaT_ActorsScanned, AllUnits.Num());
 
         for (AActor* UnitActor : AllUnits)
         {
@@ -617,9 +639,20 @@ bool ASaT_GameMode::CheckPotentialDraw(const TArray<AUnit*>& HumanUnits, const T
     // 1. To be within attack range of each other
     // 2. Have HP so low that counterattack would kill them
 
-    // First, check if they can attack each other
-    bool HumanCanAttackAI = HumanSniper->IsTargetInRange(AISniper);
-    bool AICanAttackHuman = AISniper->IsTargetInRange(HumanSniper);
+    // First, check if they can attack each other: each unit's cell must be
+    // threatened by the other team's occupancy through the range masks
+    bool HumanCanAttackAI;
+    bool AICanAttackHuman;
+    if (Gmanager)
+    {
+        HumanCanAttackAI = Gmanager->GetThreatsToCell(AISniper->GridX, AISniper->GridY, true).Test(HumanSniper->GridX, HumanSniper->GridY);
+        AICanAttackHuman = Gmanager->GetThreatsToCell(HumanSniper->GridX, HumanSniper->GridY, false).Test(AISniper->GridX, AISniper->GridY);
+    }
+    else
+    {
+        HumanCanAttackAI = HumanSniper->IsTargetInRange(AISniper);
+        AICanAttackHuman = AISniper->IsTargetInRange(HumanSniper);
+    }
 
     if (!HumanCanAttackAI || !AICanAttackHuman)
         return false;
@@ -642,6 +675,7 @@ void ASaT_GameMode::HandleDrawCondition()
 {
     TArray<AActor*> AllUnits;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+    INC_DWORD_STAT_BY(STAT_SaT_ActorsScanned, AllUnits.Num());
 
     // Count living units by team
     int32 HumanUnitsAlive = 0;
@@ -764,6 +798,7 @@ void ASaT_GameMode::NotifyCurrentPlayerTurn()
     // Reset movement and attack flags for units
     TArray<AActor*> AllUnits;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+    INC_DWORD_STAT_BY(STAT_SaT_ActorsScanned, AllUnits.Num());
 
     for (AActor* UnitActor : AllUnits)
     {
@@ -861,9 +896,15 @@ void ASaT_GameMode::NotifyUnitDeath(AUnit* DeadUnit)
  */
 void ASaT_GameMode::UpdateGameHUD()
 {
+    SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_UpdateGameHUD);
+    SAT_TELEMETRY_SCOPE(HUDRefreshMs);
+    LLM_SCOPE_BYTAG(SaT_LogHUD);
+    SAT_TELEMETRY_ADD(HUDRefreshes, 1);
+
     // Find all player units and get their status
     TArray<AActor*> AllUnits;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+    INC_DWORD_STAT_BY(STAT_SaT_ActorsScanned, AllUnits.Num());
 
     // Initialize default values
     PlayerSniperHP = 0;
@@ -1019,6 +1060,46 @@ FString ASaT_GameMode::GetSelectedUnitInfoText() const
 void ASaT_GameMode::AddFormattedMoveToLog(bool bIsPlayerUnit, const FString& UnitType, const FString& ActionType,
     const FVector2D& FromPosition, const FVector2D& ToPosition, int32 Damage)
 {
+    SAT_SCOPE_CYCLE_COUNTER(STAT_SaT_AddMoveToLog);
+    SAT_TELEMETRY_ADD(LogEntriesAdded, 1);
+    LLM_SCOPE_BYTAG(SaT_LogHUD);
+
+    // Record the action for the AI before any formatting or deduplication
+    FSaTGameEvent Event;
+    Event.bIsPlayerUnit = bIsPlayerUnit;
+    Event.FromX = FMath::RoundToInt(FromPosition.X);
+    Event.FromY = FMath::RoundToInt(FromPosition.Y);
+    Event.ToX = FMath::RoundToInt(ToPosition.X);
+    Event.ToY = FMath::RoundToInt(ToPosition.Y);
+    Event.Damage = Damage;
+
+    bool bIsGameEvent = true;
+    if (ActionType == TEXT("Move"))
+    {
+        Event.Type = FSaTGameEvent::EType::Move;
+    }
+    else if (ActionType == TEXT("Attack"))
+    {
+        Event.Type = FSaTGameEvent::EType::Attack;
+    }
+    else if (ActionType == TEXT("Counterattack"))
+    {
+        Event.Type = FSaTGameEvent::EType::Counterattack;
+    }
+    else if (ActionType == TEXT("Place"))
+    {
+        Event.Type = FSaTGameEvent::EType::Place;
+    }
+    else
+    {
+        bIsGameEvent = false;
+    }
+
+    if (bIsGameEvent)
+    {
+        GameEvents.Add(Event);
+    }
+
     // Format the player identifier
     FString PlayerIdentifier = bIsPlayerUnit ? TEXT("PLAYER") : TEXT("AI");
 
@@ -1145,6 +1226,50 @@ FString ASaT_GameMode::GetFormattedGameLog() const
     return History;
 }
 
+/*
+ * Returns the latest AI search statistics
+ * Polls the feed without blocking; the previous statistics stay when nothing new was published
+ */
+FSaTAISearchStats ASaT_GameMode::GetAISearchStats()
+{
+    FSaTSearchSnapshot Snapshot;
+    if (AISearchFeed.Poll(Snapshot))
+    {
+        AISearchStats = FSaTAISearchStats::FromSnapshot(Snapshot);
+    }
+    return AISearchStats;
+}
+
+/*
+ * Returns the memory held by the game log and the HUD strings
+ * Used by the memory budget report to catch a log that keeps growing
+ */
+SIZE_T ASaT_GameMode::GetLogAllocatedSize() const
+{
+    SIZE_T Bytes = GameLog.GetAllocatedSize() + RawMoveHistory.GetAllocatedSize() + FormattedEntry.GetAllocatedSize() +
+        GameEvents.GetAllocatedSize();
+    for (const FString& Entry : GameLog)
+    {
+        Bytes += Entry.GetAllocatedSize();
+    }
+    for (const FString& Entry : RawMoveHistory)
+    {
+        Bytes += Entry.GetAllocatedSize();
+    }
+
+    const FString* HUDStrings[] = {
+        &PlayerSniperPos, &PlayerBrawlerPos, &AISniperPos, &AIBrawlerPos,
+        &PlayerSniperHPFormatted, &PlayerBrawlerHPFormatted, &AISniperHPFormatted, &AIBrawlerHPFormatted,
+        &TurnText, &CoinflipResult, &WinnerText
+    };
+    for (const FString* HUDString : HUDStrings)
+    {
+        Bytes += HUDString->GetAllocatedSize();
+    }
+
+    return Bytes;
+}
+
 /*
  * Shows or hides the AI thinking widget
  * @param bShow Whether to show (true) or hide (false) the widget
@@ -1299,10 +1424,10 @@ void ASaT_GameMode::ResetGame()
     // Hide game over widget first
     ShowGameOverWidget(false);
 
-    // Destroy ALL actors of relevant classes
-    TArray<AActor*> AllUnits, AllTiles;
+    // Destroy all units; tiles are kept and reused by GenerateField below
+    TArray<AActor*> AllUnits;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ATile::StaticClass(), AllTiles);
+    INC_DWORD_STAT_BY(STAT_SaT_ActorsScanned, AllUnits.Num());
 
     // Destroy units
     for (AActor* UnitActor : AllUnits)
@@ -1313,15 +1438,6 @@ void ASaT_GameMode::ResetGame()
         }
     }
 
-    // Destroy tiles
-    for (AActor* TileActor : AllTiles)
-    {
-        if (TileActor)
-        {
-            TileActor->Destroy();
-        }
-    }
-
     // Reset game state in GameInstance
     GameInstance->CurrentPhase = EGamePhase::SETUP;
     GameInstance->bIsPlayerTurn = true;  // Ensure it starts on player turn
@@ -1333,6 +1449,7 @@ void ASaT_GameMode::ResetGame()
     // Clear any stored game data
     GameLog.Empty();
     RawMoveHistory.Empty();
+    GameEvents.Empty();
     CurrentlySelectedUnit = nullptr;
 
     // Reset current player state
@@ -1368,15 +1485,11 @@ void ASaT_GameMode::ResetGame()
     // Reset and regenerate the grid
     if (Gmanager)
     {
-        // Clear all data structures
+        // Clear highlights
         Gmanager->ClearAllHighlights();
         Gmanager->ClearPathHighlights();
-        Gmanager->TileArray.Empty();
-        Gmanager->TileMap.Empty();
-        Gmanager->HighlightedTiles.Empty();
-        Gmanager->PathTiles.Empty();
 
-        // Regenerate the grid
+        // Regenerate the grid; GenerateField reuses the existing tiles
         Gmanager->GenerateField();
     }
     else
@@ -10,12 +10,12 @@
 ASniper::ASniper()
 {
     
-    Hp = 20;
-    Movement = 3;
+    Hp = DefaultHp;
+    Movement = DefaultMovement;
     //TypeofAttack = FString::"Distance";
-    RangeAttack = 10;
-    MinDamage = 4;
-    MaxDamage = 8;
+    RangeAttack = DefaultRangeAttack;
+    MinDamage = DefaultMinDamage;
+    MaxDamage = DefaultMaxDamage;
 
     UnitTypeDisplayName = TEXT("Sniper");
 }
@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridBenchmarkCommandlet.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridBenchmarkThresholdTest, "Strategico_a_turni.Grid.BenchmarkThreshold",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridBenchmarkThresholdTest::RunTest(const FString& Parameters)
+{
+	UGridBenchmarkCommandlet* Commandlet = NewObject<UGridBenchmarkCommandlet>();
+	const FString Board = TEXT("-sizes=25 -densities=0.2 -queries=10");
+
+	TestEqual(TEXT("No threshold"), Commandlet->Main(Board), 0);
+	TestEqual(TEXT("Threshold no query reaches"), Commandlet->Main(Board + TEXT(" -maxp99=1000000")), 0);
+
+	// Any timed query is over a threshold of a picosecond; each query kind over it is reported
+	AddExpectedError(TEXT("over the"), EAutomationExpectedErrorFlags::Contains, 0);
+	TestEqual(TEXT("Threshold every query exceeds"), Commandlet->Main(Board + TEXT(" -maxp99=0.000001")), 2);
+	return true;
+}
+
+#endif
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridLineOfSight.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	FGridBitboard MakeRandomObstacles(float Density, FRandomStream& Stream)
+	{
+		FGridBitboard Obstacles;
+		for (int32 Y = 0; Y < FGridBitboard::Stride; Y++)
+		{
+			for (int32 X = 0; X < FGridBitboard::Stride; X++)
+			{
+				if (Stream.FRand() < Density)
+				{
+					Obstacles.Set(X, Y);
+				}
+			}
+		}
+		return Obstacles;
+	}
+
+	/** Compares the precomputed visibility of every pair within MaxRange with a ray traced on the obstacles; returns the mismatches */
+	int32 CountMismatches(const FGridLineOfSight& LineOfSight, const FGridBitboard& Obstacles)
+	{
+		int32 Mismatches = 0;
+		for (int32 FromY = 0; FromY < FGridBitboard::Stride; FromY++)
+		{
+			for (int32 FromX = 0; FromX < FGridBitboard::Stride; FromX++)
+			{
+				const FGridBitboard InRange = FGridBitboard::MakeRangeMask(FromX, FromY, FGridLineOfSight::MaxRange);
+				InRange.ForEachSetCell([&](int32 ToX, int32 ToY)
+					{
+						if (LineOfSight.IsVisible(FromX, FromY, ToX, ToY) != FGridLineOfSight::TraceRay(FromX, FromY, ToX, ToY, Obstacles))
+						{
+							Mismatches++;
+						}
+					});
+			}
+		}
+		return Mismatches;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridLineOfSightTest, "Strategico_a_turni.Grid.LineOfSight",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridLineOfSightTest::RunTest(const FString& Parameters)
+{
+	const FGridBitboard& AllCells = FGridBitboard::GetAllCellsMask();
+	FGridLineOfSight LineOfSight;
+
+	// A single obstacle blocks the rays through it but not the rays ending on it
+	FGridBitboard Obstacles;
+	Obstacles.Set(5, 5);
+	LineOfSight.Build(Obstacles, AllCells);
+	TestFalse(TEXT("Blocked along the row"), LineOfSight.IsVisible(3, 5, 7, 5));
+	TestFalse(TEXT("Blocked along the column"), LineOfSight.IsVisible(5, 3, 5, 7));
+	TestTrue(TEXT("The obstacle cell itself is visible"), LineOfSight.IsVisible(3, 5, 5, 5));
+	TestTrue(TEXT("A ray beside the obstacle is clear"), LineOfSight.IsVisible(3, 6, 7, 6));
+	TestFalse(TEXT("Blocked past MaxRange"), LineOfSight.IsVisible(5, 0, 5, 24));
+
+	// A ray through a corner is only blocked if both cells beside the corner are
+	Obstacles.Reset();
+	Obstacles.Set(1, 0);
+	LineOfSight.Build(Obstacles, AllCells);
+	TestTrue(TEXT("One side of the corner blocked"), LineOfSight.IsVisible(0, 0, 1, 1));
+	Obstacles.Set(0, 1);
+	LineOfSight.Build(Obstacles, AllCells);
+	TestFalse(TEXT("Both sides of the corner blocked"), LineOfSight.IsVisible(0, 0, 1, 1));
+
+	// The tables agree with the traced rays on seeded boards
+	FRandomStream Stream(2024);
+	for (float Density : { 0.1f, 0.3f })
+	{
+		Obstacles = MakeRandomObstacles(Density, Stream);
+		LineOfSight.Build(Obstacles, AllCells);
+		TestEqual(FString::Printf(TEXT("Built tables against traced rays at density %.1f"), Density), CountMismatches(LineOfSight, Obstacles), 0);
+	}
+
+	// Patched tables end where a fresh build would
+	for (int32 Change = 0; Change < 40; Change++)
+	{
+		const int32 X = Stream.RandRange(0, FGridBitboard::Stride - 1);
+		const int32 Y = Stream.RandRange(0, FGridBitboard::Stride - 1);
+		if (Obstacles.Test(X, Y))
+		{
+			Obstacles.Clear(X, Y);
+		}
+		else
+		{
+			Obstacles.Set(X, Y);
+		}
+		LineOfSight.NotifyObstacleChanged(X, Y, Obstacles);
+	}
+	TestEqual(TEXT("Patched tables against traced rays"), CountMismatches(LineOfSight, Obstacles), 0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridPathfinding.h"
+#include "GridHierarchicalPathfinder.h"
+#include "GridDistanceTable.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Small enough that every test board is cut into several clusters
+	constexpr int32 TestClusterSize = 8;
+
+	constexpr int32 QueriesPerBoard = 100;
+
+	/** Seeded board: Density of the cells are obstacles, and with bTerrain some of the others cost 2 or 3 to enter */
+	void MakeBoard(int32 Size, float Density, bool bTerrain, FRandomStream& Stream, FGridSearchGrid& OutGrid)
+	{
+		OutGrid.Init(Size, 1);
+		for (uint8& Cost : OutGrid.StepCost)
+		{
+			Cost = Stream.FRand() < Density ? 0 : 1;
+			if (Cost != 0 && bTerrain && Stream.FRand() < 0.3f)
+			{
+				Cost = uint8(Stream.RandRange(2, 3));
+			}
+		}
+	}
+
+	FIntPoint PickPassableCell(const FGridSearchGrid& Grid, FRandomStream& Stream)
+	{
+		for (;;)
+		{
+			const int32 X = Stream.RandRange(0, Grid.Size - 1);
+			const int32 Y = Stream.RandRange(0, Grid.Size - 1);
+			if (Grid.IsPassable(Grid.ToIndex(X, Y)))
+			{
+				return FIntPoint(X, Y);
+			}
+		}
+	}
+
+	/**
+	 * Returns the cost of a path, or INDEX_NONE if it does not join Start to Goal one orthogonal step at a time
+	 * through passable cells (the start cell excepted)
+	 */
+	int32 GetPathCost(const FGridSearchGrid& Grid, const TArray<FVector2D>& Path, FIntPoint Start, FIntPoint Goal)
+	{
+		if (Path.Num() == 0 || FIntPoint(Path[0].X, Path[0].Y) != Start || FIntPoint(Path.Last().X, Path.Last().Y) != Goal)
+		{
+			return INDEX_NONE;
+		}
+
+		int32 Cost = 0;
+		for (int32 Step = 1; Step < Path.Num(); Step++)
+		{
+			const FIntPoint From(Path[Step - 1].X, Path[Step - 1].Y);
+			const FIntPoint To(Path[Step].X, Path[Step].Y);
+			if (FMath::Abs(To.X - From.X) + FMath::Abs(To.Y - From.Y) != 1 || !Grid.IsValidCell(To.X, To.Y) ||
+				!Grid.IsPassable(Grid.ToIndex(To.X, To.Y)))
+			{
+				return INDEX_NONE;
+			}
+			Cost += Grid.StepCost[Grid.ToIndex(To.X, To.Y)];
+		}
+		return Cost;
+	}
+}
+
+//----------------------------------------------
+// A*, HPA* and the distance sweep on the same queries
+//----------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridPathfindingAgreementTest, "Strategico_a_turni.Grid.PathfindingAgreement",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridPathfindingAgreementTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Stream(1337);
+	FGridSearchGrid Grid;
+	FGridDistanceField Field;
+	FGridDistanceField Scratch;
+	TArray<FVector2D> Path;
+
+	for (int32 Size : { 25, 64 })
+	{
+		for (float Density : { 0.1f, 0.3f })
+		{
+			MakeBoard(Size, Density, false, Stream, Grid);
+			FGridHierarchicalPathfinder Hierarchical;
+			Hierarchical.Build(&Grid, TestClusterSize);
+
+			for (int32 Query = 0; Query < QueriesPerBoard; Query++)
+			{
+				const FIntPoint Start = PickPassableCell(Grid, Stream);
+				const FIntPoint Goal = PickPassableCell(Grid, Stream);
+				const FString Context = FString::Printf(TEXT("%dx%d at density %.1f, (%d, %d) to (%d, %d)"),
+					Size, Size, Density, Start.X, Start.Y, Goal.X, Goal.Y);
+
+				// The breadth-first sweep is the reference: every step costs 1
+				FGridPathfinding::ComputeDistanceField(Grid, Start.X, Start.Y, Field);
+				const bool bReachable = Field.IsReachable(Goal.X, Goal.Y);
+				const int32 Distance = Field.GetDistance(Goal.X, Goal.Y);
+
+				const bool bFoundAStar = FGridPathfinding::FindPath(Grid, Start.X, Start.Y, Goal.X, Goal.Y, Path, Scratch);
+				TestEqual(FString::Printf(TEXT("A* finds a path iff the sweep reaches the goal, %s"), *Context), bFoundAStar, bReachable);
+				if (bFoundAStar && bReachable)
+				{
+					TestEqual(FString::Printf(TEXT("A* path length, %s"), *Context), GetPathCost(Grid, Path, Start, Goal), Distance);
+				}
+
+				// HPA* is shortest through its entrances only, so never shorter than the sweep
+				const bool bFoundHierarchical = Hierarchical.FindPath(Start.X, Start.Y, Goal.X, Goal.Y, Path);
+				TestEqual(FString::Printf(TEXT("HPA* finds a path iff the sweep reaches the goal, %s"), *Context), bFoundHierarchical, bReachable);
+				if (bFoundHierarchical && bReachable)
+				{
+					const int32 Length = GetPathCost(Grid, Path, Start, Goal);
+					TestTrue(FString::Printf(TEXT("HPA* path is connected, %s"), *Context), Length != INDEX_NONE);
+					TestTrue(FString::Printf(TEXT("HPA* path is no shorter than the shortest, %s"), *Context), Length >= Distance);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------
+// Distance table
+//----------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridDistanceTableTest, "Strategico_a_turni.Grid.DistanceTable",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridDistanceTableTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Stream(4242);
+	FGridSearchGrid Grid;
+	FGridDistanceField Scratch;
+	TArray<FVector2D> Path;
+
+	// The game's board, with terrain so the table is checked against weighted A* as well
+	for (bool bTerrain : { false, true })
+	{
+		MakeBoard(25, 0.2f, bTerrain, Stream, Grid);
+		FGridDistanceTable Table;
+		if (!TestTrue(TEXT("The table is built on a 25x25 board"), Table.Build(Grid)))
+		{
+			return false;
+		}
+
+		for (int32 Query = 0; Query < QueriesPerBoard; Query++)
+		{
+			const FIntPoint Start = PickPassableCell(Grid, Stream);
+			const FIntPoint Goal = PickPassableCell(Grid, Stream);
+			const FString Context = FString::Printf(TEXT("%s, (%d, %d) to (%d, %d)"),
+				bTerrain ? TEXT("terrain") : TEXT("no terrain"), Start.X, Start.Y, Goal.X, Goal.Y);
+
+			const int32 TableDistance = Table.GetDistance(Start.X, Start.Y, Goal.X, Goal.Y);
+			if (!FGridPathfinding::FindPath(Grid, Start.X, Start.Y, Goal.X, Goal.Y, Path, Scratch))
+			{
+				TestEqual(FString::Printf(TEXT("Unreachable pair, %s"), *Context), TableDistance, int32(MAX_int32));
+				continue;
+			}
+
+			const int32 Cost = GetPathCost(Grid, Path, Start, Goal);
+			TestEqual(FString::Printf(TEXT("Table distance is the A* path cost, %s"), *Context), TableDistance,
+				FMath::Min<int32>(Cost, FGridDistanceTable::MaxEntry));
+
+			// As the heuristic it must not change the cost of the path A* finds
+			FGridPathfinding::FindPath(Grid, Start.X, Start.Y, Goal.X, Goal.Y, Path, Scratch, nullptr, &Table);
+			TestEqual(FString::Printf(TEXT("A* with the table heuristic, %s"), *Context), GetPathCost(Grid, Path, Start, Goal), Cost);
+		}
+	}
+
+	// A cell walled in by obstacles is reachable from nowhere else
+	Grid.Init(5, 1);
+	Grid.StepCost[Grid.ToIndex(1, 0)] = 0;
+	Grid.StepCost[Grid.ToIndex(0, 1)] = 0;
+	FGridDistanceTable Walled;
+	Walled.Build(Grid);
+	TestEqual(TEXT("Walled-in corner"), Walled.GetDistance(4, 4, 0, 0), int32(MAX_int32));
+	TestEqual(TEXT("Open corner to corner"), Walled.GetDistance(4, 4, 2, 0), 6);
+
+	// Boards over MaxCells are left to the searches
+	Grid.Init(33, 1);
+	FGridDistanceTable Oversized;
+	TestFalse(TEXT("No table over MaxCells"), Oversized.Build(Grid));
+	TestEqual(TEXT("Distance without a table"), Oversized.GetDistance(0, 0, 1, 0), int32(MAX_int32));
+	return true;
+}
+
+#endif
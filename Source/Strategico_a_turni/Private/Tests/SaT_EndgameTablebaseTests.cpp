@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_EndgameTablebase.h"
+#include "GridBitboard.h"
+#include "Sniper.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSaTEndgameTablebaseTest, "Strategico_a_turni.AI.EndgameTablebase",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSaTEndgameTablebaseTest::RunTest(const FString& Parameters)
+{
+	const FSaTEndgameRules Rules = FSaTEndgameRules::FromUnitDefaults(FGridBitboard::Stride);
+	FSaTEndgameTablebase Tablebase;
+	const FSaTEndgameValue Unloaded = Tablebase.Lookup(EPieceUnit::SNIPER, EPieceUnit::BRAWLER, 20, 1, 1);
+	TestTrue(TEXT("A table not loaded is a draw"), Unloaded.Win == 0.0f && Unloaded.Loss == 0.0f);
+
+	// The table the game maps, solved and saved the same way
+	TArray<FSaTEndgameTablebase::FEntry> Entries;
+	FSaTEndgameTablebase::Generate(Rules, Entries);
+	TestEqual(TEXT("One entry per position"), Entries.Num(), Rules.GetNumEntries());
+
+	const FString Path = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("EndgameTest.sattb"));
+	if (!TestTrue(TEXT("Saved"), FSaTEndgameTablebase::SaveToFile(Path, Rules, Entries)) ||
+		!TestTrue(TEXT("Mapped back"), Tablebase.LoadFromFile(Path, Rules)))
+	{
+		return false;
+	}
+
+	// A Sniper within its move and range of a Brawler its smallest roll kills always wins
+	const int32 SniperReach = ASniper::DefaultMovement + ASniper::DefaultRangeAttack;
+	for (int32 HpSniper = 1; HpSniper <= ASniper::DefaultHp; HpSniper++)
+	{
+		for (int32 HpBrawler = 1; HpBrawler <= ASniper::DefaultMinDamage; HpBrawler++)
+		{
+			for (int32 Distance = 1; Distance <= SniperReach; Distance++)
+			{
+				const FSaTEndgameValue Value = Tablebase.Lookup(EPieceUnit::SNIPER, EPieceUnit::BRAWLER, HpSniper, HpBrawler, Distance);
+				TestTrue(FString::Printf(TEXT("Sniper %d hp wins against Brawler %d hp at %d"), HpSniper, HpBrawler, Distance),
+					Value.Win >= 0.99f && Value.Loss == 0.0f);
+			}
+		}
+	}
+
+	// A 1 hp Brawler next to a healthy Sniper dies to the counterattack or to the Sniper's next turn
+	TestTrue(TEXT("Brawler 1 hp against Sniper 20 hp"),
+		Tablebase.Lookup(EPieceUnit::BRAWLER, EPieceUnit::SNIPER, 1, ASniper::DefaultHp, 1).Loss >= 0.99f);
+
+	// Winning and losing exclude each other in every position, up to the quantisation of the entries
+	int32 NumInvalid = 0;
+	for (EPieceUnit Mover : { EPieceUnit::SNIPER, EPieceUnit::BRAWLER })
+	{
+		for (EPieceUnit Other : { EPieceUnit::SNIPER, EPieceUnit::BRAWLER })
+		{
+			const int32 MaxHpMover = Rules.Units[FSaTEndgameTablebase::ToTypeIndex(Mover)].MaxHp;
+			const int32 MaxHpOther = Rules.Units[FSaTEndgameTablebase::ToTypeIndex(Other)].MaxHp;
+			for (int32 HpMover = 1; HpMover <= MaxHpMover; HpMover++)
+			{
+				for (int32 HpOther = 1; HpOther <= MaxHpOther; HpOther++)
+				{
+					for (int32 Distance = 1; Distance <= Rules.MaxDistance; Distance++)
+					{
+						const FSaTEndgameValue Value = Tablebase.Lookup(Mover, Other, HpMover, HpOther, Distance);
+						if (Value.Win < 0.0f || Value.Loss < 0.0f || Value.Win + Value.Loss > 1.0f + 2.0f / MAX_uint8)
+						{
+							NumInvalid++;
+						}
+					}
+				}
+			}
+		}
+	}
+	TestEqual(TEXT("Positions with invalid chances"), NumInvalid, 0);
+
+	// A file solved for other rules is never used
+	FSaTEndgameRules OtherRules = Rules;
+	OtherRules.MaxDistance++;
+	FSaTEndgameTablebase Stale;
+	AddExpectedError(TEXT("out of date or damaged"), EAutomationExpectedErrorFlags::Contains, 1);
+	TestFalse(TEXT("Table of other rules refused"), Stale.LoadFromFile(Path, OtherRules));
+
+	Tablebase.Reset();
+	IFileManager::Get().Delete(*Path);
+	return true;
+}
+
+#endif
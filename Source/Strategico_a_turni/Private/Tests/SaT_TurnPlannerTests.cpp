@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaT_TurnPlanner.h"
+#include "GridPathfinding.h"
+#include "Sniper.h"
+#include "Brawler.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	FSaTPlannerUnit MakeUnit(EPieceUnit Type, bool bIsPlayerUnit, int32 GridX, int32 GridY, float Hp)
+	{
+		const bool bSniper = Type == EPieceUnit::SNIPER;
+		FSaTPlannerUnit Unit;
+		Unit.Type = Type;
+		Unit.GridX = GridX;
+		Unit.GridY = GridY;
+		Unit.Hp = Hp;
+		Unit.Movement = bSniper ? ASniper::DefaultMovement : ABrawler::DefaultMovement;
+		Unit.Range = bSniper ? ASniper::DefaultRangeAttack : ABrawler::DefaultRangeAttack;
+		Unit.MinDamage = bSniper ? ASniper::DefaultMinDamage : ABrawler::DefaultMinDamage;
+		Unit.MaxDamage = bSniper ? ASniper::DefaultMaxDamage : ABrawler::DefaultMaxDamage;
+		Unit.bIsPlayerUnit = bIsPlayerUnit;
+		return Unit;
+	}
+
+	bool CanAttackInRange(int32 FromX, int32 FromY, int32 ToX, int32 ToY, int32 Range)
+	{
+		return FMath::Abs(ToX - FromX) + FMath::Abs(ToY - FromY) <= Range;
+	}
+
+	bool CanAttackNever(int32 FromX, int32 FromY, int32 ToX, int32 ToY, int32 Range)
+	{
+		return false;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSaTTurnPlannerTest, "Strategico_a_turni.AI.TurnPlanner",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSaTTurnPlannerTest::RunTest(const FString& Parameters)
+{
+	FGridSearchGrid Grid;
+	Grid.Init(25, 1);
+
+	// An AI Sniper with a Brawler its smallest roll kills in range, and a healthy Sniper out of reach
+	TArray<FSaTPlannerUnit> Units;
+	Units.Add(MakeUnit(EPieceUnit::SNIPER, false, 2, 2, ASniper::DefaultHp));
+	Units.Add(MakeUnit(EPieceUnit::BRAWLER, true, 2, 8, ASniper::DefaultMinDamage));
+	Units.Add(MakeUnit(EPieceUnit::SNIPER, true, 24, 24, ASniper::DefaultHp));
+
+	// One AI unit: the search ends long before the budget, so the plan does not depend on the machine
+	FSaTTurnPlannerSettings Settings;
+	Settings.BudgetMs = 1000.0f;
+
+	const FSaTTurnPlan Plan = FSaTTurnPlanner::Plan(Grid, Units, Settings, CanAttackInRange);
+	if (!TestEqual(TEXT("One action for the one AI unit"), Plan.Actions.Num(), 1))
+	{
+		return false;
+	}
+	TestFalse(TEXT("The search finished within the budget"), Plan.bBudgetExhausted);
+
+	const FSaTPlannedAction& Action = Plan.Actions[0];
+	TestEqual(TEXT("The Sniper attacks the Brawler it surely kills"), Action.TargetIndex, 1);
+	TestTrue(TEXT("The attack is made from within range"), CanAttackInRange(Action.ToX, Action.ToY, Units[1].GridX, Units[1].GridY, Units[0].Range));
+
+	TArray<FSaTPlannerUnit> After = Units;
+	FSaTTurnPlanner::ApplyAction(After, Action);
+	TestEqual(TEXT("The Brawler is dead after the attack"), After[1].AliveChance, 0.0f);
+	TestEqual(TEXT("A dead target does not strike back"), After[0].Hp, float(ASniper::DefaultHp));
+	TestTrue(TEXT("The kill scores above the board before it"),
+		FSaTTurnPlanner::Evaluate(After, Settings.Weights) > FSaTTurnPlanner::Evaluate(Units, Settings.Weights));
+
+	// With every line of sight blocked there is nothing to attack
+	const FSaTTurnPlan Blocked = FSaTTurnPlanner::Plan(Grid, Units, Settings, CanAttackNever);
+	for (const FSaTPlannedAction& BlockedAction : Blocked.Actions)
+	{
+		TestEqual(TEXT("No attack without line of sight"), BlockedAction.TargetIndex, int32(INDEX_NONE));
+	}
+
+	// An attack the target surely survives costs the attacker the expected counterattack: a Sniper strikes back when adjacent
+	TArray<FSaTPlannerUnit> Duel;
+	Duel.Add(MakeUnit(EPieceUnit::BRAWLER, false, 5, 5, ABrawler::DefaultHp));
+	Duel.Add(MakeUnit(EPieceUnit::SNIPER, true, 5, 6, ASniper::DefaultHp));
+	FSaTPlannedAction Hit;
+	Hit.UnitIndex = 0;
+	Hit.ToX = 5;
+	Hit.ToY = 5;
+	Hit.TargetIndex = 1;
+	Hit.TargetX = 5;
+	Hit.TargetY = 6;
+	FSaTTurnPlanner::ApplyAction(Duel, Hit);
+	TestEqual(TEXT("Expected damage of the hit"), Duel[1].Hp, ASniper::DefaultHp - (ABrawler::DefaultMinDamage + ABrawler::DefaultMaxDamage) / 2.0f, 1e-3f);
+	TestEqual(TEXT("Expected counterattack damage"), Duel[0].Hp, ABrawler::DefaultHp - (AUnit::MinCounterDamage + AUnit::MaxCounterDamage) / 2.0f, 1e-3f);
+	return true;
+}
+
+#endif
@@ -19,6 +19,11 @@ ATile::ATile()
 	SetRootComponent(Scene);
 	StaticMeshComponent->SetupAttachment(Scene);
 
+	// Cells are picked analytically by the grid, so tiles need no collision
+	StaticMeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	StaticMeshComponent->SetGenerateOverlapEvents(false);
+	StaticMeshComponent->SetCanEverAffectNavigation(false);
+
 	// Initialize tile state
 	Status = ETileStatus::EMPTY;
 	PlayerOwner = -1;
@@ -75,6 +80,18 @@ FVector2D ATile::GetGridPosition()
 	return FVector2D();
 }
 
+/*
+ * Returns the tile to its freshly spawned state so the grid can reuse it
+ * Clears obstacle, occupancy and owner; the material is restored by the grid
+ */
+void ATile::ResetTile()
+{
+	SetTileStatus(-1, ETileStatus::EMPTY);
+	bIsObstacle = false;
+	bIsOccupied = false;
+	OccupyingUnit = nullptr;
+}
+
 /*
  * Called when the game starts or when spawned
  * Initializes the tile
@@ -7,6 +7,8 @@
 #include "GridManager.h"
 #include "Sniper.h"
 #include "Brawler.h"
+#include "SaT_CombatOdds.h"
+#include "SaT_Stats.h"
 #include "Engine/World.h"
 
 /*
@@ -102,6 +104,7 @@ void AUnit::UpdateTeamColor()
         for (int32 i = 0; i < StaticMeshComponent->GetNumMaterials(); i++)
         {
             StaticMeshComponent->SetMaterial(i, TeamMaterial);
+            INC_DWORD_STAT(STAT_SaT_MaterialsSet);
         }
     }
     else
@@ -113,6 +116,7 @@ void AUnit::UpdateTeamColor()
     if (bIsSelected && SelectedMaterial)
     {
         StaticMeshComponent->SetMaterial(0, SelectedMaterial);
+        INC_DWORD_STAT(STAT_SaT_MaterialsSet);
     }
 }
 
@@ -140,6 +144,7 @@ void AUnit::ShowSelected()
     if (SelectedMaterial)
     {
         StaticMeshComponent->SetMaterial(0, SelectedMaterial);
+        INC_DWORD_STAT(STAT_SaT_MaterialsSet);
         bIsSelected = true;
     }
     else
@@ -163,6 +168,7 @@ void AUnit::UnshowSelected()
         for (int32 i = 0; i < StaticMeshComponent->GetNumMaterials(); i++)
         {
             StaticMeshComponent->SetMaterial(i, TeamMaterial);
+            INC_DWORD_STAT(STAT_SaT_MaterialsSet);
         }
     }
     else
@@ -311,37 +317,12 @@ bool AUnit::Attack(AUnit* Target)
         int32 Distance = FMath::Abs(Target->GridX - GridX) + FMath::Abs(Target->GridY - GridY);
 
         // Specific counterattack logic based on unit types
-        ASniper* AttackerAsSniper = Cast<ASniper>(this);
-        ASniper* TargetAsSniper = Cast<ASniper>(Target);
-        ABrawler* AttackerAsBrawler = Cast<ABrawler>(this);
-        ABrawler* TargetAsBrawler = Cast<ABrawler>(Target);
-
-        // Sniper counterattack rules
-        if (AttackerAsSniper)
-        {
-            // Sniper receives counterattack if:
-            // 1. Target is another Sniper
-            // 2. Target is a Brawler at distance 1
-            if (TargetAsSniper || (TargetAsBrawler && Distance <= 1))
-            {
-                bShouldCounterattack = true;
-            }
-        }
-        // Brawler counterattack rules
-        else if (AttackerAsBrawler)
-        {
-            // Brawlers do NOT counterattack other Brawlers
-            // This condition ensures no Brawler-to-Brawler counterattack
-            if (TargetAsBrawler == nullptr && Distance <= 1)
-            {
-                bShouldCounterattack = true;
-            }
-        }
+        bShouldCounterattack = CanCounterattack(this, Target, Distance);
 
         // Perform counterattack if conditions are met
         if (bShouldCounterattack)
         {
-            CounterDamage = FMath::RandRange(1, 3);
+            CounterDamage = FMath::RandRange(MinCounterDamage, MaxCounterDamage);
             DamageTaken(CounterDamage);
         }
     }
@@ -375,6 +356,7 @@ bool AUnit::Attack(AUnit* Target)
         // Count remaining units on both sides
         TArray<AActor*> AllUnits;
         UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+        INC_DWORD_STAT_BY(STAT_SaT_ActorsScanned, AllUnits.Num());
 
         int32 HumanUnitsAlive = 0;
         int32 AIUnitsAlive = 0;
@@ -426,7 +408,7 @@ int32 AUnit::CalculateDamage() const
 
 /*
  * Checks if a target unit is within attack range
- * Uses Manhattan distance on grid
+ * Uses Manhattan distance on grid, plus line of sight when the grid requires it
  * @param Target - Unit to check range to
  * @return True if target is in range, false otherwise
  */
@@ -438,11 +420,34 @@ bool AUnit::IsTargetInRange(const AUnit* Target) const
         return false;
     }
 
-    // Calculate Manhattan distance (grid-based)
-    int32 Distance = FMath::Abs(Target->GridX - GridX) + FMath::Abs(Target->GridY - GridY);
+    // Check the offset against the precomputed attack diamond (Manhattan distance)
+    if (!FGridBitboard::IsOffsetInRange(Target->GridX - GridX, Target->GridY - GridY, RangeAttack))
+    {
+        return false;
+    }
+
+    // Obstacles only block the shot under the line-of-sight rule
+    const ASaT_GameMode* GameMode = GetWorld() ? GetWorld()->GetAuthGameMode<ASaT_GameMode>() : nullptr;
+    const AGridManager* GridManager = GameMode ? GameMode->Gmanager : nullptr;
+    return !GridManager || GridManager->CanAttackCell(GridX, GridY, Target->GridX, Target->GridY, RangeAttack);
+}
+
+/*
+ * Applies the counterattack rules between two unit types
+ * @param Attacker - Unit performing the attack
+ * @param Target - Unit receiving the attack (assumed to survive it)
+ * @param Distance - Manhattan distance between the two units
+ * @return True if the target strikes back
+ */
+bool AUnit::CanCounterattack(const AUnit* Attacker, const AUnit* Target, int32 Distance)
+{
+    if (!Attacker || !Target)
+    {
+        return false;
+    }
 
-    // Check if the target is within range
-    return Distance <= RangeAttack;
+    // The rule lives with the combat odds tables, which need it at compile time
+    return FSaTCombatOdds::CanCounterattack(FSaTCombatOdds::GetPieceType(Attacker), FSaTCombatOdds::GetPieceType(Target), Distance);
 }
 
 /*
@@ -465,6 +470,7 @@ bool AUnit::CheckMutualDestruction(AUnit* Attacker, AUnit* Target)
     // Check if both units are the last ones alive for their respective teams
     TArray<AActor*> AllUnits;
     UGameplayStatics::GetAllActorsOfClass(Attacker->GetWorld(), AUnit::StaticClass(), AllUnits);
+    INC_DWORD_STAT_BY(STAT_SaT_ActorsScanned, AllUnits.Num());
 
     int32 PlayerUnitsAlive = 0;
     int32 AIUnitsAlive = 0;
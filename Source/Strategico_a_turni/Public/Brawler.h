@@ -22,6 +22,13 @@ public:
     // Constructor - initializes Brawler-specific stats
     ABrawler();
 
+    // Stats of every Brawler, also read at compile time by the combat odds tables
+    static constexpr int32 DefaultHp = 40;
+    static constexpr int32 DefaultMovement = 6;
+    static constexpr int32 DefaultRangeAttack = 1;
+    static constexpr int32 DefaultMinDamage = 1;
+    static constexpr int32 DefaultMaxDamage = 6;
+
 protected:
 
     /*
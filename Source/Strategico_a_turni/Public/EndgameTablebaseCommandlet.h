@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//EndgameTablebaseCommandlet
+//Generates the 1v1 endgame tablebase ahead of time, for the current unit stats:
+//  UnrealEditor-Cmd <Project>.uproject -run=EndgameTablebase -nullrhi [-size=25] [-out=Path]
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "EndgameTablebaseCommandlet.generated.h"
+
+UCLASS()
+class STRATEGICO_A_TURNI_API UEndgameTablebaseCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UEndgameTablebaseCommandlet();
+
+    /** Generates the table for the board size and writes it (to the game's default path unless -out is given); returns 0 on success */
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//EvalTunerCommandlet
+//Tunes the evaluation weights of the turn planner by self-play and writes them to the difficulty settings in DefaultGame.ini:
+//  UnrealEditor-Cmd <Project>.uproject -run=EvalTuner -nullrhi [-seed=N] [-iterations=N] [-pairs=N] [-size=N] [-budget=Ms] [-nolos] [-dryrun]
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "EvalTunerCommandlet.generated.h"
+
+UCLASS()
+class STRATEGICO_A_TURNI_API UEvalTunerCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UEvalTunerCommandlet();
+
+    /** Tunes from the configured weights and writes the result unless -dryrun is given or it lost to them; returns 0 on success */
+    virtual int32 Main(const FString& Params) override;
+};
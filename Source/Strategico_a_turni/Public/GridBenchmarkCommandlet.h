@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//GridBenchmarkCommandlet
+//Runs the pathfinding micro-benchmark headless:
+//  UnrealEditor-Cmd <Project>.uproject -run=GridBenchmark -nullrhi [-seed=N] [-queries=N] [-sizes=25,64] [-densities=0.1,0.2] [-terrain=0.3] [-csv=Path] [-maxp99=Micros]
+//With -maxp99 the run fails (returns 2) if any query kind's 99th percentile latency is over the threshold
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GridBenchmarkCommandlet.generated.h"
+
+UCLASS()
+class STRATEGICO_A_TURNI_API UGridBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UGridBenchmarkCommandlet();
+
+    /**
+     * Parses the options, runs the benchmark and logs (and optionally writes) the results
+     * @return 0 on success, 1 if the CSV could not be written, 2 if a query kind is over the -maxp99 threshold
+     */
+    virtual int32 Main(const FString& Params) override;
+};
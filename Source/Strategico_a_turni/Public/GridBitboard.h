@@ -0,0 +1,185 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//GridBitboard
+//Fixed-size bitboard covering the 25x25 game board (625 cells packed in ten 64-bit words).
+//Used for word-parallel range, occupancy and reachability queries on the grid.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct STRATEGICO_A_TURNI_API FGridBitboard
+{
+    // ----------------------------------------
+    // Layout constants
+    // ----------------------------------------
+
+    /** Number of columns per row; bit index of a cell is Y * Stride + X */
+    static constexpr int32 Stride = 25;
+
+    /** Number of cells covered by the bitboard */
+    static constexpr int32 NumCells = Stride * Stride;
+
+    /** Number of 64-bit words needed to store all cells */
+    static constexpr int32 NumWords = (NumCells + 63) / 64;
+
+    /** Largest attack range that has a precomputed diamond template */
+    static constexpr int32 MaxTemplateRange = Stride / 2;
+
+    // ----------------------------------------
+    // Construction and cell access
+    // ----------------------------------------
+
+    /** Creates an empty bitboard */
+    FGridBitboard()
+    {
+        Reset();
+    }
+
+    /** Clears every cell */
+    FORCEINLINE void Reset()
+    {
+        FMemory::Memzero(Words, sizeof(Words));
+    }
+
+    /** Returns true if the coordinates fall inside the bitboard */
+    static FORCEINLINE bool IsValidCell(int32 X, int32 Y)
+    {
+        return X >= 0 && X < Stride && Y >= 0 && Y < Stride;
+    }
+
+    /** Converts grid coordinates to a bit index */
+    static FORCEINLINE int32 ToIndex(int32 X, int32 Y)
+    {
+        return Y * Stride + X;
+    }
+
+    FORCEINLINE void SetIndex(int32 Index)
+    {
+        Words[Index >> 6] |= (uint64(1) << (Index & 63));
+    }
+
+    FORCEINLINE void ClearIndex(int32 Index)
+    {
+        Words[Index >> 6] &= ~(uint64(1) << (Index & 63));
+    }
+
+    FORCEINLINE bool TestIndex(int32 Index) const
+    {
+        return (Words[Index >> 6] >> (Index & 63)) & 1;
+    }
+
+    /** Marks a cell, ignoring coordinates outside the bitboard */
+    FORCEINLINE void Set(int32 X, int32 Y)
+    {
+        if (IsValidCell(X, Y))
+        {
+            SetIndex(ToIndex(X, Y));
+        }
+    }
+
+    /** Unmarks a cell, ignoring coordinates outside the bitboard */
+    FORCEINLINE void Clear(int32 X, int32 Y)
+    {
+        if (IsValidCell(X, Y))
+        {
+            ClearIndex(ToIndex(X, Y));
+        }
+    }
+
+    /** Returns true if the cell is marked (false for coordinates outside the bitboard) */
+    FORCEINLINE bool Test(int32 X, int32 Y) const
+    {
+        return IsValidCell(X, Y) && TestIndex(ToIndex(X, Y));
+    }
+
+    // ----------------------------------------
+    // Word-parallel operations
+    // ----------------------------------------
+
+    /** Returns true if no cell is marked */
+    bool IsEmpty() const;
+
+    /** Returns the number of marked cells */
+    int32 PopCount() const;
+
+    FGridBitboard& operator&=(const FGridBitboard& Other);
+    FGridBitboard& operator|=(const FGridBitboard& Other);
+
+    /** Removes every cell marked in Other */
+    FGridBitboard& AndNot(const FGridBitboard& Other);
+
+    friend FGridBitboard operator&(FGridBitboard A, const FGridBitboard& B) { A &= B; return A; }
+    friend FGridBitboard operator|(FGridBitboard A, const FGridBitboard& B) { A |= B; return A; }
+
+    bool operator==(const FGridBitboard& Other) const;
+    bool operator!=(const FGridBitboard& Other) const { return !(*this == Other); }
+
+    /** Returns the bitboard translated by (DeltaX, DeltaY); cells pushed off the board are dropped */
+    FGridBitboard Shifted(int32 DeltaX, int32 DeltaY) const;
+
+    /** Returns the bitboard grown by one step in the four orthogonal directions (cells themselves included) */
+    FGridBitboard Dilated() const;
+
+    // ----------------------------------------
+    // Reachability
+    // ----------------------------------------
+
+    /** Returns every Passable cell 4-connected to Seed through Passable cells (Seed cells are kept) */
+    static FGridBitboard FloodFill(const FGridBitboard& Seed, const FGridBitboard& Passable);
+
+    /**
+     * Returns every cell reachable from Seed in at most Steps orthogonal moves through Passable cells
+     * Each BFS layer is one Dilated() pass, so the cost is Steps word-parallel passes whatever the board holds
+     */
+    static FGridBitboard ReachableWithin(const FGridBitboard& Seed, int32 Steps, const FGridBitboard& Passable);
+
+    /** Returns every cell within Manhattan distance Range of a marked cell, ignoring obstacles */
+    FGridBitboard ExpandedBy(int32 Range) const;
+
+    /** Calls Func(X, Y) for every marked cell, in increasing bit index order */
+    template <typename FuncType>
+    void ForEachSetCell(FuncType&& Func) const
+    {
+        for (int32 WordIndex = 0; WordIndex < NumWords; WordIndex++)
+        {
+            uint64 Word = Words[WordIndex];
+            while (Word)
+            {
+                const int32 Index = (WordIndex << 6) + FMath::CountTrailingZeros64(Word);
+                Word &= Word - 1;
+                Func(Index % Stride, Index / Stride);
+            }
+        }
+    }
+
+    // ----------------------------------------
+    // Attack range masks
+    // ----------------------------------------
+
+    /**
+     * Returns the diamond (Manhattan distance <= Range) around the given origin
+     * Uses a precomputed template shifted to the origin; the origin cell itself is included
+     */
+    static FGridBitboard MakeRangeMask(int32 OriginX, int32 OriginY, int32 Range);
+
+    /** Returns true if the offset lies inside the diamond of the given range */
+    static bool IsOffsetInRange(int32 DeltaX, int32 DeltaY, int32 Range);
+
+    /** Returns the mask of all 625 board cells */
+    static const FGridBitboard& GetAllCellsMask();
+
+    /** Raw storage, row-major with Stride columns per row */
+    uint64 Words[NumWords];
+
+private:
+
+    /** Returns the precomputed diamond of the given range centred on (MaxTemplateRange, MaxTemplateRange) */
+    static const FGridBitboard& GetRangeTemplate(int32 Range);
+
+    /** Returns the mask of all cells whose column is lower than Column */
+    static const FGridBitboard& GetColumnsBelowMask(int32 Column);
+};
+
+/** Returns the complement of a bitboard restricted to the 625 board cells */
+STRATEGICO_A_TURNI_API FGridBitboard operator~(const FGridBitboard& Board);
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//GridDistanceTable
+//All-pairs path distances over the static layout of a board (obstacles and terrain, no units).
+//Built once per map with one sweep per source in parallel; units are left to the searches as a dynamic overlay,
+//so a table distance is a lower bound of the real one and an exact heuristic when nothing is in the way.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FGridSearchGrid;
+
+class STRATEGICO_A_TURNI_API FGridDistanceTable
+{
+public:
+
+    /** Largest board the table is built for; one byte per pair, so 1024 cells take 1 MB */
+    static constexpr int32 MaxCells = 1024;
+
+    /** Stored distance of pairs with no path between them */
+    static constexpr uint8 UnreachableEntry = MAX_uint8;
+
+    /** Distances are clamped to this, which keeps the table a lower bound */
+    static constexpr uint8 MaxEntry = MAX_uint8 - 1;
+
+    // ----------------------------------------
+    // Maintenance
+    // ----------------------------------------
+
+    /** Drops the table */
+    void Reset();
+
+    /**
+     * Sweeps every passable cell of the grid as a source, spread over the worker threads
+     * @return False if the grid has more than MaxCells cells (the table is left empty)
+     */
+    bool Build(const FGridSearchGrid& StaticGrid);
+
+    bool IsBuilt() const { return Size > 0; }
+
+    // ----------------------------------------
+    // Queries
+    // ----------------------------------------
+
+    /** Returns the raw entry between two cell indices: a distance clamped to MaxEntry, or UnreachableEntry */
+    FORCEINLINE uint8 GetEntry(int32 FromIndex, int32 ToIndex) const
+    {
+        return Table[FromIndex * NumCells + ToIndex];
+    }
+
+    /** Returns the entries of every source to the given cell; consecutive sources are GetNumCells() entries apart */
+    FORCEINLINE const uint8* GetColumn(int32 ToIndex) const
+    {
+        return Table.GetData() + ToIndex;
+    }
+
+    int32 GetNumCells() const { return NumCells; }
+
+    /** Returns the static path distance between two cells, MAX_int32 if there is none or the table is not built */
+    int32 GetDistance(int32 FromX, int32 FromY, int32 ToX, int32 ToY) const;
+
+    /** Returns the number of columns and rows of the grid the table was built on */
+    int32 GetSize() const { return Size; }
+
+    /** Returns the highest step cost of the grid the table was built on */
+    int32 GetMaxStepCost() const { return MaxStepCost; }
+
+    /** Returns the memory held by the table */
+    SIZE_T GetAllocatedSize() const { return Table.GetAllocatedSize(); }
+
+private:
+
+    int32 Size = 0;
+    int32 NumCells = 0;
+    int32 MaxStepCost = 0;
+
+    /** Row-major by source cell: Table[From * NumCells + To] */
+    TArray<uint8> Table;
+};
@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//GridHierarchicalPathfinder
+//HPA*-style pathfinder for large boards. The grid is cut into square clusters linked by entrance
+//nodes on their borders; queries search the small abstract graph and refine each hop inside one cluster.
+//Cell changes only rebuild the touched cluster and its four borders, lazily on the next query.
+//The game's 25x25 board is searched with A* and the distance table; this is only measured by the benchmark.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridPathfinding.h"
+
+class STRATEGICO_A_TURNI_API FGridHierarchicalPathfinder
+{
+public:
+
+    // ----------------------------------------
+    // Setup and invalidation
+    // ----------------------------------------
+
+    /**
+     * Builds the abstract graph over the grid
+     * The grid is referenced, not copied: it must outlive the pathfinder and cost changes
+     * must be reported through NotifyCellChanged
+     */
+    void Build(const FGridSearchGrid* InGrid, int32 InClusterSize);
+
+    /** Drops the abstract graph */
+    void Reset();
+
+    /** Marks the cluster holding the cell for a rebuild; its graph is refreshed on the next query */
+    void NotifyCellChanged(int32 X, int32 Y);
+
+    /** Returns true once Build has been called on a grid */
+    bool IsBuilt() const { return Grid != nullptr; }
+
+    // ----------------------------------------
+    // Queries
+    // ----------------------------------------
+
+    /**
+     * Finds a path between two cells; same contract as FGridPathfinding::FindPath
+     * Paths are near-optimal: they are shortest through the chosen entrance points
+     */
+    bool FindPath(int32 StartX, int32 StartY, int32 GoalX, int32 GoalY, TArray<FVector2D>& OutPath, FGridSearchStats* Stats = nullptr);
+
+    /** Returns the number of live entrance nodes in the abstract graph */
+    int32 GetNumAbstractNodes() const { return Nodes.Num() - FreeNodes.Num(); }
+
+    /** Returns the number of clusters waiting for a rebuild */
+    int32 GetNumDirtyClusters() const { return DirtyClusters.Num(); }
+
+    /** Returns the memory held by the graph and the search scratch */
+    SIZE_T GetAllocatedSize() const;
+
+private:
+
+    /** Segments at least this long get an entrance at both ends instead of one in the middle */
+    static constexpr int32 LongEntranceLength = 6;
+
+    struct FEdge
+    {
+        int32 To = INDEX_NONE;
+        int32 Cost = 0;
+
+        /** Intra-cluster edges are recomputed with the cluster, inter-cluster ones with the border */
+        bool bIntra = false;
+    };
+
+    struct FNode
+    {
+        int32 Cell = INDEX_NONE;
+        int32 Cluster = INDEX_NONE;
+        bool bActive = false;
+        TArray<FEdge> Edges;
+    };
+
+    // Cluster geometry
+    int32 GetClusterOfCell(int32 Cell) const;
+    void GetClusterBounds(int32 Cluster, int32& OutMinX, int32& OutMinY, int32& OutMaxX, int32& OutMaxY) const;
+
+    /** Borders are owned by the cluster on their west/north side: index Cluster * 2 (east) or Cluster * 2 + 1 (south) */
+    bool IsValidBorder(int32 Border) const;
+
+    // Graph maintenance
+    void RebuildDirtyClusters(FGridSearchStats* Stats);
+    void RemoveBorderNodes(int32 Border);
+
+    /** Rescans a border for entrances; returns true if they moved and both clusters must be reconnected */
+    bool BuildBorder(int32 Border);
+    void AddTransition(int32 Border, int32 CellA, int32 CellB);
+    void BuildIntraEdges(int32 Cluster, FGridSearchStats* Stats);
+    void GatherClusterNodes(int32 Cluster, TArray<int32>& OutNodes) const;
+    int32 AllocateNode(int32 Cell, int32 Cluster);
+
+    /**
+     * Cheapest-path search from StartCell restricted to one cluster
+     * Stops early when GoalCell (if any) is settled, or once NumTargets cells counted in LocalTargetCount are;
+     * results are read with GetLocalCost / AppendLocalPath
+     */
+    void RunLocalSearch(int32 StartCell, int32 Cluster, int32 GoalCell, FGridSearchStats* Stats, int32 NumTargets = 0);
+    int32 GetLocalCost(int32 Cell) const;
+    void AppendLocalPath(int32 GoalCell, TArray<FVector2D>& OutPath) const;
+
+    /** Grid the graph was built on */
+    const FGridSearchGrid* Grid = nullptr;
+
+    int32 ClusterSize = 0;
+    int32 ClustersPerSide = 0;
+
+    TArray<FNode> Nodes;
+    TArray<int32> FreeNodes;
+
+    /** Entrance nodes of each border, both sides */
+    TArray<TArray<int32>> BorderNodes;
+
+    /** Clusters waiting for a rebuild and a flag per cluster to avoid duplicates */
+    TArray<int32> DirtyClusters;
+    TArray<bool> bClusterDirty;
+
+    // Local search scratch, indexed by cell inside the current cluster
+    int32 LocalMinX = 0;
+    int32 LocalMinY = 0;
+    int32 LocalWidth = 0;
+    int32 LocalHeight = 0;
+    TArray<int32> LocalCost;
+    TArray<int32> LocalParent;
+    TArray<FGridOpenEntry> LocalOpen;
+
+    /** Entrances per cell of the cluster being connected, used to end its sweeps early */
+    TArray<int32> LocalTargetCount;
+
+    // Abstract search scratch, indexed by node id (two extra slots for the query's start and goal)
+    TArray<int32> AbstractCost;
+    TArray<int32> AbstractParent;
+    TArray<int32> GoalLinkCost;
+    TArray<FEdge> StartLinks;
+    TArray<FGridOpenEntry> AbstractOpen;
+};
@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//GridInfluenceMap
+//Per-cell threat fields for both teams: the expected damage each team can deal to a cell next turn
+//(move within Movement, then attack within RangeAttack). Updated incrementally from AGridManager::OccupyCell.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBitboard.h"
+
+class AUnit;
+
+class STRATEGICO_A_TURNI_API FGridInfluenceMap
+{
+public:
+
+    // ----------------------------------------
+    // Maintenance
+    // ----------------------------------------
+
+    /** Drops every unit stamp and zeroes both fields */
+    void Reset();
+
+    /** Adds or re-computes the stamp of a unit from its current cell */
+    void StampUnit(const AUnit* Unit, const FGridBitboard& Passable);
+
+    /** Removes the stamp of a unit (death or leaving the board) */
+    void RemoveUnit(const AUnit* Unit);
+
+    /**
+     * Re-stamps the units whose movement could be affected by a change of the given cell
+     * Only units whose reachable area touches the cell are recomputed
+     */
+    void RefreshAround(int32 GridX, int32 GridY, const FGridBitboard& Passable);
+
+    /** Re-stamps every unit; cheaper than RefreshAround once a batch of cells changed at the same time */
+    void RefreshAll(const FGridBitboard& Passable);
+
+    // ----------------------------------------
+    // Queries
+    // ----------------------------------------
+
+    /** Returns the expected damage the given team can deal to the cell next turn, summed over its units */
+    float GetThreat(int32 GridX, int32 GridY, bool bFromPlayerUnits) const;
+
+    /** Returns the expected damage a unit of the given team standing on the cell can receive next turn */
+    float GetDamageReceivable(int32 GridX, int32 GridY, bool bIsPlayerUnit) const
+    {
+        return GetThreat(GridX, GridY, !bIsPlayerUnit);
+    }
+
+    /** Returns the expected damage the given team can deal to an enemy standing on the cell next turn */
+    float GetDamageDealable(int32 GridX, int32 GridY, bool bIsPlayerUnit) const
+    {
+        return GetThreat(GridX, GridY, bIsPlayerUnit);
+    }
+
+    /** Returns every cell at least one unit of the given team can hit next turn */
+    FGridBitboard GetThreatZone(bool bFromPlayerUnits) const;
+
+    /** Returns the number of units currently stamped */
+    int32 GetNumStamps() const { return Stamps.Num(); }
+
+    /** Returns the heap memory held by the unit stamps; the fields themselves are inline */
+    SIZE_T GetAllocatedSize() const { return Stamps.GetAllocatedSize(); }
+
+private:
+
+    /** Cached contribution of one unit, enough to remove it without touching the actor */
+    struct FUnitStamp
+    {
+        int32 GridX = 0;
+        int32 GridY = 0;
+        int32 Movement = 0;
+        int32 Range = 0;
+
+        /** Min + Max damage, i.e. twice the expected damage, so the fields stay integral */
+        int32 DamageSum = 0;
+
+        bool bIsPlayerUnit = false;
+
+        /** Cells the unit can stand on next turn */
+        FGridBitboard Reach;
+
+        /** Cells the unit can attack next turn */
+        FGridBitboard Zone;
+    };
+
+    /** Recomputes Reach and Zone of a stamp from its cell and the passable board */
+    static void BuildStamp(FUnitStamp& Stamp, const FGridBitboard& Passable);
+
+    /** Adds (Sign = 1) or removes (Sign = -1) a stamp from its team field */
+    void ApplyStamp(const FUnitStamp& Stamp, int32 Sign);
+
+    /** Unit stamps, keyed by identity only (never dereferenced) */
+    TMap<const AUnit*, FUnitStamp> Stamps;
+
+    /** Doubled expected damage per bitboard cell index, one field per team */
+    int32 PlayerField[FGridBitboard::NumCells] = {};
+    int32 AIField[FGridBitboard::NumCells] = {};
+};
@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//GridLineOfSight
+//Line of sight between cells for ranged attacks: a supercover ray from centre to centre is blocked by obstacles
+//it crosses. Visibility within MaxRange is precomputed per cell as a bitboard and patched when an obstacle changes.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBitboard.h"
+
+class STRATEGICO_A_TURNI_API FGridLineOfSight
+{
+public:
+
+    /** Largest Manhattan distance covered by the precomputed tables; longer rays are traced on demand */
+    static constexpr int32 MaxRange = 10;
+
+    // ----------------------------------------
+    // Maintenance
+    // ----------------------------------------
+
+    /** Drops the visibility tables */
+    void Reset();
+
+    /** Computes the visible cells of every board cell from scratch */
+    void Build(const FGridBitboard& Obstacles, const FGridBitboard& BoardCells);
+
+    /**
+     * Updates the visibility after the given cell gained or lost an obstacle
+     * Only the viewer/target pairs whose ray crosses the cell are traced again
+     */
+    void NotifyObstacleChanged(int32 GridX, int32 GridY, const FGridBitboard& Obstacles);
+
+    bool IsBuilt() const { return Visible.Num() > 0; }
+
+    // ----------------------------------------
+    // Queries
+    // ----------------------------------------
+
+    /** Returns the cells within MaxRange visible from the cell, the cell itself included */
+    const FGridBitboard& GetVisibleCells(int32 GridX, int32 GridY) const;
+
+    /** Returns true if no obstacle blocks the ray between the two cells; O(1) within MaxRange */
+    bool IsVisible(int32 FromX, int32 FromY, int32 ToX, int32 ToY) const;
+
+    /**
+     * Walks the supercover ray between two cells; the end cells themselves never block
+     * Where the ray passes exactly through a corner it touches both side cells and is only blocked if both are
+     */
+    static bool TraceRay(int32 FromX, int32 FromY, int32 ToX, int32 ToY, const FGridBitboard& Obstacles);
+
+    /** Returns the memory held by the visibility tables */
+    SIZE_T GetAllocatedSize() const { return Visible.GetAllocatedSize(); }
+
+private:
+
+    /** Cell crossed by a ray, relative to the viewer; A == B unless the ray passes through a corner */
+    struct FRayStep
+    {
+        FIntPoint A;
+        FIntPoint B;
+    };
+
+    /** Precomputed rays of every offset within MaxRange, plus which rays cross each offset */
+    struct FRayTable
+    {
+        /** Side of the offset square, offsets are stored at (DeltaY + MaxRange) * Side + DeltaX + MaxRange */
+        static constexpr int32 Side = 2 * MaxRange + 1;
+
+        /** Ray of each offset, as a range of Steps */
+        TArray<int32> FirstStep;
+        TArray<int32> NumSteps;
+        TArray<FRayStep> Steps;
+
+        /** Target offsets whose ray crosses each offset */
+        TArray<TArray<FIntPoint>> Crossing;
+
+        static int32 ToSlot(int32 DeltaX, int32 DeltaY)
+        {
+            return (DeltaY + MaxRange) * Side + DeltaX + MaxRange;
+        }
+    };
+
+    /** Builds the ray table once */
+    static const FRayTable& GetRayTable();
+
+    /** Appends the crossed cells of the ray from (0, 0) to the offset */
+    static void BuildRay(int32 DeltaX, int32 DeltaY, TArray<FRayStep>& OutSteps);
+
+    /** Returns true if the precomputed ray from the viewer to the offset is clear */
+    static bool IsRayClear(const FRayTable& Table, int32 FromX, int32 FromY, int32 DeltaX, int32 DeltaY, const FGridBitboard& Obstacles);
+
+    /** Visible cells of each bitboard cell index */
+    TArray<FGridBitboard> Visible;
+
+    /** Board cells the tables were built for */
+    FGridBitboard Cells;
+
+    /** Obstacles as of the last update, for rays longer than MaxRange */
+    FGridBitboard ObstacleCells;
+};
@@ -8,11 +8,40 @@
 
 #include "CoreMinimal.h"
 #include "Tile.h"
+#include "GridBitboard.h"
+#include "GridInfluenceMap.h"
+#include "GridLineOfSight.h"
+#include "GridPathfinding.h"
+#include "GridDistanceTable.h"
 #include "GameFramework/Actor.h"
 #include "GridManager.generated.h"
 
 class AUnit;
 
+/** Snapshot of the tile actors owned by the grid, for leak and memory checks */
+struct FGridTileReport
+{
+    /** Tiles currently making up the field */
+    int32 ActiveTiles = 0;
+
+    /** ATile actors alive in the world, tracked or not */
+    int32 LiveTileActors = 0;
+
+    /** Live tiles the grid does not track (leaked by an earlier regeneration) */
+    int32 OrphanedTiles = 0;
+
+    /** Lifetime counters of the lifecycle manager */
+    int32 TotalSpawned = 0;
+    int32 TotalReused = 0;
+    int32 TotalDestroyed = 0;
+
+    /** Approximate memory of the tile actors and their components */
+    SIZE_T TileActorBytes = 0;
+
+    /** Memory held by the grid's tile containers */
+    SIZE_T ContainerBytes = 0;
+};
+
 UCLASS()
 class STRATEGICO_A_TURNI_API AGridManager : public AActor
 {
@@ -40,9 +69,26 @@ public:
     // Grid generation and setup
     // ----------------------------------------
 
-    /** Generates an empty game field with the specified size */
+    /** Generates an empty game field with the specified size, reusing the tiles of the previous field */
     void GenerateField();
 
+    // ----------------------------------------
+    // Tile lifecycle
+    // ----------------------------------------
+
+    /** Counts tracked and live tile actors and estimates their memory */
+    FGridTileReport GetTileReport() const;
+
+    /** Writes GetTileReport to the log */
+    UFUNCTION(BlueprintCallable, Category = "Grid")
+    void LogTileReport() const;
+
+    /** Returns the heap memory of the bitboard layers, the influence map, the terrain and the visibility tables (tile containers are in GetTileReport) */
+    SIZE_T GetGridStateAllocatedSize() const;
+
+    /** Returns the memory held by the navigation grid, the A* buffers, the movement sweep and the distance table */
+    SIZE_T GetPathfindingAllocatedSize() const;
+
     /** Generates obstacles randomly throughout the grid based on ObstaclePercentage */
     UFUNCTION(BlueprintCallable, Category = "Grid")
     void GenerateObstacles();
@@ -79,9 +125,127 @@ public:
     /** Returns the grid coordinates for the given world location */
     FVector2D GetXYPositionByRelativeLocation(const FVector& Location) const;
 
+    /**
+     * Finds the cell under a world-space ray (e.g. the mouse cursor) by intersecting it with the board plane
+     * Constant time and independent of tile collision
+     * @return False if the ray misses the board
+     */
+    bool GetCellUnderRay(const FVector& RayOrigin, const FVector& RayDirection, int32& OutGridX, int32& OutGridY) const;
+
     /** Checks if the given position is within the grid boundaries */
     inline bool IsValidPosition(const FVector2D Position) const;
 
+    /** Returns the unit standing on the given cell, or nullptr if there is none */
+    AUnit* GetUnitAt(int32 GridX, int32 GridY) const;
+
+    // ----------------------------------------
+    // Bitboard range queries
+    // ----------------------------------------
+
+    /** Returns the cells within Manhattan distance Range of the given cell, clipped to the grid */
+    FGridBitboard GetCellsInRange(int32 GridX, int32 GridY, int32 Range) const;
+
+    /** Returns the cells occupied by player units (true) or AI units (false) */
+    const FGridBitboard& GetUnitBoard(bool bPlayerUnits) const;
+
+    /** Returns the cells of the given team's units that can attack the given cell from where they stand */
+    FGridBitboard GetThreatsToCell(int32 GridX, int32 GridY, bool bPlayerUnits) const;
+
+    /** Returns the cells holding an obstacle */
+    const FGridBitboard& GetObstacleBoard() const { return ObstacleBoard; }
+
+    /** Returns the cells blocked by an obstacle or a unit of either team */
+    FGridBitboard GetOccupancyBoard() const;
+
+    /** Returns the cells a unit can step onto (inside the grid, no obstacle, no unit) */
+    FGridBitboard GetPassableBoard() const;
+
+    /** Returns the cells currently highlighted with HighlightCell */
+    const FGridBitboard& GetHighlightBoard() const { return HighlightBoard; }
+
+    /** Returns true if the cell is currently highlighted with HighlightCell */
+    bool IsCellHighlighted(int32 GridX, int32 GridY) const { return HighlightBoard.Test(GridX, GridY); }
+
+    /**
+     * Returns the free cells reachable from the given cell with a movement budget of Steps (start cell excluded)
+     * Plain boards grow BFS bitboard layers; weighted terrain runs a bucket-queue sweep instead
+     */
+    FGridBitboard GetReachableCells(int32 GridX, int32 GridY, int32 Steps) const;
+
+    /** Returns every cell the given team can attack without moving */
+    FGridBitboard GetThreatMap(bool bPlayerUnits) const;
+
+    // ----------------------------------------
+    // Line of sight
+    // ----------------------------------------
+
+    /** Returns true if no obstacle blocks the ray between two cells, whether or not the rule is on */
+    bool HasLineOfSight(int32 FromX, int32 FromY, int32 ToX, int32 ToY) const;
+
+    /** Returns the visibility tables, e.g. to copy them for a search on another thread */
+    const FGridLineOfSight& GetLineOfSight() const { return LineOfSight; }
+
+    /** Returns true if a unit with the given range on the first cell can attack the second (range, plus line of sight if required) */
+    bool CanAttackCell(int32 FromX, int32 FromY, int32 ToX, int32 ToY, int32 Range) const;
+
+    /** Returns the cells a unit with the given range can attack from the cell; GetCellsInRange minus hidden cells if required */
+    FGridBitboard GetAttackableCells(int32 GridX, int32 GridY, int32 Range) const;
+
+    /** Turns a cell into an obstacle or clears it, keeping tile flags, material and bitboards in sync */
+    void SetCellObstacle(int32 GridX, int32 GridY, bool bObstacle);
+
+    /**
+     * Finds a cheapest path costing at most MaxSteps over free cells, built from BFS bitboard layers
+     * (or a bucket-queue sweep on weighted terrain)
+     * OutPath starts with the start cell and ends with the end cell; returns false if the end is out of reach
+     */
+    bool FindPathWithin(int32 StartX, int32 StartY, int32 EndX, int32 EndY, int32 MaxSteps, TArray<FVector2D>& OutPath) const;
+
+    /** Fills a search grid snapshot of the board with terrain costs; obstacles always block, units only if bUnitsBlock */
+    void BuildSearchGrid(FGridSearchGrid& OutGrid, bool bUnitsBlock) const;
+
+    /**
+     * Finds a shortest path for a unit standing on the start cell; obstacles and units block
+     * Uses A* with the static distance table as its heuristic
+     * OutPath starts with the start cell and ends with the end cell; returns false if the end cannot be reached
+     */
+    bool FindPath(int32 StartX, int32 StartY, int32 EndX, int32 EndY, TArray<FVector2D>& OutPath, FGridSearchStats* Stats = nullptr);
+
+    /** Returns the static all-pairs distances of the board (obstacles and terrain, units ignored), swept again first if the layout changed */
+    const FGridDistanceTable& GetDistanceTable();
+
+    /** Returns the threat fields of both teams, updated incrementally as units move or die */
+    const FGridInfluenceMap& GetInfluenceMap() const { return InfluenceMap; }
+
+    // ----------------------------------------
+    // Terrain
+    // ----------------------------------------
+
+    /** Movement cost of stepping onto a cell of the given terrain: plain and road 1, forest 2, hill 3 */
+    static uint8 GetTerrainCost(ETerrainType Terrain);
+
+    /** Returns the terrain of a cell, PLAIN outside the grid */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Terrain")
+    ETerrainType GetCellTerrain(int32 GridX, int32 GridY) const;
+
+    /** Changes the terrain of a cell, keeping its material and the navigation grid in sync */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Terrain")
+    void SetCellTerrain(int32 GridX, int32 GridY, ETerrainType Terrain);
+
+    /** Returns the movement cost of stepping onto a cell, ignoring obstacles and units */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Terrain")
+    int32 GetMovementCost(int32 GridX, int32 GridY) const;
+
+    /** Returns true if some cell costs more than 1 to enter, so step counts and movement costs differ */
+    bool HasWeightedTerrain() const { return NumWeightedCells > 0; }
+
+    /** Paints random terrain on the free cells based on TerrainPercentage */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Terrain")
+    void GenerateTerrain();
+
+    /** Returns the material of a cell without highlight or obstacle: its terrain material, or DefaultTileMaterial */
+    UMaterialInterface* GetBaseTileMaterial(int32 GridX, int32 GridY) const;
+
     // ----------------------------------------
     // Visualization and highlighting methods
     // ----------------------------------------
@@ -174,8 +338,8 @@ public:
     // Public properties
     // ----------------------------------------
 
-    /** Size of the grid (will be Size x Size) */
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid")
+    /** Size of the grid (will be Size x Size); fixed to the bitboard width, as the range masks, unit boards and line of sight tables cover no more */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid")
     int32 Size;
 
     /** Multiplier for tile positioning */
@@ -194,6 +358,14 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid", meta = (ClampMin = "0.0", ClampMax = "1.0"))
     float ObstaclePercentage;
 
+    /** Ranged attacks need a line of sight free of obstacles; off by default, so attacks go through obstacles */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
+    bool bRequireLineOfSight;
+
+    /** Percentage of the free cells to cover with road, forest or hill (0.0 keeps every cell plain) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float TerrainPercentage;
+
     // ----------------------------------------
     // Materials
     // ----------------------------------------
@@ -214,6 +386,10 @@ public:
     UPROPERTY(EditDefaultsOnly, Category = "Materials")
     UMaterialInterface* ObstacleMaterial;
 
+    /** Material of each terrain type; terrains without one use DefaultTileMaterial */
+    UPROPERTY(EditDefaultsOnly, Category = "Materials")
+    TMap<ETerrainType, UMaterialInterface*> TerrainMaterials;
+
     // ----------------------------------------
     // Grid connectivity methods
     // ----------------------------------------
@@ -221,8 +397,8 @@ public:
     /** Identifies separate regions in the grid */
     int32 IdentifyRegions(const TArray<bool>& ObstacleMap, TArray<int32>& RegionMap);
 
-    /** Flood fills a region starting from the given coordinates */
-    void FloodFillRegion(
+    /** Flood fills a region starting from the given coordinates and returns the number of cells filled */
+    int32 FloodFillRegion(
         const TArray<bool>& ObstacleMap,
         TArray<int32>& RegionMap,
         TArray<bool>& Visited,
@@ -271,4 +447,88 @@ public:
     UPROPERTY()
     TArray<ATile*> PathTiles;
 
+private:
+
+    /** Occupancy of one team, overall and split by the attack range of the unit on each cell */
+    struct FTeamUnitBoards
+    {
+        FGridBitboard All;
+        TMap<int32, FGridBitboard> ByRange;
+
+        void Reset()
+        {
+            All.Reset();
+            ByRange.Empty();
+        }
+    };
+
+    /** Unit occupancy bitboards, kept in sync by OccupyCell */
+    FTeamUnitBoards PlayerUnitBoards;
+    FTeamUnitBoards AIUnitBoards;
+
+    /** Every cell that has a tile, used to clip range masks on grids smaller than the bitboard */
+    FGridBitboard GridCellsBoard;
+
+    /** Obstacle layer, kept in sync by SetCellObstacle */
+    FGridBitboard ObstacleBoard;
+
+    /** Highlight layer, kept in sync by HighlightCell and ClearAllHighlights */
+    FGridBitboard HighlightBoard;
+
+    /** Terrain of every cell, index Y * Size + X */
+    TArray<ETerrainType> TerrainMap;
+
+    /** Cells whose terrain costs more than 1 */
+    int32 NumWeightedCells = 0;
+
+    /** Next-turn threat fields of both teams */
+    FGridInfluenceMap InfluenceMap;
+
+    /** Visibility tables, built with the field and patched by SetCellObstacle */
+    FGridLineOfSight LineOfSight;
+
+    /** Removes a cell from both teams' unit bitboards */
+    void ClearUnitBoardCell(int32 GridX, int32 GridY);
+
+    /** Navigation snapshot used by FindPath (units block), built lazily and then patched per cell */
+    FGridSearchGrid NavigationGrid;
+    bool bNavigationGridDirty = true;
+
+    /** A* buffers reused between FindPath calls */
+    FGridDistanceField PathScratch;
+
+    /** All-pairs distances over the static layout; obstacle and terrain changes only mark it dirty, GetDistanceTable rebuilds it */
+    FGridDistanceTable DistanceTable;
+    bool bDistanceTableDirty = false;
+
+    /** Sweeps the static layout into DistanceTable on the worker threads */
+    void RebuildDistanceTable();
+
+    /** Set while a batch of obstacle changes is applied, so SetCellObstacle leaves the influence map and sight tables alone */
+    bool bDeferObstacleRefresh = false;
+
+    /** Brings the influence map and sight tables up to date after a batch of obstacle changes */
+    void RefreshObstacleTables();
+
+    /** Snapshot and field of the movement sweeps on weighted terrain, reused between the const range queries */
+    mutable FGridSearchGrid MovementGrid;
+    mutable FGridDistanceField MovementField;
+
+    /** Fills MovementField with the movement cost from the given cell, up to MaxCost */
+    void ComputeMovementField(int32 GridX, int32 GridY, int32 MaxCost) const;
+
+    /** Copies one tile's state into the navigation grid and invalidates its cluster */
+    void UpdateNavigationCell(int32 GridX, int32 GridY);
+
+    /** Takes a tile from the reusable ones (reset and moved into place) or spawns a new one */
+    ATile* AcquireTile(TArray<ATile*>& ReusableTiles, const FVector& Location);
+
+    /** Destroys a tile for good */
+    void DestroyTile(ATile* Tile);
+
+    /** Lifetime counters reported by GetTileReport */
+    int32 TilesSpawned = 0;
+    int32 TilesReused = 0;
+    int32 TilesDestroyed = 0;
+
 };
\ No newline at end of file
@@ -0,0 +1,211 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//GridPathfinding
+//Grid search primitives shared by the AI and the human player: a flat cost grid snapshot,
+//a reusable distance field and single-sweep searches over it (BFS on unit costs,
+//Dial's bucket queue once terrain makes some steps cost more).
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FGridDistanceTable;
+
+/** Flat snapshot of the board used by the searches; index of a cell is Y * Size + X */
+struct STRATEGICO_A_TURNI_API FGridSearchGrid
+{
+    /** Number of columns and rows */
+    int32 Size = 0;
+
+    /** Cost of stepping onto each cell; 0 means the cell cannot be entered */
+    TArray<uint8> StepCost;
+
+    /** Resizes the grid and fills every cell with the given cost */
+    void Init(int32 InSize, uint8 DefaultCost = 1)
+    {
+        Size = InSize;
+        StepCost.Init(DefaultCost, InSize * InSize);
+    }
+
+    FORCEINLINE bool IsValidCell(int32 X, int32 Y) const
+    {
+        return X >= 0 && X < Size && Y >= 0 && Y < Size;
+    }
+
+    FORCEINLINE int32 ToIndex(int32 X, int32 Y) const
+    {
+        return Y * Size + X;
+    }
+
+    FORCEINLINE bool IsPassable(int32 Index) const
+    {
+        return StepCost[Index] != 0;
+    }
+
+    /** Returns the highest step cost on the grid; 1 means every passable cell costs the same */
+    uint8 GetMaxStepCost() const
+    {
+        uint8 MaxCost = 0;
+        for (const uint8 Cost : StepCost)
+        {
+            MaxCost = FMath::Max(MaxCost, Cost);
+        }
+        return MaxCost;
+    }
+};
+
+/** Counters filled in by the searches when requested */
+struct STRATEGICO_A_TURNI_API FGridSearchStats
+{
+    /** Cells taken off the frontier and expanded */
+    int32 NodesExpanded = 0;
+
+    /** Times a scratch buffer had to grow (0 once buffers are warm) */
+    int32 ScratchAllocations = 0;
+
+    void Reset()
+    {
+        NodesExpanded = 0;
+        ScratchAllocations = 0;
+    }
+};
+
+/** Entry of the open list used by the best-first searches */
+struct FGridOpenEntry
+{
+    /** Estimated total cost (cost so far plus heuristic) */
+    int32 Priority = 0;
+
+    /** Cost so far, used to prefer deeper entries on equal priority */
+    int32 Cost = 0;
+
+    /** Cell (or abstract node) index */
+    int32 Index = INDEX_NONE;
+
+    /** Heap order: lowest priority first, then highest cost */
+    friend bool operator<(const FGridOpenEntry& A, const FGridOpenEntry& B)
+    {
+        return A.Priority < B.Priority || (A.Priority == B.Priority && A.Cost > B.Cost);
+    }
+};
+
+/**
+ * Dial's bucket queue: a ring of buckets indexed by priority, for small integer priorities
+ * Push and pop are O(1) as long as no pushed priority is more than MaxIncrease above the last popped one
+ */
+struct STRATEGICO_A_TURNI_API FGridBucketQueue
+{
+    /**
+     * Empties the queue and sizes the ring for the given maximum priority increase, keeping the buckets' memory
+     * @param FirstPriority - Lowest priority that will be pushed first
+     */
+    void Reset(int32 MaxIncrease, int32 FirstPriority = 0);
+
+    FORCEINLINE void Push(int32 Priority, int32 Index)
+    {
+        checkSlow(Priority >= CurrentPriority && Priority - CurrentPriority < NumBuckets);
+        Buckets[Priority % NumBuckets].Add(Index);
+        Count++;
+    }
+
+    /** Takes out an entry of the lowest priority; entries of the same priority come out last in, first out */
+    bool Pop(int32& OutPriority, int32& OutIndex);
+
+    bool IsEmpty() const { return Count == 0; }
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+
+    TArray<TArray<int32>> Buckets;
+    int32 NumBuckets = 0;
+    int32 CurrentPriority = 0;
+    int32 Count = 0;
+};
+
+/** Result of a distance sweep: path distance and parent of every cell; reused between sweeps */
+struct STRATEGICO_A_TURNI_API FGridDistanceField
+{
+    /** Distance stored for cells the sweep never reached */
+    static constexpr int32 Unreachable = MAX_int32;
+
+    /** Number of columns and rows of the grid the field was computed on */
+    int32 Size = 0;
+
+    /** Path distance from the nearest source, Unreachable if none */
+    TArray<int32> Distance;
+
+    /** Index of the previous cell on a shortest path, INDEX_NONE for sources and unreached cells */
+    TArray<int32> Parent;
+
+    /** Returns the distance of a cell, Unreachable outside the grid */
+    int32 GetDistance(int32 X, int32 Y) const
+    {
+        return (X >= 0 && X < Size && Y >= 0 && Y < Size) ? Distance[Y * Size + X] : Unreachable;
+    }
+
+    bool IsReachable(int32 X, int32 Y) const
+    {
+        return GetDistance(X, Y) != Unreachable;
+    }
+
+    /**
+     * Returns the shortest distance from the sources to any cell orthogonally adjacent to (X, Y)
+     * Used to measure how far a blocked cell (e.g. an enemy unit) really is
+     */
+    int32 GetDistanceToNeighbourOf(int32 X, int32 Y) const;
+
+    /** Builds the path from the source to the cell, source first; returns false if the cell was not reached */
+    bool GetPathTo(int32 X, int32 Y, TArray<FVector2D>& OutPath) const;
+
+    /** Returns the memory held by the field and its scratch buffers */
+    SIZE_T GetAllocatedSize() const
+    {
+        return Distance.GetAllocatedSize() + Parent.GetAllocatedSize() + Frontier.GetAllocatedSize() + Buckets.GetAllocatedSize();
+    }
+
+    /** Work queue of the unit-cost sweep, kept here so repeated sweeps do not allocate */
+    TArray<int32> Frontier;
+
+    /** Bucket queue of the weighted sweep and of A*, kept for the same reason */
+    FGridBucketQueue Buckets;
+};
+
+/** Stateless grid searches */
+class STRATEGICO_A_TURNI_API FGridPathfinding
+{
+public:
+
+    /**
+     * Computes path costs from every source to every cell in one sweep: breadth-first when every step
+     * costs 1, Dijkstra over a bucket queue when terrain makes some steps cost more
+     * Sources are entered even if their own cell is impassable (a unit stands on it)
+     * @param MaxDistance - Cells farther than this are left Unreachable (MAX_int32 for no limit)
+     */
+    static void ComputeDistanceField(const FGridSearchGrid& Grid, TArrayView<const FIntPoint> Sources,
+        FGridDistanceField& OutField, int32 MaxDistance = MAX_int32, FGridSearchStats* Stats = nullptr);
+
+    /** Convenience overload for a single source */
+    static void ComputeDistanceField(const FGridSearchGrid& Grid, int32 SourceX, int32 SourceY,
+        FGridDistanceField& OutField, int32 MaxDistance = MAX_int32, FGridSearchStats* Stats = nullptr);
+
+    /**
+     * Finds a cheapest path with A* (each step costs the StepCost of the entered cell)
+     * The heuristic is Manhattan distance, or the static distance from HeuristicTable when one is given; the table
+     * must be built on the same layout without units, so it never overestimates and prunes cells cut off from the goal
+     * The open list is a bucket queue, since priorities are small integers that grow by at most two step costs
+     * The start cell may be impassable (the moving unit stands on it), the goal may not
+     * @param OutPath - Receives the path, start first and goal last
+     * @param Scratch - Buffers reused between searches; its contents are overwritten
+     * @return True if the goal can be reached
+     */
+    static bool FindPath(const FGridSearchGrid& Grid, int32 StartX, int32 StartY, int32 GoalX, int32 GoalY,
+        TArray<FVector2D>& OutPath, FGridDistanceField& Scratch, FGridSearchStats* Stats = nullptr,
+        const FGridDistanceTable* HeuristicTable = nullptr);
+
+private:
+
+    /** Dijkstra sweep over a bucket queue, for grids with step costs above 1; OutField is already cleared */
+    static void ComputeWeightedDistanceField(const FGridSearchGrid& Grid, TArrayView<const FIntPoint> Sources,
+        FGridDistanceField& OutField, uint8 MaxStepCost, int32 MaxDistance, FGridSearchStats* Stats);
+};
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//GridPathfindingBenchmark
+//Micro-benchmark of the searches behind the pathfinding entry points, run on seeded boards
+//of several sizes and obstacle densities. On the game's 25x25 board each case makes the same calls,
+//with the same terrain costs and distance table, as the entry point it is named after; the other
+//sizes time the bare searches. Used by the GridBenchmark commandlet and console command.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Boards and query counts to run */
+struct STRATEGICO_A_TURNI_API FGridBenchmarkSettings
+{
+    /** Seed of the board and query generator; same seed, same boards and queries */
+    int32 Seed = 1337;
+
+    /** Board sides; the bitboard queries only run on boards that fit a bitboard */
+    TArray<int32> Sizes = { 25, 64, 128, 256 };
+
+    /** Fraction of cells turned into obstacles */
+    TArray<float> Densities = { 0.1f, 0.2f, 0.35f };
+
+    /** Share of the free cells painted road, forest or hill, as AGridManager::GenerateTerrain does; 0 keeps every cell plain */
+    float TerrainShare = 0.3f;
+
+    /** Timed queries per case, after one untimed warm-up query */
+    int32 QueriesPerCase = 200;
+};
+
+/** Timing and work counters of one query kind on one board */
+struct STRATEGICO_A_TURNI_API FGridBenchmarkResult
+{
+    /** Query kind and the gameplay entry point it makes the same calls as, empty for a bare search the game does not run */
+    FString Query;
+    FString EntryPoint;
+
+    int32 Size = 0;
+    float Density = 0.0f;
+    int32 Queries = 0;
+
+    /** Latency percentiles in microseconds */
+    double P50Micros = 0.0;
+    double P99Micros = 0.0;
+
+    /** Average per query; nodes are 0 for the word-parallel bitboard queries */
+    double NodesExpanded = 0.0;
+    double ScratchAllocations = 0.0;
+};
+
+class STRATEGICO_A_TURNI_API FGridPathfindingBenchmark
+{
+public:
+
+    /** Runs every query kind on every board of the settings */
+    static void Run(const FGridBenchmarkSettings& Settings, TArray<FGridBenchmarkResult>& OutResults);
+
+    /** Writes the results as a table to the log */
+    static void LogResults(const TArray<FGridBenchmarkResult>& Results);
+
+    /** Formats the results as CSV, one row per result */
+    static FString ToCSV(const TArray<FGridBenchmarkResult>& Results);
+};
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//GridPlacementScorer
+//Picks the cell to place a unit on during setup. Every free cell is scored in parallel from path-distance fields
+//to the enemy and allied units, the enemy threat and the local mobility (low in choke points), and the best cell
+//wins with ties going to the lowest cell index, so the choice is deterministic and exists whenever a free cell does.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FGridSearchGrid;
+
+/** A unit already on the board, as the scorer sees it */
+struct FGridPlacementUnit
+{
+    int32 GridX = 0;
+    int32 GridY = 0;
+};
+
+/** The unit to place and the units it is placed against */
+struct FGridPlacementRequest
+{
+    int32 Movement = 0;
+    int32 Range = 0;
+
+    /** Enemy and allied units already placed */
+    TArray<FGridPlacementUnit> Enemies;
+    TArray<FGridPlacementUnit> Allies;
+
+    /** Expected damage the enemy can deal to each cell next turn, indexed like the search grid; empty for none */
+    TArray<float> Threat;
+};
+
+class STRATEGICO_A_TURNI_API FGridPlacementScorer
+{
+public:
+
+    /**
+     * Scores every passable cell of the grid for the unit and returns the best one
+     * @param Grid - Search grid with units blocking, so passable cells are exactly the free ones
+     * @return False only if the grid has no passable cell
+     */
+    static bool FindBestCell(const FGridSearchGrid& Grid, const FGridPlacementRequest& Request, int32& OutGridX, int32& OutGridY, float* OutScore = nullptr);
+
+private:
+
+    /** Returns the score of one free cell from its distances to the nearest enemy and ally and its mobility */
+    static float ScoreCell(const FGridSearchGrid& Grid, const FGridPlacementRequest& Request, int32 Index,
+        int32 EnemyDistance, int32 AllyDistance, int32 ReachableCells);
+};
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//SaT_AttackPreviewWidget
+//Panel with the odds of the attack on the hovered enemy. The widget builds its own tree in C++ (a text block on a
+//dark border at the bottom of the screen), so it needs no widget blueprint; a blueprint subclass can restyle it
+//with its own tree as long as it keeps a text block named "PreviewText".
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "SaT_AttackPreviewWidget.generated.h"
+
+class UTextBlock;
+struct FSaTAttackPreview;
+
+UCLASS()
+class STRATEGICO_A_TURNI_API USaT_AttackPreviewWidget : public UUserWidget
+{
+    GENERATED_BODY()
+
+public:
+
+    // Writes the odds of the previewed attack into the panel
+    void SetPreview(const FSaTAttackPreview& Preview);
+
+protected:
+
+    // Builds the default tree when no blueprint provided one, then finds the text block
+    virtual void NativeOnInitialized() override;
+
+private:
+
+    UPROPERTY()
+    UTextBlock* PreviewText = nullptr;
+};
@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//SaT_CombatOdds
+//Exact odds of one attack without simulating it: the chance that the target dies, the chance that the attacker dies
+//to the counterattack and the hit points each side is expected to lose, for any attacker type, target type, distance
+//and hit points. Damage is uniform over the attacker's [MinDamage, MaxDamage] and the counterattack over
+//[AUnit::MinCounterDamage, AUnit::MaxCounterDamage], as in AUnit::Attack. The roll tables are filled by the compiler
+//from the unit defaults, and a unit whose damage range differs gets its single entry computed on the fly; since the counterattack is only rolled once the target survived, a query combines the
+//attack and counter tables with a couple of multiplies instead of storing every pair of hit points.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SaT_Enums.h"
+#include "Sniper.h"
+#include "Brawler.h"
+
+/** Outcome of one attack in expectation */
+struct FSaTCombatOutcome
+{
+    float TargetDies = 0.0f;
+    float AttackerDies = 0.0f;
+
+    /** Expected hit points lost, a dead unit losing what it had left */
+    float TargetHpLoss = 0.0f;
+    float AttackerHpLoss = 0.0f;
+
+    /** Expected hit points the target loses over the rolls it survives; 0 if it cannot survive */
+    float TargetHpLossIfSurvives = 0.0f;
+
+    /** Chance of a counterattack (the target can counter and survives), the chance the counter kills and its damage if not */
+    float CounterChance = 0.0f;
+    float CounterKills = 0.0f;
+    float CounterHpLossIfSurvives = 0.0f;
+};
+
+namespace SaTCombatOdds
+{
+    /** Highest hit points of any unit type, the hit point dimension of the tables */
+    inline constexpr int32 MaxHp = ASniper::DefaultHp > ABrawler::DefaultHp ? ASniper::DefaultHp : ABrawler::DefaultHp;
+
+    /** Odds of one uniform damage roll against a unit with a given number of hit points */
+    struct FRollOdds
+    {
+        float Kill = 0.0f;
+        float Damage = 0.0f;
+        float DamageIfSurvives = 0.0f;
+    };
+
+    constexpr FRollOdds MakeRollOdds(int32 MinDamage, int32 MaxDamage, int32 Hp)
+    {
+        FRollOdds Odds;
+        const int32 NumRolls = MaxDamage - MinDamage + 1;
+        int32 Kills = 0;
+        int32 Damage = 0;
+        int32 SurvivingDamage = 0;
+        for (int32 Roll = MinDamage; Roll <= MaxDamage; Roll++)
+        {
+            if (Roll >= Hp)
+            {
+                Kills++;
+                Damage += Hp;
+            }
+            else
+            {
+                Damage += Roll;
+                SurvivingDamage += Roll;
+            }
+        }
+        Odds.Kill = float(Kills) / NumRolls;
+        Odds.Damage = float(Damage) / NumRolls;
+        Odds.DamageIfSurvives = Kills < NumRolls ? float(SurvivingDamage) / (NumRolls - Kills) : 0.0f;
+        return Odds;
+    }
+
+    /** Odds of one uniform damage roll against every hit point count from 0 to MaxHp */
+    struct FRollTable
+    {
+        int32 MinDamage;
+        int32 MaxDamage;
+        FRollOdds Odds[MaxHp + 1];
+    };
+
+    constexpr FRollTable MakeRollTable(int32 MinDamage, int32 MaxDamage)
+    {
+        FRollTable Table{};
+        Table.MinDamage = MinDamage;
+        Table.MaxDamage = MaxDamage;
+        for (int32 Hp = 0; Hp <= MaxHp; Hp++)
+        {
+            Table.Odds[Hp] = MakeRollOdds(MinDamage, MaxDamage, Hp);
+        }
+        return Table;
+    }
+
+    /** Attack rolls of the Sniper and the Brawler, in the order of FSaTCombatOdds::ToTypeIndex */
+    inline constexpr FRollTable AttackRolls[] =
+    {
+        MakeRollTable(ASniper::DefaultMinDamage, ASniper::DefaultMaxDamage),
+        MakeRollTable(ABrawler::DefaultMinDamage, ABrawler::DefaultMaxDamage),
+    };
+
+    inline constexpr FRollTable CounterRolls = MakeRollTable(AUnit::MinCounterDamage, AUnit::MaxCounterDamage);
+}
+
+class STRATEGICO_A_TURNI_API FSaTCombatOdds
+{
+public:
+
+    /** Returns the table index of a unit type: 0 for the Sniper, 1 for the Brawler, INDEX_NONE for NONE */
+    static constexpr int32 ToTypeIndex(EPieceUnit Type)
+    {
+        return Type == EPieceUnit::SNIPER ? 0 : Type == EPieceUnit::BRAWLER ? 1 : INDEX_NONE;
+    }
+
+    /** Returns the type of a unit, NONE if it is neither a Sniper nor a Brawler */
+    static EPieceUnit GetPieceType(const AUnit* Unit);
+
+    /**
+     * Counterattack rule: Sniper attackers are countered by Snipers and by adjacent Brawlers,
+     * Brawler attackers only by adjacent non-Brawlers
+     * @param Distance - Manhattan distance between the units
+     */
+    static constexpr bool CanCounterattack(EPieceUnit AttackerType, EPieceUnit TargetType, int32 Distance)
+    {
+        if (AttackerType == EPieceUnit::SNIPER)
+        {
+            return TargetType == EPieceUnit::SNIPER || (TargetType == EPieceUnit::BRAWLER && Distance <= 1);
+        }
+        if (AttackerType == EPieceUnit::BRAWLER)
+        {
+            return TargetType != EPieceUnit::BRAWLER && Distance <= 1;
+        }
+        return false;
+    }
+
+    /**
+     * Returns the odds of an attack with the default damage of the attacker's type; hit points are clamped to the tables
+     * @param Distance - Manhattan distance between the units, for the counterattack rule
+     */
+    static FSaTCombatOutcome Get(EPieceUnit AttackerType, EPieceUnit TargetType, int32 Distance, int32 AttackerHp, int32 TargetHp)
+    {
+        const int32 Attacker = ToTypeIndex(AttackerType);
+        if (Attacker == INDEX_NONE)
+        {
+            return FSaTCombatOutcome();
+        }
+
+        const SaTCombatOdds::FRollTable& Attack = SaTCombatOdds::AttackRolls[Attacker];
+        return Get(AttackerType, TargetType, Distance, AttackerHp, TargetHp, Attack.MinDamage, Attack.MaxDamage);
+    }
+
+    /**
+     * Returns the odds of an attack by a unit with its own damage range; the tables serve the default ranges,
+     * any other range has its entry rolled out on the fly
+     * @param MinDamage, MaxDamage - Damage range of the attacker
+     */
+    static FSaTCombatOutcome Get(EPieceUnit AttackerType, EPieceUnit TargetType, int32 Distance, int32 AttackerHp, int32 TargetHp,
+        int32 MinDamage, int32 MaxDamage)
+    {
+        FSaTCombatOutcome Outcome;
+        const int32 Attacker = ToTypeIndex(AttackerType);
+        if (Attacker == INDEX_NONE || MaxDamage < MinDamage)
+        {
+            return Outcome;
+        }
+
+        const SaTCombatOdds::FRollTable& Table = SaTCombatOdds::AttackRolls[Attacker];
+        TargetHp = FMath::Clamp(TargetHp, 0, SaTCombatOdds::MaxHp);
+        const SaTCombatOdds::FRollOdds Attack = Table.MinDamage == MinDamage && Table.MaxDamage == MaxDamage ?
+            Table.Odds[TargetHp] : SaTCombatOdds::MakeRollOdds(MinDamage, MaxDamage, TargetHp);
+        Outcome.TargetDies = Attack.Kill;
+        Outcome.TargetHpLoss = Attack.Damage;
+        Outcome.TargetHpLossIfSurvives = Attack.DamageIfSurvives;
+
+        if (CanCounterattack(AttackerType, TargetType, Distance))
+        {
+            const SaTCombatOdds::FRollOdds& Counter = SaTCombatOdds::CounterRolls.Odds[FMath::Clamp(AttackerHp, 0, SaTCombatOdds::MaxHp)];
+            Outcome.CounterChance = 1.0f - Outcome.TargetDies;
+            Outcome.CounterKills = Counter.Kill;
+            Outcome.CounterHpLossIfSurvives = Counter.DamageIfSurvives;
+            Outcome.AttackerDies = Outcome.CounterChance * Counter.Kill;
+            Outcome.AttackerHpLoss = Outcome.CounterChance * Counter.Damage;
+        }
+        return Outcome;
+    }
+
+    /** Returns the odds of an attack between two units at their current hit points, cells and damage ranges */
+    static FSaTCombatOutcome Get(const AUnit* Attacker, const AUnit* Target);
+};
@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//SaT_DifficultySettings
+//Difficulty profiles of the AI, read from the game config (DefaultGame.ini) and editable in the Project Settings
+//under Game > Difficulty Profiles. A profile sets how the AI decides, how much time and search it may spend, how far
+//it strays from its best plan and the map the difficulty is played on, so difficulties are tuned, or made cheaper for
+//slow machines, without touching code. A difficulty with no profile in the config plays its built-in profile.
+//The weights of the planner's evaluation are shared by every difficulty; the EvalTuner commandlet writes them here.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SaT_Enums.h"
+#include "SaT_TurnPlanner.h"
+#include "Engine/DeveloperSettings.h"
+#include "SaT_DifficultySettings.generated.h"
+
+// Everything a difficulty changes
+USTRUCT(BlueprintType)
+struct FSaTDifficultyProfile
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Difficulty")
+    EAIDifficulty Difficulty = EAIDifficulty::HARD;
+
+    // ----------------
+    // AI
+    // ----------------
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI")
+    EAIAlgorithm Algorithm = EAIAlgorithm::PLANNER;
+
+    // Time budget of the joint plan of the AI units, searched again before each unit acts, and of every plan the
+    // ponderer searches; the "AI thinking" widget counts it down (Planner)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI", meta = (ClampMin = "0.0"))
+    float TurnPlanBudgetMs = 50.0f;
+
+    // AI units planned together, the depth of the plan search (Planner)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI", meta = (ClampMin = "1", ClampMax = "8"))
+    int32 MaxPlannedUnits = 8;
+
+    // Actions kept per unit and node, the breadth of the plan search (Planner)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI", meta = (ClampMin = "1"))
+    int32 MaxActionsPerUnit = 10;
+
+    // Spread of the played plan around the best one, in evaluation points; 0 always plays the best plan (Planner)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI", meta = (ClampMin = "0.0"))
+    float Temperature = 0.0f;
+
+    // Play solved 1v1 endgames from the endgame tablebase (Greedy, Planner)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI")
+    bool bUseEndgameTablebase = true;
+
+    // Keep planning the next turn in the background while the human plays (Planner)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI")
+    bool bPonderDuringHumanTurn = true;
+
+    // ----------------
+    // Map
+    // ----------------
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Map", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float ObstaclePercentage = 0.2f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Map", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float TerrainPercentage = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Map")
+    bool bRequireLineOfSight = false;
+};
+
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Difficulty Profiles"))
+class STRATEGICO_A_TURNI_API USaT_DifficultySettings : public UDeveloperSettings
+{
+    GENERATED_BODY()
+
+public:
+
+    USaT_DifficultySettings();
+
+    // One profile per difficulty
+    UPROPERTY(Config, EditAnywhere, Category = "Difficulty")
+    TArray<FSaTDifficultyProfile> Profiles;
+
+    // ----------------
+    // Evaluation weights of the planner, see FSaTEvalWeights
+    // ----------------
+
+    UPROPERTY(Config, EditAnywhere, Category = "Evaluation", meta = (ClampMin = "0.0"))
+    float HpWeight;
+
+    UPROPERTY(Config, EditAnywhere, Category = "Evaluation", meta = (ClampMin = "0.0"))
+    float KillWeight;
+
+    UPROPERTY(Config, EditAnywhere, Category = "Evaluation", meta = (ClampMin = "0.0"))
+    float ExposureWeight;
+
+    UPROPERTY(Config, EditAnywhere, Category = "Evaluation", meta = (ClampMin = "0.0"))
+    float ApproachWeight;
+
+    UPROPERTY(Config, EditAnywhere, Category = "Evaluation", meta = (ClampMin = "0.0"))
+    float LineControlWeight;
+
+    // Returns the profile of a difficulty, the built-in one if the config has none
+    static FSaTDifficultyProfile GetProfile(EAIDifficulty Difficulty);
+
+    // Returns the profile a difficulty plays without config: random Easy on an open map, planned Hard
+    static FSaTDifficultyProfile MakeDefaultProfile(EAIDifficulty Difficulty);
+
+    FSaTEvalWeights GetEvalWeights() const;
+
+    void SetEvalWeights(const FSaTEvalWeights& Weights);
+};
@@ -0,0 +1,211 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//SaT_EndgameTablebase
+//Solved 1v1 endgames (Sniper/Sniper, Sniper/Brawler, Brawler/Brawler) guiding the AI's moves.
+//A position is reduced to the unit types, their hit points, the Manhattan distance between them and the side to move;
+//obstacles, line of sight and the board edges are not modelled, so the values are an approximation of the real game
+//and only steer the AI; the game mode keeps its own rules for ending a match. Each entry holds the mover's chances to win and to lose
+//over the damage and counterattack rolls, solved by retrograde analysis: layers of growing total hit points, each solved
+//by value iteration over the moves that keep the hit points, with the attacks reading the layers below.
+//The table is generated once into Saved/Tablebase and memory-mapped from there, or ahead of time with:
+//  UnrealEditor-Cmd <Project>.uproject -run=EndgameTablebase [-out=Path] [-size=25]
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SaT_Enums.h"
+#include "Async/Future.h"
+#include "HAL/CriticalSection.h"
+#include <atomic>
+
+class AUnit;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/** Stats of one unit type as the tablebase sees them */
+struct FSaTEndgameUnitRules
+{
+    int32 MaxHp = 0;
+    int32 Movement = 0;
+    int32 Range = 0;
+    int32 MinDamage = 0;
+    int32 MaxDamage = 0;
+};
+
+/** Rules a table is solved for; kept in the file header so a table of other stats or board size is never used */
+struct FSaTEndgameRules
+{
+    /** Unit types of the table: 0 is the Sniper, 1 the Brawler */
+    static constexpr int32 NumTypes = 2;
+
+    FSaTEndgameUnitRules Units[NumTypes];
+
+    int32 MinCounterDamage = 0;
+    int32 MaxCounterDamage = 0;
+
+    /** Counterattack rule, one bit per (attacker type, target type, adjacent or not); see CanCounterattack */
+    int32 CounterMask = 0;
+
+    /** Largest distance between two cells of the board */
+    int32 MaxDistance = 0;
+
+    /** Reads the stats of the Sniper and Brawler defaults and the AUnit counterattack rule */
+    static FSaTEndgameRules FromUnitDefaults(int32 BoardSize);
+
+    bool CanCounterattack(int32 AttackerType, int32 TargetType, int32 Distance) const
+    {
+        return (CounterMask >> ((AttackerType * NumTypes + TargetType) * 2 + (Distance <= 1 ? 0 : 1)) & 1) != 0;
+    }
+
+    /** Highest hit points of any type, the hit point dimension of the table */
+    int32 GetMaxHp() const { return FMath::Max(Units[0].MaxHp, Units[1].MaxHp); }
+
+    int32 GetNumEntries() const { return NumTypes * NumTypes * GetMaxHp() * GetMaxHp() * MaxDistance; }
+
+    bool operator==(const FSaTEndgameRules& Other) const
+    {
+        return FMemory::Memcmp(this, &Other, sizeof(FSaTEndgameRules)) == 0;
+    }
+};
+
+/** Outcome chances of a position for the side to move */
+struct FSaTEndgameValue
+{
+    float Win = 0.0f;
+    float Loss = 0.0f;
+
+    /** Expected result, +1 for a sure win and -1 for a sure loss */
+    float GetScore() const { return Win - Loss; }
+
+    /** Returns the same outcome seen by the other side */
+    FSaTEndgameValue Flip() const { return { Loss, Win }; }
+};
+
+class STRATEGICO_A_TURNI_API FSaTEndgameTablebase
+{
+public:
+
+    /** Entry of a position: quantised win and loss chances, 0 only when the chance is exactly 0 */
+    struct FEntry
+    {
+        uint8 Win;
+        uint8 Loss;
+    };
+
+    static constexpr uint32 FileMagic = 0x42544153; // "SATB"
+    static constexpr uint32 FileVersion = 1;
+
+    /** Returns the game's tablebase */
+    static FSaTEndgameTablebase& Get();
+
+    /** Returns where the game keeps the table: Saved/Tablebase/Endgame.sattb */
+    static FString GetDefaultPath();
+
+    /** Returns the tablebase type index of a unit type, INDEX_NONE for NONE */
+    static int32 ToTypeIndex(EPieceUnit Type);
+
+    /** Returns the type of a unit, NONE if it is neither a Sniper nor a Brawler */
+    static EPieceUnit GetPieceType(const AUnit* Unit);
+
+    ~FSaTEndgameTablebase();
+
+    // ----------------------------------------
+    // Generation
+    // ----------------------------------------
+
+    /**
+     * Solves every endgame of the rules; the groups of one hit point layer are spread over the worker threads
+     * @param OutEntries - Receives GetNumEntries() entries in table order
+     */
+    static void Generate(const FSaTEndgameRules& Rules, TArray<FEntry>& OutEntries);
+
+    /** Writes the header and the entries to a file that LoadFromFile maps */
+    static bool SaveToFile(const FString& Path, const FSaTEndgameRules& Rules, const TArray<FEntry>& Entries);
+
+    // ----------------------------------------
+    // Loading
+    // ----------------------------------------
+
+    /** Maps a table file; fails if it is missing, damaged or solved for other rules */
+    bool LoadFromFile(const FString& Path, const FSaTEndgameRules& Rules);
+
+    /**
+     * Makes the table of the rules available without blocking: maps the saved file, or generates and saves it on a
+     * background thread first. Lookups wait for IsReady
+     */
+    void LoadOrGenerateAsync(const FSaTEndgameRules& Rules);
+
+    bool IsReady() const { return Table.load(std::memory_order_acquire) != nullptr; }
+
+    /** Drops every table; only once no lookup and no LoadOrGenerateAsync can still be running */
+    void Reset();
+
+    // ----------------------------------------
+    // Queries
+    // ----------------------------------------
+
+    /** Returns the value of a position for the mover; Distance is clamped to the table, a draw if the table is not ready */
+    FSaTEndgameValue Lookup(EPieceUnit MoverType, EPieceUnit OtherType, int32 HpMover, int32 HpOther, int32 Distance) const;
+
+    /** Looks up the position of two units with the first one to move; false if the table is not ready or a type is unknown */
+    bool Probe(const AUnit* Mover, const AUnit* Other, FSaTEndgameValue& OutValue) const;
+
+    /** Returns the value for the mover of ending its turn at the distance without attacking */
+    FSaTEndgameValue EvaluatePass(EPieceUnit MoverType, EPieceUnit OtherType, int32 HpMover, int32 HpOther, int32 Distance) const;
+
+    /**
+     * Returns the expected value for the mover of attacking at the distance, over the damage and counterattack rolls
+     * @param bMoveAfter - The mover still has its move after the attack and picks the best distance for each roll
+     */
+    FSaTEndgameValue EvaluateAttack(EPieceUnit MoverType, EPieceUnit OtherType, int32 HpMover, int32 HpOther, int32 Distance, bool bMoveAfter) const;
+
+    /** Rules of the table in use, all zero if none is ready */
+    FSaTEndgameRules GetRules() const;
+
+    /** Returns the memory held by the tables, replaced ones included (mapped pages are not counted) */
+    SIZE_T GetAllocatedSize() const;
+
+private:
+
+    /** Start of every table file */
+    struct FFileHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        FSaTEndgameRules Rules;
+    };
+
+    /** Returns the entry index of a position, types as table indices and hit points from 1 */
+    static int32 ToEntryIndex(const FSaTEndgameRules& InRules, int32 Mover, int32 Other, int32 HpMover, int32 HpOther, int32 Distance)
+    {
+        const int32 MaxHp = InRules.GetMaxHp();
+        return (((Mover * FSaTEndgameRules::NumTypes + Other) * MaxHp + HpMover - 1) * MaxHp + HpOther - 1) * InRules.MaxDistance + Distance - 1;
+    }
+
+    /** One solved table: the mapped file, or GeneratedEntries when the file could not be written */
+    struct FTable
+    {
+        FSaTEndgameRules Rules;
+        const FEntry* Entries = nullptr;
+        TArray<FEntry> GeneratedEntries;
+
+        IMappedFileHandle* MappedFile = nullptr;
+        IMappedFileRegion* MappedRegion = nullptr;
+
+        ~FTable();
+    };
+
+    /** Hands a complete table to the lookups; the table it replaces is kept, since a lookup may still be reading it */
+    void Publish(TUniquePtr<FTable> NewTable);
+
+    /** Table the lookups read, only ever swapped for another complete one */
+    std::atomic<const FTable*> Table { nullptr };
+
+    /** Every table published since the last Reset, the one in use last */
+    TArray<TUniquePtr<FTable>> Tables;
+    mutable FCriticalSection TablesLock;
+
+    /** Load or generation started by LoadOrGenerateAsync, waited for before the tables are destroyed */
+    TFuture<void> LoadingTask;
+    std::atomic<bool> bLoading { false };
+};
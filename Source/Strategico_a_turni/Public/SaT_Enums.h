@@ -65,6 +65,25 @@ enum class EAIDifficulty : uint8
 	HARD UMETA(DisplayName = "Hard")
 };
 
+// Enum for the way the AI decides its actions, set by the difficulty profile
+UENUM(BlueprintType)
+enum class EAIAlgorithm : uint8
+{
+	RANDOM UMETA(DisplayName = "Random"),		// Random attacks and moves
+	GREEDY UMETA(DisplayName = "Greedy"),		// Each unit plays its own best action
+	PLANNER UMETA(DisplayName = "Planner")		// The units of a turn are planned together
+};
+
+// Enum for the terrain of a cell, which sets the movement cost of stepping onto it
+UENUM(BlueprintType)
+enum class ETerrainType : uint8
+{
+	PLAIN UMETA(DisplayName = "Plain"),		// Cost 1
+	ROAD UMETA(DisplayName = "Road"),		// Cost 1
+	FOREST UMETA(DisplayName = "Forest"),	// Cost 2
+	HILL UMETA(DisplayName = "Hill")		// Cost 3
+};
+
 class STRATEGICO_A_TURNI_API SaT_Enums
 {
 public:
@@ -86,4 +86,20 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Game")
     void SetupGameWithDifficulty(EAIDifficulty Difficulty);
 
+    // ----------------
+    // Console Commands
+    // ----------------
+
+    // Logs the tile actor count and memory of the grid, to check that regenerations do not leak
+    UFUNCTION(Exec)
+    void SaTTileReport();
+
+    // Runs the pathfinding micro-benchmark on seeded boards and logs p50/p99 latency, nodes and allocations
+    UFUNCTION(Exec)
+    void SaTBenchmarkPathfinding(int32 Seed = 1337, int32 QueriesPerCase = 200);
+
+    // Logs the memory of the grid, tiles, pathfinding, AI search and log/HUD against their budgets
+    UFUNCTION(Exec)
+    void SaTMemoryBudget();
+
 };
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "SaT_PlayerInterface.h"
 #include "SaT_GameInstance.h"
 #include "SaT_Enums.h"
+#include "GridPathfinding.h"
 #include "Blueprint/UserWidget.h"
 #include "SaT_HumanPlayer.generated.h"
 
@@ -15,6 +16,37 @@
 class AGridManager;
 class AUnit;
 class ATile;
+class USaT_AttackPreviewWidget;
+
+// Odds of attacking the enemy under the cursor, shown by the attack preview widget
+USTRUCT(BlueprintType)
+struct FSaTAttackPreview
+{
+    GENERATED_BODY()
+
+    // False when no attackable enemy is hovered
+    UPROPERTY(BlueprintReadOnly, Category = "Combat")
+    bool bValid = false;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Combat")
+    int32 MinDamage = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Combat")
+    int32 MaxDamage = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Combat")
+    float KillChance = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Combat")
+    float ExpectedDamage = 0.0f;
+
+    // Chance the target survives and strikes back, and that the strike back kills the attacker
+    UPROPERTY(BlueprintReadOnly, Category = "Combat")
+    float CounterChance = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Combat")
+    float CounterKillChance = 0.0f;
+};
 
 UCLASS()
 class STRATEGICO_A_TURNI_API ASaT_HumanPlayer : public APawn, public ISaT_PlayerInterface
@@ -189,6 +221,18 @@ public:
     // Shows the possible movement range for a unit
     void ShowMovementRange(AUnit* Unit);
 
+    // Builds the shortest-path tree of the unit over its movement range, used by the hover preview and the move
+    void BuildMoveTree(AUnit* Unit);
+
+    // Gets the path to a cell from the move tree; false if the tree is stale or the cell is out of range
+    bool GetMoveTreePath(int32 GridX, int32 GridY, TArray<FVector2D>& OutPath) const;
+
+    // Shows the path to the cell under the cursor while in move mode
+    void UpdateHoverPathPreview();
+
+    // Gets the grid cell under the mouse cursor; false if the cursor is off the grid
+    bool GetCellUnderCursor(FIntPoint& OutCell) const;
+
     // Try to move a unit to the specified grid location
     bool TryMoveUnit(AUnit* Unit, int32 TargetGridX, int32 TargetGridY);
 
@@ -203,6 +247,14 @@ public:
     UPROPERTY()
     TArray<FVector2D> CurrentPath;
 
+    // Shortest-path tree from the selected unit, built once per move mode; each hover only walks its parents
+    FGridSearchGrid MoveSearchGrid;
+    FGridDistanceField MoveTree;
+    AUnit* MoveTreeUnit = nullptr;
+
+    // Cell whose path is currently previewed, (-1, -1) when none
+    FIntPoint HoveredCell = FIntPoint(-1, -1);
+
     // Track units that have attacked this turn
     UPROPERTY()
     TMap<AUnit*, bool> UnitAttackedThisTurn;
@@ -215,6 +267,29 @@ public:
     UFUNCTION()
     bool TryAttackUnit(AUnit* AttackingUnit, AUnit* TargetUnit);
 
+    // Attack preview widget, shown while an attackable enemy is hovered in attack mode; the C++ panel unless a blueprint subclass is set
+    UPROPERTY(EditDefaultsOnly, Category = "UI")
+    TSubclassOf<USaT_AttackPreviewWidget> AttackPreviewWidgetClass;
+
+    UPROPERTY()
+    USaT_AttackPreviewWidget* AttackPreviewWidget = nullptr;
+
+    // Odds of attacking the hovered enemy, from the combat odds tables
+    UPROPERTY(BlueprintReadOnly, Category = "Combat")
+    FSaTAttackPreview AttackPreview;
+
+    UFUNCTION(BlueprintCallable, Category = "Combat")
+    FSaTAttackPreview GetAttackPreview() const { return AttackPreview; }
+
+    // Shows the odds of attacking the enemy under the cursor while in attack mode
+    void UpdateHoverAttackPreview();
+
+    // Hides the attack preview
+    void ClearAttackPreview();
+
+    // Cell whose attack is currently previewed, (-1, -1) when none
+    FIntPoint HoveredAttackCell = FIntPoint(-1, -1);
+
     // -----------------
     // References & Services
     // -----------------
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//SaT_Memory
+//Low-Level Memory tracker tags of the game logic and the memory budget report.
+//Run with -llm to see the SaT/* tags in "stat LLMFULL" and LLM CSV captures; the SaTMemoryBudget
+//console command compares the game's own accounting (and the LLM totals when available) to the budget.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+class UWorld;
+
+LLM_DECLARE_TAG_API(SaT, STRATEGICO_A_TURNI_API);
+LLM_DECLARE_TAG_API(SaT_Grid, STRATEGICO_A_TURNI_API);
+LLM_DECLARE_TAG_API(SaT_Tiles, STRATEGICO_A_TURNI_API);
+LLM_DECLARE_TAG_API(SaT_Pathfinding, STRATEGICO_A_TURNI_API);
+LLM_DECLARE_TAG_API(SaT_AISearch, STRATEGICO_A_TURNI_API);
+LLM_DECLARE_TAG_API(SaT_LogHUD, STRATEGICO_A_TURNI_API);
+
+/** Memory of one budget category */
+struct FSaTMemoryCategory
+{
+    /** Name of the category, same as its LLM tag without the SaT/ prefix */
+    FString Name;
+
+    /** Bytes the game accounts for itself (container allocations and estimated actor size) */
+    SIZE_T TrackedBytes = 0;
+
+    /** Bytes the LLM tag currently holds, or -1 when LLM is not running */
+    int64 LLMBytes = -1;
+
+    /** Allowed bytes for the category */
+    SIZE_T BudgetBytes = 0;
+
+    bool IsOverBudget() const
+    {
+        return FMath::Max<int64>(TrackedBytes, LLMBytes) > int64(BudgetBytes);
+    }
+};
+
+class STRATEGICO_A_TURNI_API FSaTMemoryBudget
+{
+public:
+
+    /** Fills one entry per category from the grid, AI player and game mode of the world */
+    static void Collect(UWorld* World, TArray<FSaTMemoryCategory>& OutCategories);
+
+    /** Writes the categories to the log, with a warning for every category over budget */
+    static void Log(UWorld* World);
+};
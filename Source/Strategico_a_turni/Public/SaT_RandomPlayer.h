@@ -10,11 +10,17 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Pawn.h"
 #include "SaT_PlayerInterface.h"
+#include "GridPathfinding.h"
+#include "SaT_TurnPlanner.h"
+#include "SaT_TurnPonderer.h"
+#include "SaT_DifficultySettings.h"
 #include "SaT_RandomPlayer.generated.h"
 
 class USaT_GameInstance;
+class FSaTSearchStatsFeed;
 class AGridManager;
 class AUnit;
+struct FSaTGameEvent;
 
 UCLASS()
 class STRATEGICO_A_TURNI_API ASaT_RandomPlayer : public APawn, public ISaT_PlayerInterface
@@ -33,6 +39,9 @@ public:
     // Called when the game starts or when spawned
     virtual void BeginPlay() override;
 
+    // Stops pondering before the grid goes away
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
     // Called every frame
     virtual void Tick(float DeltaTime) override;
 
@@ -67,8 +76,11 @@ public:
     // Place a random unit during setup phase
     void PlaceRandomUnit();
 
-    // Find a random empty cell on the grid
-    bool FindRandomEmptyCell(int32& OutGridX, int32& OutGridY);
+    // Find the best free cell to place a unit of the given type on
+    bool FindBestPlacementCell(bool bIsSniper, int32& OutGridX, int32& OutGridY);
+
+    // Memory held by the search scratch, for the memory budget report
+    SIZE_T GetSearchAllocatedSize() const;
 
     // -----------------
     // AI Unit Processing
@@ -83,6 +95,13 @@ public:
     // Process actions for a specific AI unit
     void ProcessUnitActions(AUnit* Unit);
 
+    // Difficulty profile the AI plays, taken from the difficulty settings at the start of each turn
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AI")
+    FSaTDifficultyProfile Profile;
+
+    // Take the profile of the current difficulty
+    void ApplyDifficultyProfile();
+
     // -----------------
     // AI Strategy - Basic
     // -----------------
@@ -103,22 +122,66 @@ public:
     // Process unit actions with strategic behavior (Hard mode)
     void ProcessUnitActionsStrategic(AUnit* Unit);
 
+    // Play a 1v1 endgame from the endgame tablebase; false if the table cannot play this position
+    bool PlayEndgameTurn(AUnit* AIUnit);
+
+    // Move to the reachable cell the endgame tablebase rates best to end the turn on
+    void MoveToBestEndgameCell(AUnit* AIUnit, AUnit* Enemy);
+
+    // Plan the AI units left this turn together and bring the first unit of the plan to CurrentUnitIndex
+    void PlanRemainingUnits();
+
+    // Copy the state of the units into planner units, in the same order
+    void FillPlannerUnits(const TArray<AUnit*>& Actors, TArray<FSaTPlannerUnit>& OutUnits) const;
+
+    // Planner settings of this AI, with its planner table
+    FSaTTurnPlannerSettings MakePlannerSettings();
+
+    // Remember the board this turn left and start pondering the next AI turn while the human plays
+    void StartPondering();
+
+    // Find the board of this turn by replaying the game events since the last one on the board it left
+    bool ReRootFromEvents();
+
+    // Play one logged action on a planner board
+    static void ApplyGameEvent(TArray<FSaTPlannerUnit>& Board, const FSaTGameEvent& Event);
+
+    // Play the planned action of the unit; false if the plan has none for it or it no longer fits the board
+    bool PlayPlannedAction(AUnit* AIUnit);
+
     // Find a target to attack using strategic prioritization
     AUnit* FindAttackTarget(AUnit* AIUnit);
 
-    // Move toward closest player unit using pathfinding
+    // Move toward the nearest attack square using a single distance sweep
     void MoveTowardPlayerUnit(AUnit* AIUnit);
 
-    // Find the closest player unit to the given AI unit
+    // Find the closest player unit to the given AI unit by path distance
     AUnit* FindClosestPlayerUnit(AUnit* AIUnit);
 
+    // Find the nearest reachable cell from which a player unit can be attacked
+    bool FindClosestAttackSquare(AUnit* AIUnit, const TArray<AUnit*>& PlayerUnits, int32& OutGridX, int32& OutGridY) const;
+
+    // Collect the living player units
+    void CollectPlayerUnits(TArray<AUnit*>& OutPlayerUnits) const;
+
+    // Find the least exposed cell the unit can attack from, using the influence map
+    bool FindSafeAttackPosition(AUnit* AIUnit, int32& OutGridX, int32& OutGridY, AUnit*& OutTarget);
+
+    // Move the unit along a path (start first, destination last) and log the move
+    void ExecuteMove(AUnit* AIUnit, const TArray<FVector2D>& Path);
+
+    // Attack the target and log the result
+    void ExecuteAttack(AUnit* AIUnit, AUnit* Target);
+
+    // Collect the player units inside the attack range of the given AI unit
+    void CollectTargetsInRange(AUnit* AIUnit, TArray<AUnit*>& OutTargets) const;
+
     // -----------------
     // Pathfinding Utilities
     // -----------------
 
-    // Reconstruct path from A* search and get the best move within range
-    FVector2D ReconstructPath(const TMap<FVector2D, FVector2D>& CameFrom,
-        FVector2D Current, FVector2D Start, int32 MaxSteps);
+    // Sweep path distances from the unit to every cell into DistanceField
+    void ComputeDistancesFrom(AUnit* AIUnit);
 
     // Calculate Manhattan distance between two points
     int32 ManhattanDistance(const FVector2D& A, const FVector2D& B);
@@ -146,4 +209,37 @@ public:
     UPROPERTY()
     int32 CurrentUnitIndex;
 
+    // True while the AI units of this turn are planned together
+    bool bPlanTurnJointly = false;
+
+    // Plan of the units left this turn, and the actor of each planner unit
+    FSaTTurnPlan TurnPlan;
+
+    UPROPERTY()
+    TArray<AUnit*> TurnPlanUnits;
+
+    // Search of the next AI turn running during the human turn
+    FSaTTurnPonderer Ponderer;
+
+    // Boards searched by the planner and the ponderer, kept across turns
+    FSaTPlannerTable PlannerTable;
+
+    // Board the last AI turn left, its units, and the length of the event log then
+    TArray<FSaTPlannerUnit> LastBoard;
+
+    UPROPERTY()
+    TArray<AUnit*> LastBoardUnits;
+
+    int32 LastEventCount = 0;
+
+    // Search scratch reused between sweeps
+    FGridSearchGrid SearchGrid;
+    FGridDistanceField DistanceField;
+
+    // Stats feed of the game mode, set for the duration of a decision
+    FSaTSearchStatsFeed* SearchFeed = nullptr;
+
+    // Records the chosen move as the principal variation of the running decision
+    void ReportSearchMove(AUnit* AIUnit, int32 ToX, int32 ToY, const AUnit* Target, float Score);
+
 };
\ No newline at end of file
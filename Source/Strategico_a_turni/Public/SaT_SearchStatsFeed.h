@@ -0,0 +1,166 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//SaT_SearchStatsFeed
+//Live statistics of the AI search for the "AI thinking" widget. The search (on any one thread)
+//publishes plain snapshots at a throttled rate; the game thread picks up the latest one without locks.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+#include "SaT_SearchStatsFeed.generated.h"
+
+/** One move of the principal variation; Target is the attacked cell, or -1 for a plain move */
+struct FSaTSearchMove
+{
+    int16 FromX = 0;
+    int16 FromY = 0;
+    int16 ToX = 0;
+    int16 ToY = 0;
+    int16 TargetX = -1;
+    int16 TargetY = -1;
+};
+
+/** Statistics of the running search, copied as a whole so it must stay free of allocations */
+struct FSaTSearchSnapshot
+{
+    static constexpr int32 MaxPVLength = 8;
+
+    /** Nodes searched since the decision started, and the rate since then */
+    int64 NodesSearched = 0;
+    float NodesPerSecond = 0.0f;
+
+    /** Deepest completed ply */
+    int32 Depth = 0;
+
+    /** Score of the best move found so far, higher is better for the AI */
+    float BestScore = 0.0f;
+
+    /** Time left of the decision budget */
+    float TimeRemainingMs = 0.0f;
+
+    /** Best line found so far */
+    int32 PVLength = 0;
+    FSaTSearchMove PV[MaxPVLength];
+
+    /** True once the decision is made; the final snapshot is never throttled */
+    bool bFinished = false;
+};
+
+/**
+ * Single-producer, single-consumer triple buffer
+ * The producer always owns one slot and the consumer another; the third is swapped through one atomic,
+ * so neither side ever waits and the consumer always gets the newest complete value.
+ */
+template <typename T>
+class TSaTTripleBuffer
+{
+public:
+
+    /** Slot the producer fills before calling Publish */
+    T& GetWriteBuffer() { return Buffers[WriteIndex]; }
+
+    /** Hands the filled slot over to the consumer */
+    void Publish()
+    {
+        WriteIndex = Shared.exchange(WriteIndex | DirtyBit, std::memory_order_acq_rel) & IndexMask;
+    }
+
+    /** Copies the newest published value, if there is one the consumer has not seen */
+    bool Consume(T& OutValue)
+    {
+        if ((Shared.load(std::memory_order_relaxed) & DirtyBit) == 0)
+        {
+            return false;
+        }
+
+        ReadIndex = Shared.exchange(ReadIndex, std::memory_order_acq_rel) & IndexMask;
+        OutValue = Buffers[ReadIndex];
+        return true;
+    }
+
+private:
+
+    static constexpr uint8 IndexMask = 0x3;
+    static constexpr uint8 DirtyBit = 0x4;
+
+    T Buffers[3];
+    std::atomic<uint8> Shared{ 1 };
+    uint8 WriteIndex = 0;
+    uint8 ReadIndex = 2;
+};
+
+/** Throttled feed of search snapshots from the AI to the HUD */
+class STRATEGICO_A_TURNI_API FSaTSearchStatsFeed
+{
+public:
+
+    /** Minimum time between two published snapshots of the same search */
+    double PublishIntervalSeconds = 0.1;
+
+    // ----------------------------------------
+    // Producer (the thread running the search)
+    // ----------------------------------------
+
+    /** Starts a new decision with the given time budget and publishes an empty snapshot */
+    void BeginSearch(float BudgetMs);
+
+    /** Snapshot being filled; NodesPerSecond and TimeRemainingMs are computed on publish */
+    FSaTSearchSnapshot& GetSnapshot() { return Working; }
+
+    /** Publishes the working snapshot if the publish interval has passed; returns true if it did */
+    bool Update();
+
+    /** Publishes the working snapshot as the final one of the decision */
+    void FinishSearch();
+
+    // ----------------------------------------
+    // Consumer (game thread)
+    // ----------------------------------------
+
+    /** Copies the newest snapshot, if a new one was published since the last call */
+    bool Poll(FSaTSearchSnapshot& OutSnapshot) { return Buffer.Consume(OutSnapshot); }
+
+private:
+
+    void Publish(double NowSeconds);
+
+    TSaTTripleBuffer<FSaTSearchSnapshot> Buffer;
+    FSaTSearchSnapshot Working;
+
+    double StartSeconds = 0.0;
+    double LastPublishSeconds = 0.0;
+    float BudgetMs = 0.0f;
+};
+
+/** Search statistics as shown by the "AI thinking" widget */
+USTRUCT(BlueprintType)
+struct STRATEGICO_A_TURNI_API FSaTAISearchStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI")
+    int64 NodesSearched = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI")
+    float NodesPerSecond = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI")
+    int32 Depth = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI")
+    float BestScore = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI")
+    float TimeRemainingMs = 0.0f;
+
+    /** Best line in letter-number notation, e.g. "B3-D4 xE6" */
+    UPROPERTY(BlueprintReadOnly, Category = "AI")
+    FString PrincipalVariation;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI")
+    bool bFinished = false;
+
+    /** Converts a snapshot; only called on the game thread, where allocating the text is fine */
+    static FSaTAISearchStats FromSnapshot(const FSaTSearchSnapshot& Snapshot);
+};
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//SaT_SelfPlay
+//Headless matches between two sets of evaluation weights and a tuner of the weights built on them. A match is played
+//on a seeded board by the turn planner for both sides, one unit at a time as in the game, with real damage and
+//counterattack rolls; boards follow the game's rules (every free cell connected, attacks blocked by obstacles when
+//line of sight is required) and matches of a batch run in parallel, each seed played twice with the sides swapped. The
+//tuner fits the weights by SPSA: every iteration plays a randomly perturbed pair of weights against each other and
+//steps the weights along the estimated gradient of the match score. Used by the EvalTuner commandlet.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SaT_TurnPlanner.h"
+
+/** Matches to play and how to tune */
+struct STRATEGICO_A_TURNI_API FSaTSelfPlaySettings
+{
+    /** Seed of the boards, rolls and perturbations; same seed, same run as long as no plan hits its budget */
+    int32 Seed = 1;
+
+    /** Side of the board, at most the bitboard width the line of sight tables cover */
+    int32 BoardSize = 25;
+
+    /** Fraction of cells turned into obstacles */
+    float ObstacleDensity = 0.2f;
+
+    /** Ranged attacks need a clear line of sight, the game's rule when the profile turns it on */
+    bool bRequireLineOfSight = true;
+
+    /** Turns of each side before a match is adjudicated on the hit points left */
+    int32 MaxTurns = 40;
+
+    /** Planner of both sides; cheaper than in game so a tuning run plays many matches */
+    float PlannerBudgetMs = 10.0f;
+    int32 MaxActionsPerUnit = 6;
+
+    /** Seeds per SPSA iteration, each played twice with the sides swapped */
+    int32 MatchPairs = 16;
+
+    int32 Iterations = 40;
+
+    /** SPSA gains, relative to the scale of each weight: step of the update and size of the perturbation */
+    float StepSize = 0.5f;
+    float Perturbation = 0.2f;
+};
+
+/** Outcome of one match */
+struct FSaTMatchResult
+{
+    /** False if the seed gave no connected board or no free cell for a unit; the match was not played and scores nothing */
+    bool bPlayed = false;
+
+    /** 1 if the first side won, -1 if the second did, 0 if the turns ran out */
+    int32 Winner = 0;
+
+    /** Turns played by both sides together */
+    int32 Turns = 0;
+
+    /** Hit points the first side had left minus the second side's */
+    float HpDifference = 0.0f;
+};
+
+/** Weights a tuning run ended on, and how they fared against the weights it started from */
+struct FSaTTuningResult
+{
+    FSaTEvalWeights Weights;
+
+    /** Match score against the initial weights, from -1 (lost every match) to 1 (won every match), and its standard error */
+    float ScoreVsInitial = 0.0f;
+    float ScoreStdError = 0.0f;
+
+    /** Matches played, seeds without a playable board left out */
+    int32 MatchesPlayed = 0;
+};
+
+class STRATEGICO_A_TURNI_API FSaTSelfPlay
+{
+public:
+
+    /**
+     * Plays one match: each side has a Sniper and a Brawler placed in its own half of the board, the first side moves first
+     * @param MatchSeed - Seed of the board, the placement and the rolls
+     */
+    static FSaTMatchResult PlayMatch(const FSaTSelfPlaySettings& Settings, const FSaTEvalWeights& First, const FSaTEvalWeights& Second, int32 MatchSeed);
+
+    /**
+     * Plays NumPairs seeds twice, the sides swapped, in parallel
+     * @return Score of First averaged over the matches played: a win counts 1, a loss -1 and a match out of turns up to
+     *         half a point, by the share of a side's starting hit points First is ahead
+     */
+    static float PlayMatches(const FSaTSelfPlaySettings& Settings, const FSaTEvalWeights& First, const FSaTEvalWeights& Second, int32 FirstSeed, int32 NumPairs);
+
+    /** Tunes the weights by SPSA from Initial, then plays the result against Initial */
+    static FSaTTuningResult Tune(const FSaTSelfPlaySettings& Settings, const FSaTEvalWeights& Initial);
+};
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//SaT_Stats
+//Stat group and trace channel for the game logic.
+//In game: "stat SaT". In Unreal Insights: run with -trace=cpu,SaT (works headless with -nullrhi),
+//the scopes below then show up on the SaT channel next to the engine's CPU events.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_STATS_GROUP(TEXT("SaT"), STATGROUP_SaT, STATCAT_Advanced);
+
+// Scoped timings
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AI Decision"), STAT_SaT_AIDecision, STATGROUP_SaT, STRATEGICO_A_TURNI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pathfinding"), STAT_SaT_Pathfinding, STATGROUP_SaT, STRATEGICO_A_TURNI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Highlight Commit"), STAT_SaT_HighlightCommit, STATGROUP_SaT, STRATEGICO_A_TURNI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Game HUD"), STAT_SaT_UpdateGameHUD, STATGROUP_SaT, STRATEGICO_A_TURNI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Add Move To Log"), STAT_SaT_AddMoveToLog, STATGROUP_SaT, STRATEGICO_A_TURNI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Check Game Over"), STAT_SaT_CheckGameOver, STATGROUP_SaT, STRATEGICO_A_TURNI_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Board Generation"), STAT_SaT_BoardGeneration, STATGROUP_SaT, STRATEGICO_A_TURNI_API);
+
+// Per-frame counters
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Nodes Expanded"), STAT_SaT_NodesExpanded, STATGROUP_SaT, STRATEGICO_A_TURNI_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actors Scanned"), STAT_SaT_ActorsScanned, STATGROUP_SaT, STRATEGICO_A_TURNI_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Materials Set"), STAT_SaT_MaterialsSet, STATGROUP_SaT, STRATEGICO_A_TURNI_API);
+
+/** Trace channel of the game logic scopes */
+UE_TRACE_CHANNEL_EXTERN(SaTChannel, STRATEGICO_A_TURNI_API);
+
+/** Times a scope both in the stat group and on the SaT trace channel */
+#define SAT_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, SaTChannel)
@@ -0,0 +1,218 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//SaT_TurnPlanner
+//Plans the AI units of a turn together instead of one greedy unit at a time. A depth-first search tries every
+//order of the units and, for each unit, its best few (move, attack) actions on the board the earlier units left
+//behind, so a unit can clear the way or finish a target for the next one. Attacks are applied as expected outcomes,
+//plans are scored by a static evaluation and the search stops at a time budget with the best plan found so far.
+//Boards searched to the end are kept in a planner table with their best continuation, so a board reached again by
+//another unit order, by the next unit's search or in the next turn is not searched twice.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SaT_Enums.h"
+#include <atomic>
+
+struct FGridSearchGrid;
+
+/** A unit as the planner sees it; hit points and survival are expectations once attacks have been applied */
+struct FSaTPlannerUnit
+{
+    /** Unit type, for the combat odds */
+    EPieceUnit Type = EPieceUnit::NONE;
+
+    int32 GridX = 0;
+    int32 GridY = 0;
+    float Hp = 0.0f;
+    float AliveChance = 1.0f;
+
+    int32 Movement = 0;
+    int32 Range = 0;
+    int32 MinDamage = 0;
+    int32 MaxDamage = 0;
+
+    bool bIsPlayerUnit = false;
+
+    /** AI units that already acted this turn only block cells and count in the evaluation */
+    bool bHasActed = false;
+
+    /** Units the other side can count on: still likely alive */
+    bool IsLikelyAlive() const { return AliveChance >= 0.5f; }
+};
+
+/** One unit's part of a plan: move to (ToX, ToY), the current cell to stay, then attack the target cell if any */
+struct FSaTPlannedAction
+{
+    int32 UnitIndex = INDEX_NONE;
+    int32 ToX = 0;
+    int32 ToY = 0;
+    int32 TargetIndex = INDEX_NONE;
+    int32 TargetX = -1;
+    int32 TargetY = -1;
+};
+
+/** Best plan found, with what it cost to find */
+struct FSaTTurnPlan
+{
+    /** Actions in execution order, one per unit that was planned */
+    TArray<FSaTPlannedAction> Actions;
+
+    float Score = -MAX_flt;
+    int32 PlansEvaluated = 0;
+    int64 NodesSearched = 0;
+
+    /** Boards whose continuation came from the planner table */
+    int32 TableHits = 0;
+
+    double ElapsedMs = 0.0;
+
+    /** True if the budget ran out before every plan was tried */
+    bool bBudgetExhausted = false;
+};
+
+/** Weights of the terms of the evaluation; the defaults are hand-set, the tuned ones come from the difficulty settings */
+struct FSaTEvalWeights
+{
+    /** Expected hit points of either side */
+    float Hp = 1.0f;
+
+    /** A kill, on top of the hit points it removes */
+    float Kill = 20.0f;
+
+    /** Expected damage the player units can deal to an AI unit next turn */
+    float Exposure = 0.5f;
+
+    /** Cells an AI unit is short of attack range of the closest player unit */
+    float Approach = 0.2f;
+
+    /** Player units within range of an AI Sniper, the lines the Sniper holds */
+    float LineControl = 0.0f;
+};
+
+class FSaTPlannerTable;
+
+struct FSaTTurnPlannerSettings
+{
+    /** Wall time the search may take */
+    float BudgetMs = 50.0f;
+
+    /** Actions kept per unit and node after ranking them by the evaluation of their outcome */
+    int32 MaxActionsPerUnit = 10;
+
+    /** AI units planned together, at most FSaTTurnPlanner::MaxPlannedUnits */
+    int32 MaxPlannedUnits = 8;
+
+    /**
+     * Spread of the first action around the best one, in evaluation points: the root draws its action with the
+     * softmax of the plan scores at this temperature. 0 always keeps the best plan
+     */
+    float Temperature = 0.0f;
+
+    /** Seed of the draw at the root when Temperature is above 0 */
+    int32 RandomSeed = 0;
+
+    /** Weights of the evaluation plans are scored by */
+    FSaTEvalWeights Weights;
+
+    /** Optional flag another thread sets to stop the search early, as if the budget had run out */
+    const std::atomic<bool>* CancelFlag = nullptr;
+
+    /** Optional table of searched boards, kept by the caller across searches; one search at a time may use it */
+    FSaTPlannerTable* Table = nullptr;
+
+    /** Anything else the result depends on, e.g. the line-of-sight rule; the table is cleared when it changes */
+    uint32 RulesKey = 0;
+};
+
+/**
+ * Boards the planner searched to the end: the best score reachable from a board with some units still to act and the
+ * actions that reach it. Entries are keyed by a hash of every unit's state, so they stay valid as long as the board and
+ * the rules do; each AI turn starts a generation and entries unused for a whole turn are dropped
+ */
+class STRATEGICO_A_TURNI_API FSaTPlannerTable
+{
+public:
+
+    /** Entries kept at most; boards searched past it are not stored */
+    static constexpr int32 MaxEntries = 1 << 16;
+
+    struct FEntry
+    {
+        float Score = 0.0f;
+        TArray<FSaTPlannedAction> Continuation;
+        uint32 Generation = 0;
+    };
+
+    /** Returns the entry of a board and marks it used this generation, null if it is not stored */
+    const FEntry* Find(uint64 Key);
+
+    void Store(uint64 Key, float Score, const TArray<FSaTPlannedAction>& Continuation);
+
+    /** Clears the table if the entries were searched on another static board or under other rules */
+    void CheckContext(uint64 Context);
+
+    /** Starts the next AI turn: entries not used since the previous one are dropped */
+    void NewGeneration();
+
+    /** Adds the entries of another table as used this generation; entries of another context replace the current ones */
+    void Merge(const FSaTPlannerTable& Other);
+
+    void Reset();
+
+    int32 Num() const { return Entries.Num(); }
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+
+    TMap<uint64, FEntry> Entries;
+    uint32 Generation = 0;
+    uint64 Context = 0;
+};
+
+/** A board reduced to what a plan depends on: side, cell and whole hit points of every living unit, in unit order */
+struct FSaTPlannerBoardKey
+{
+    TArray<uint32> Units;
+
+    bool operator==(const FSaTPlannerBoardKey& Other) const { return Units == Other.Units; }
+
+    friend uint32 GetTypeHash(const FSaTPlannerBoardKey& Key)
+    {
+        uint32 Hash = 0;
+        for (uint32 Unit : Key.Units)
+        {
+            Hash = HashCombine(Hash, Unit);
+        }
+        return Hash;
+    }
+};
+
+class STRATEGICO_A_TURNI_API FSaTTurnPlanner
+{
+public:
+
+    /** Largest number of units planned together */
+    static constexpr int32 MaxPlannedUnits = 8;
+
+    /**
+     * Searches the plans of the AI units in Units
+     * @param StaticGrid - Search grid of the board without units; the planner adds the units itself
+     * @param CanAttack - Returns true if a unit with the range on the first cell can attack the second (range and line of sight)
+     */
+    static FSaTTurnPlan Plan(const FGridSearchGrid& StaticGrid, const TArray<FSaTPlannerUnit>& Units, const FSaTTurnPlannerSettings& Settings,
+        TFunctionRef<bool(int32 FromX, int32 FromY, int32 ToX, int32 ToY, int32 Range)> CanAttack);
+
+    /**
+     * Scores a board for the AI: hit points and kills of both sides, the AI's exposure next turn, its distance to the
+     * fight and the player units its Snipers hold in range
+     */
+    static float Evaluate(const TArray<FSaTPlannerUnit>& Units, const FSaTEvalWeights& Weights = FSaTEvalWeights());
+
+    /** Applies an action with the expected outcome of its attack and counterattack */
+    static void ApplyAction(TArray<FSaTPlannerUnit>& Units, const FSaTPlannedAction& Action);
+
+    /** Returns the key of a board with whole hit points; units that are surely dead are left out */
+    static FSaTPlannerBoardKey MakeBoardKey(const TArray<FSaTPlannerUnit>& Units);
+};
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//SaT_TurnPonderer
+//Thinks about the AI's next turn while the human plays. From the board the AI left, a worker thread predicts the
+//human's turn with the turn planner playing the human side, expands the predicted attacks into their concrete roll
+//outcomes and plans the AI's reply to the likeliest resulting boards, the board where the human only passes first.
+//When the AI's turn comes, the actual board is looked up by its key and a pondered plan is played as it is: the same
+//plan the planner would have found then, without the wait. The worker only reads copies taken at Start (search grid,
+//sight tables, units) and fills a table of its own, which the game thread merges into its table once the worker stopped.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridPathfinding.h"
+#include "GridLineOfSight.h"
+#include "SaT_TurnPlanner.h"
+#include "Async/Future.h"
+#include <atomic>
+
+class STRATEGICO_A_TURNI_API FSaTTurnPonderer
+{
+public:
+
+    /** Largest number of boards the AI's reply is pondered for during one human turn */
+    static constexpr int32 MaxPonderedBoards = 16;
+
+    ~FSaTTurnPonderer();
+
+    /**
+     * Drops the boards of the last human turn and starts pondering the next one
+     * @param InStaticGrid - Snapshot of the board, units not blocking
+     * @param InLineOfSight - Sight tables of the board, copied when bInRequireLineOfSight
+     * @param Units - Board at the end of the AI turn; surely dead units may be left in with AliveChance 0
+     * @param InSettings - Planner settings; their table, if any, seeds the ponderer's own table and is not touched by the worker
+     */
+    void Start(const FGridSearchGrid& InStaticGrid, const FGridLineOfSight& InLineOfSight, bool bInRequireLineOfSight,
+        const TArray<FSaTPlannerUnit>& Units, const FSaTTurnPlannerSettings& InSettings);
+
+    /** Stops the worker and waits for it; the boards pondered so far stay available */
+    void Stop();
+
+    /** Merges the boards the worker searched into the caller's table; only after Stop */
+    void MergeTableInto(FSaTPlannerTable& Target) const;
+
+    /** Returns the memory held by the ponderer's table; only after Stop */
+    SIZE_T GetTableAllocatedSize() const;
+
+    /**
+     * Looks up the pondered plan of a board; only after Stop
+     * @param Units - The actual board, living units only, in the order the pondered board had them
+     * @param OutPlan - Receives the plan with its unit indices into Units
+     */
+    bool Find(const TArray<FSaTPlannerUnit>& Units, FSaTTurnPlan& OutPlan) const;
+
+    bool IsRunning() const { return Task.IsValid(); }
+
+    /** Boards pondered since the last Start */
+    int32 GetNumPonderedBoards() const { return Plans.Num(); }
+
+private:
+
+    /** Plan of a pondered board and, for each living unit, its index in that board */
+    struct FPonderedPlan
+    {
+        FSaTTurnPlan Plan;
+        TArray<int32> LivingUnits;
+    };
+
+    /** Work of the worker thread */
+    void Run();
+
+    TFuture<void> Task;
+    std::atomic<bool> bCancel { false };
+
+    // Inputs of the worker, copied so the game can change its own while the human plays
+    FGridSearchGrid StaticGrid;
+    FGridLineOfSight LineOfSight;
+    bool bRequireLineOfSight = false;
+    TArray<FSaTPlannerUnit> RootUnits;
+    FSaTTurnPlannerSettings Settings;
+
+    // Boards searched by the worker, the only table it writes to
+    FSaTPlannerTable Table;
+
+    TMap<FSaTPlannerBoardKey, FPonderedPlan> Plans;
+};
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+//SaT_TurnTelemetry
+//Per-turn performance telemetry for soak tests. Counters are accumulated during a turn and written
+//as one CSV row when the game mode ends it (Saved/Profiling/SaT/TurnTelemetry-<time>.csv).
+//Enable with -SaTTurnTelemetry on the command line or "SaT.TurnTelemetry 1" in the console.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/** Work done during the current turn */
+struct FSaTTurnCounters
+{
+    /** Timed on the game thread only */
+    double AIDecisionMs = 0.0;
+    double HUDRefreshMs = 0.0;
+
+    /** Counts, atomic because searches on the pool threads (the ponderer) add to them too */
+    std::atomic<int32> PathfindingCalls = 0;
+    std::atomic<int64> NodesExpanded = 0;
+    std::atomic<int32> TilesRematerialized = 0;
+    std::atomic<int32> LogEntriesAdded = 0;
+    std::atomic<int32> HUDRefreshes = 0;
+
+    /** Frames seen since the turn started and their game-thread time */
+    int32 Frames = 0;
+    double GameThreadSumMs = 0.0;
+    double GameThreadMaxMs = 0.0;
+
+    /** Zeroes every counter for a new turn */
+    void Reset();
+};
+
+class STRATEGICO_A_TURNI_API FSaTTurnTelemetry
+{
+public:
+
+    /** Returns the game's telemetry recorder */
+    static FSaTTurnTelemetry& Get();
+
+    /** True when rows are written; counters are kept either way */
+    static bool IsEnabled();
+
+    /** Counters of the running turn, for the accumulation helpers below */
+    FSaTTurnCounters& GetCounters() { return Counters; }
+
+    /** Starts a new match; turn rows are numbered per match */
+    void BeginMatch();
+
+    /** Marks the start of a player's turn */
+    void BeginTurn();
+
+    /**
+     * Writes the row of the turn that just ended and clears the counters
+     * @param TurnNumber - Turn counter of the game instance
+     * @param bHumanTurn - Whose turn ended
+     * @param LogEntries - Size of the game log at the end of the turn
+     * @param bGameOver - The turn ended the match
+     */
+    void EndTurn(int32 TurnNumber, bool bHumanTurn, int32 LogEntries, bool bGameOver);
+
+private:
+
+    FSaTTurnTelemetry();
+    ~FSaTTurnTelemetry();
+
+    /** Samples the game-thread time of every frame */
+    void OnEndFrame();
+
+    /** Unbinds from the engine's frame and exit delegates; called on engine exit or when the module unloads */
+    void Shutdown();
+
+    FDelegateHandle EndFrameHandle;
+    FDelegateHandle PreExitHandle;
+
+    FSaTTurnCounters Counters;
+
+    /** Matches started in this session, and when the current turn started */
+    int32 MatchIndex = 0;
+    double TurnStartSeconds = 0.0;
+
+    /** CSV file of this session, created on the first row */
+    FString FilePath;
+};
+
+/** Adds the wall time of the enclosing scope to one of the millisecond counters; game thread only */
+struct FSaTTelemetryScope
+{
+    explicit FSaTTelemetryScope(double& InTargetMs);
+    ~FSaTTelemetryScope();
+
+private:
+    double& TargetMs;
+    uint64 StartCycles;
+};
+
+#define SAT_TELEMETRY_SCOPE(Field) \
+    FSaTTelemetryScope ANONYMOUS_VARIABLE(SaTTelemetryScope_)(FSaTTurnTelemetry::Get().GetCounters().Field)
+
+#define SAT_TELEMETRY_ADD(Field, Amount) \
+    FSaTTurnTelemetry::Get().GetCounters().Field += (Amount)
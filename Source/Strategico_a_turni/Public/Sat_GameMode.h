@@ -6,6 +6,7 @@
 #include "GameFramework/GameModeBase.h"
 #include "Unit.h"
 #include "SaT_Enums.h"
+#include "SaT_SearchStatsFeed.h"
 #include "SaT_GameMode.generated.h"
 
 class UMainGameHUDClass;
@@ -13,6 +14,30 @@ class ISaT_PlayerInterface;
 class AGridManager;
 class AUnit;
 
+// One action of the game as the AI replays it, recorded with every entry of the game log
+struct FSaTGameEvent
+{
+	enum class EType : uint8
+	{
+		Place,
+		Move,
+		Attack,
+		Counterattack
+	};
+
+	EType Type = EType::Move;
+	bool bIsPlayerUnit = false;
+
+	// Cell of the acting unit and, for a move its destination, for an attack the cell of the unit hit
+	int32 FromX = 0;
+	int32 FromY = 0;
+	int32 ToX = 0;
+	int32 ToY = 0;
+
+	// Hit points the unit hit lost
+	int32 Damage = 0;
+};
+
 UCLASS()
 class STRATEGICO_A_TURNI_API ASaT_GameMode : public AGameModeBase
 {
@@ -98,6 +123,9 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "Game Log")
 	TArray<FString> RawMoveHistory;
 
+	// Event log of the game, see GetGameEvents
+	TArray<FSaTGameEvent> GameEvents;
+
 	// ----------------
 	// UI Properties 
 	// ----------------
@@ -182,6 +210,17 @@ public:
 	// Shows or hides the AI thinking widget
 	void ShowAIThinkingWidget(bool bShow);
 
+	// Latest search statistics picked up from the AI, for the AI thinking widget
+	UPROPERTY(BlueprintReadOnly, Category = "UI")
+	FSaTAISearchStats AISearchStats;
+
+	// Picks up the newest snapshot of the AI search feed (if any) and returns the current statistics
+	UFUNCTION(BlueprintCallable, Category = "UI")
+	FSaTAISearchStats GetAISearchStats();
+
+	// Feed the AI publishes its search statistics to
+	FSaTSearchStatsFeed& GetAISearchFeed() { return AISearchFeed; }
+
 	// Result text from the coin flip
 	UPROPERTY(BlueprintReadOnly, Category = "UI")
 	FString CoinflipResult;
@@ -284,6 +323,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Game Log")
 	FString GetFormattedGameLog() const;
 
+	// Memory held by the game log and the HUD strings, for the memory budget report
+	SIZE_T GetLogAllocatedSize() const;
+
+	// Every action of the game so far, oldest first; unlike the game log it is never trimmed or deduplicated
+	const TArray<FSaTGameEvent>& GetGameEvents() const { return GameEvents; }
+
 	// Called when a unit dies to update game state
 	void NotifyUnitDeath(AUnit* DeadUnit);
 
@@ -301,6 +346,9 @@ public:
 
 protected:
 
+	// Lock-free snapshot feed from the AI search to the AI thinking widget
+	FSaTSearchStatsFeed AISearchFeed;
+
 	// Initializes all players at the start of the game 
 	void InitializePlayers();
 
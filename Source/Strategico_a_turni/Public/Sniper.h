@@ -22,6 +22,13 @@ public:
     //  Constructor - initializes Sniper-specific stats
     ASniper();
 
+    // Stats of every Sniper, also read at compile time by the combat odds tables
+    static constexpr int32 DefaultHp = 20;
+    static constexpr int32 DefaultMovement = 3;
+    static constexpr int32 DefaultRangeAttack = 10;
+    static constexpr int32 DefaultMinDamage = 4;
+    static constexpr int32 DefaultMaxDamage = 8;
+
 protected:
 
     /*
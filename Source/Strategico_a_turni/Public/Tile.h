@@ -54,6 +54,12 @@ public:
 	 */
 	FVector2D GetGridPosition();
 
+	/*
+	 * Returns the tile to its freshly spawned state so the grid can reuse it
+	 * Clears obstacle, occupancy and owner; the material is restored by the grid
+	 */
+	void ResetTile();
+
 	// Flag indicating if the tile is occupied by a unit
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Grid")
 	bool bIsOccupied;
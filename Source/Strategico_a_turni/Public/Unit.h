@@ -151,6 +151,17 @@ public:
      */
     static bool CheckMutualDestruction(AUnit* Attacker, AUnit* Target);
 
+    /*
+     * Static method to check if a target strikes back after surviving an attack
+     * Sniper attackers are countered by Snipers and by adjacent Brawlers,
+     * Brawler attackers only by adjacent non-Brawlers
+     */
+    static bool CanCounterattack(const AUnit* Attacker, const AUnit* Target, int32 Distance);
+
+    // Counterattack damage range, rolled when CanCounterattack allows it
+    static constexpr int32 MinCounterDamage = 1;
+    static constexpr int32 MaxCounterDamage = 3;
+
     /*
      * Checks if a target unit is within attack range
      * @param Target - Unit to check range to
@@ -27,7 +27,7 @@ public class Strategico_a_turni : ModuleRules
         PublicDependencyModuleNames.AddRange(new string[] {
         "Core", "CoreUObject", "Engine", "InputCore",
         "UMG", "Slate", "SlateCore",
-        "EnhancedInput"  
+        "EnhancedInput", "DeveloperSettings"
     });
 
         PrivateDependencyModuleNames.AddRange(new string[] { });